@@ -10,6 +10,19 @@ void mm_load_example();
 void mm_load_file_example();
 void bench_dijkstra_main();
 void bench_dijkstra_runner();
+void bench_bfs_runner();
+void bench_cc_runner();
+void bench_scc_runner();
+void bench_mst_runner();
+void bench_pagerank_runner();
+void bench_topological_sort_runner();
+void bench_betweenness_runner();
+void bench_k_core_runner();
+void bench_louvain_runner();
+void bench_random_walk_runner();
+void bench_coloring_runner();
+void bench_apsp_runner();
+void bench_matching_runner();
 
 int main() {
 #ifdef _MSC_VER
@@ -22,6 +35,19 @@ int main() {
   //mm_load_file_example();
   //bench_dijkstra_main();
   bench_dijkstra_runner();
+  //bench_bfs_runner();
+  //bench_cc_runner();
+  //bench_scc_runner();
+  //bench_mst_runner();
+  //bench_pagerank_runner();
+  //bench_topological_sort_runner();
+  //bench_betweenness_runner();
+  //bench_k_core_runner();
+  //bench_louvain_runner();
+  //bench_random_walk_runner();
+  //bench_coloring_runner();
+  //bench_apsp_runner();
+  //bench_matching_runner();
 
   return 0;
 }
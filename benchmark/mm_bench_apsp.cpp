@@ -0,0 +1,114 @@
+#include <cstddef>
+#include <cstdint>
+
+// Number of trials to run to get the minimum time
+constexpr const size_t apsp_test_trials = 3;
+
+// Number of vertices in the induced subgraph the all-pairs distances are found for
+constexpr const int64_t apsp_subgraph_vertices = 4096;
+
+#include <fmt/format.h>
+
+#include "mm_load.hpp"
+
+#include "graph/graph.hpp"
+#include "graph/algorithm/all_pairs_shortest_paths.hpp"
+#include "graph/algorithm/dijkstra_shortest_paths.hpp"
+#include <algorithm>
+#include <functional>
+
+using std::vector;
+using std::cout;
+using std::endl;
+
+using fmt::println;
+
+using namespace graph;
+
+//-------------------------------------------------------------------------------------------------
+// bench_apsp_runner
+//
+// Finds the all-pairs shortest distances of the subgraph induced by the first apsp_subgraph_vertices vertices of
+// the symmetric graphs, loaded into a compressed_graph with the edge values as weights. A dijkstra_shortest_distances
+// from each vertex is the baseline, followed by johnson_shortest_distances and floyd_warshall_shortest_distances for
+// 1, 2, 4, ... threads, up to the number of hardware threads. The distances of every run are compared with the
+// baseline.
+//
+void bench_apsp_runner() {
+  using vertex_id_type = int64_t;
+  using G              = compressed_graph<int64_t, void, void, vertex_id_type, vertex_id_type>;
+
+  timer session_timer("Total session");
+
+  for (bench_files bench_source : {gap_road, gap_kron, gap_urand}) {
+    triplet_matrix<vertex_id_type, int64_t> triplet;
+    array_matrix<vertex_id_type>            sources;
+
+    // Read the Matrix Market file
+    load_matrix_market(bench_source, triplet, sources, true);
+    cout << endl;
+
+    // Load the induced subgraph
+    const int64_t n = std::min(apsp_subgraph_vertices, static_cast<int64_t>(triplet.nrows));
+
+    vector<copyable_edge_t<vertex_id_type, int64_t>> subgraph_edges;
+    for (size_t i = 0; i < triplet.rows.size(); ++i) {
+      if (triplet.rows[i] < n && triplet.cols[i] < n) {
+        subgraph_edges.push_back({triplet.rows[i], triplet.cols[i], std::abs(triplet.vals[i])});
+      }
+    }
+    std::ranges::sort(subgraph_edges, {}, [](auto& e) { return std::pair{e.source_id, e.target_id}; });
+    G g;
+    g.load_edges(subgraph_edges, std::identity(), n);
+    fmt::println("Subgraph of {} vertices and {} edges", n, subgraph_edges.size());
+    cout << endl;
+
+    const size_t N      = num_vertices(g);
+    auto         weight = [&g](auto&& uv) { return edge_value(g, uv); };
+
+    vector<int64_t> distances(N * N), expected(N * N), d(N);
+    auto            min_elapsed = [&](const std::function<void()>& run) {
+      double elapsed = std::numeric_limits<double>::max(); // seconds
+      for (size_t t = 0; t < apsp_test_trials; ++t) {
+        simple_timer run_time;
+        run();
+        elapsed = std::min(elapsed, run_time.elapsed());
+      }
+      return elapsed;
+    };
+
+    try {
+      fmt::println("================================================================");
+      fmt::println("Benchmarking all-pairs shortest distances");
+      fmt::println("{} tests are run and the minimum is taken\n", apsp_test_trials);
+      fmt::println("{:<16}  {:>7}  {:>11}  {:>7}", "Algorithm", "Threads", "Elapsed (s)", "Speedup");
+
+      const double serial_elapsed = min_elapsed([&]() {
+        for (size_t uid = 0; uid < N; ++uid) {
+          init_shortest_paths(d);
+          dijkstra_shortest_distances(g, static_cast<vertex_id_type>(uid), d, weight);
+          std::ranges::copy(d, expected.begin() + static_cast<std::ptrdiff_t>(uid * N));
+        }
+      });
+      fmt::println("{:<16}  {:>7}  {:>11.3f}  {:>7.2f}", "dijkstra", 1, serial_elapsed, 1.0);
+
+      auto run = [&](std::string_view name, size_t num_threads, auto&& apsp) {
+        const double elapsed = min_elapsed([&]() { apsp(g, distances, weight, num_threads); });
+        fmt::println("{:<16}  {:>7}  {:>11.3f}  {:>7.2f}", name, num_threads, elapsed, serial_elapsed / elapsed);
+        if (distances != expected) {
+          fmt::println("Error: the distances differ from dijkstra");
+        }
+      };
+      for (size_t num_threads = 1;; num_threads = std::min(num_threads * 2, hardware_thread_count())) {
+        run("johnson", num_threads, [](auto&&... args) { return johnson_shortest_distances(args...); });
+        run("floyd_warshall", num_threads,
+            [](auto&&... args) { return floyd_warshall_shortest_distances(args...); });
+        if (num_threads == hardware_thread_count())
+          break;
+      }
+      cout << endl;
+    } catch (const std::exception& e) {
+      fmt::print("Exception caught: {}\n", e.what());
+    }
+  }
+}
@@ -0,0 +1,96 @@
+#include <cstddef>
+
+// Number of trials to run to get the minimum time
+constexpr const size_t betweenness_test_trials = 3;
+
+#include <fmt/format.h>
+
+#include "mm_load.hpp"
+
+#include "graph/graph.hpp"
+#include "graph/algorithm/betweenness_centrality.hpp"
+#include <algorithm>
+#include <functional>
+#include <cmath>
+
+using std::vector;
+using std::cout;
+using std::endl;
+
+using fmt::println;
+
+using namespace graph;
+
+//-------------------------------------------------------------------------------------------------
+// bench_betweenness_runner
+//
+// Runs approximate_betweenness_centrality with unit weights from 64 sampled sources, for 1, 2, 4, ... threads, up
+// to the number of hardware threads, on a compressed_graph. The same seed is used for every run, so the results only
+// differ by rounding.
+//
+void bench_betweenness_runner() {
+  using vertex_id_type = int64_t;
+  using G              = compressed_graph<int64_t, void, void, vertex_id_type, vertex_id_type>;
+
+  constexpr size_t num_samples = 64;
+
+  timer session_timer("Total session");
+
+  for (bench_files bench_source : {gap_road, gap_twitter, gap_web, gap_kron, gap_urand}) {
+    triplet_matrix<vertex_id_type, int64_t> triplet;
+    array_matrix<vertex_id_type>            sources;
+
+    // Read the Matrix Market file
+    load_matrix_market(bench_source, triplet, sources, false);
+    cout << endl;
+
+    // Load the graph
+    G           g;
+    graph_stats stats = load_graph(triplet, g);
+    fmt::println("Graph stats: {}", stats);
+    cout << endl;
+
+    vector<double> centrality(num_vertices(g));
+    vector<double> expected(num_vertices(g));
+
+    auto min_elapsed = [&](const std::function<void()>& run) {
+      double elapsed = std::numeric_limits<double>::max(); // seconds
+      for (size_t t = 0; t < betweenness_test_trials; ++t) {
+        simple_timer run_time;
+        run();
+        elapsed = std::min(elapsed, run_time.elapsed());
+      }
+      return elapsed;
+    };
+
+    try {
+      fmt::println("================================================================");
+      fmt::println("Benchmarking Betweenness Centrality ({} sampled sources)", num_samples);
+      fmt::println("{} tests are run and the minimum is taken\n", betweenness_test_trials);
+      fmt::println("{:<12}  {:>7}  {:>11}  {:>7}", "Algorithm", "Threads", "Elapsed (s)", "Speedup");
+
+      double base_elapsed = 0;
+      for (size_t num_threads = 1;; num_threads = std::min(num_threads * 2, hardware_thread_count())) {
+        const double elapsed = min_elapsed([&]() {
+          approximate_betweenness_centrality(g, centrality, num_samples, unit_edge_weight<double>(), 0, num_threads);
+        });
+        if (num_threads == 1) {
+          base_elapsed = elapsed;
+          expected     = centrality;
+        }
+        fmt::println("{:<12}  {:>7}  {:>11.3f}  {:>7.2f}", "betweenness", num_threads, elapsed, base_elapsed / elapsed);
+        for (size_t uid = 0; uid < centrality.size(); ++uid) {
+          if (std::abs(centrality[uid] - expected[uid]) > 1e-6 * std::max(1.0, expected[uid])) {
+            fmt::println("Error: the centrality of {} differs from 1 thread", uid);
+            break;
+          }
+        }
+        if (num_threads == hardware_thread_count())
+          break;
+      }
+      cout << endl;
+    } catch (const std::exception& e) {
+      fmt::print("Exception caught: {}\n", e.what());
+    }
+  }
+}
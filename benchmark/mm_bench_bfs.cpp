@@ -0,0 +1,97 @@
+#include <cstddef>
+
+// Number of trials to run to get the minimum time
+constexpr const size_t bfs_test_trials = 4;
+
+#include <fmt/format.h>
+
+#include "mm_load.hpp"
+
+#include "graph/graph.hpp"
+#include "graph/algorithm/breadth_first_search.hpp"
+#include <algorithm>
+
+using std::vector;
+using std::cout;
+using std::endl;
+
+using fmt::print;
+using fmt::println;
+
+using namespace graph;
+
+//-------------------------------------------------------------------------------------------------
+// bench_bfs_runner
+//
+// Compares the sequential breadth_first_search with parallel_breadth_first_search for 1, 2, 4, ...
+// threads, up to the number of hardware threads, on a compressed_graph. The time for each source
+// is the minimum of bfs_test_trials runs and the times are summed over all sources.
+//
+void bench_bfs_runner() {
+  using vertex_id_type = int64_t;
+  using G              = compressed_graph<int64_t, void, void, vertex_id_type, vertex_id_type>;
+  using Distances      = std::vector<int64_t>;
+  using Predecessors   = std::vector<vertex_id_type>;
+
+  timer session_timer("Total session");
+
+  bench_files bench_source = gap_road; // gap_road, gap_twitter, gap_web, gap_kron, gap_urand
+  triplet_matrix<vertex_id_type, int64_t> triplet;
+  array_matrix<vertex_id_type>            sources;
+
+  // Read the Matrix Market file
+  load_matrix_market(bench_source, triplet, sources, true);
+  cout << endl;
+
+  // Load the graph
+  G           g;
+  graph_stats stats = load_graph(triplet, g);
+  fmt::println("Graph stats: {}", stats);
+  cout << endl;
+
+  Distances    distances(size(vertices(g)));
+  Predecessors predecessors(size(vertices(g)));
+  Distances    expected(size(vertices(g)));
+
+  auto run_trials = [&](auto&& run) {
+    double total_elapsed = 0.0;
+    for (vertex_id_type source : sources.vals) {
+      double min_elapsed = std::numeric_limits<double>::max(); // seconds
+      for (size_t t = 0; t < bfs_test_trials; ++t) {
+        init_shortest_paths(distances, predecessors); // we want to highlight algorithm time, not setup
+        simple_timer run_time;
+        run(source);
+        min_elapsed = std::min(min_elapsed, run_time.elapsed());
+      }
+      total_elapsed += min_elapsed;
+    }
+    return total_elapsed;
+  };
+
+  try {
+    fmt::println("================================================================");
+    fmt::println("Benchmarking Breadth-First Search");
+    fmt::println("Running tests on {} sources individually", size(sources.vals));
+    fmt::println("{} tests are run for each source and the minimum is taken\n", bfs_test_trials);
+    fmt::println("{:<12}  {:>7}  {:>11}  {:>7}", "Algorithm", "Threads", "Elapsed (s)", "Speedup");
+
+    const double seq_elapsed =
+          run_trials([&](vertex_id_type source) { breadth_first_search(g, source, distances, predecessors); });
+    fmt::println("{:<12}  {:>7}  {:>11.3f}  {:>7.2f}", "sequential", 1, seq_elapsed, 1.0);
+    expected = distances;
+
+    for (size_t num_threads = 1;; num_threads = std::min(num_threads * 2, hardware_thread_count())) {
+      const double elapsed = run_trials([&](vertex_id_type source) {
+        parallel_breadth_first_search(g, source, distances, predecessors, num_threads);
+      });
+      fmt::println("{:<12}  {:>7}  {:>11.3f}  {:>7.2f}", "parallel", num_threads, elapsed, seq_elapsed / elapsed);
+      if (distances != expected)
+        fmt::println("Error: distances from the last source differ from the sequential breadth_first_search");
+      if (num_threads == hardware_thread_count())
+        break;
+    }
+    cout << endl;
+  } catch (const std::exception& e) {
+    fmt::print("Exception caught: {}\n", e.what());
+  }
+}
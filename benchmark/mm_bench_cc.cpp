@@ -0,0 +1,100 @@
+#include <cstddef>
+
+// Number of trials to run to get the minimum time
+constexpr const size_t cc_test_trials = 4;
+
+#include <fmt/format.h>
+
+#include "mm_load.hpp"
+
+#include "graph/graph.hpp"
+#include "graph/algorithm/connected_components.hpp"
+#include <algorithm>
+#include <functional>
+
+using std::vector;
+using std::cout;
+using std::endl;
+
+using fmt::println;
+
+using namespace graph;
+
+//-------------------------------------------------------------------------------------------------
+// bench_cc_runner
+//
+// Compares connected_components (sequential DFS), afforest and parallel_afforest for 1, 2, 4, ...
+// threads, up to the number of hardware threads, on a compressed_graph. The GAP road, kron and urand
+// graphs are symmetric, so the (undirected) components are found without a transpose.
+//
+void bench_cc_runner() {
+  using vertex_id_type = int64_t;
+  using G              = compressed_graph<int64_t, void, void, vertex_id_type, vertex_id_type>;
+  using Component      = std::vector<vertex_id_type>;
+
+  timer session_timer("Total session");
+
+  for (bench_files bench_source : {gap_road, gap_kron, gap_urand}) {
+    triplet_matrix<vertex_id_type, int64_t> triplet;
+    array_matrix<vertex_id_type>            sources;
+
+    // Read the Matrix Market file
+    load_matrix_market(bench_source, triplet, sources, true);
+    cout << endl;
+
+    // Load the graph
+    G           g;
+    graph_stats stats = load_graph(triplet, g);
+    fmt::println("Graph stats: {}", stats);
+    cout << endl;
+
+    Component component(size(vertices(g)));
+    Component expected(size(vertices(g)));
+
+    auto min_elapsed = [&](const std::function<void()>& run) {
+      double elapsed = std::numeric_limits<double>::max(); // seconds
+      for (size_t t = 0; t < cc_test_trials; ++t) {
+        simple_timer run_time;
+        run();
+        elapsed = std::min(elapsed, run_time.elapsed());
+      }
+      return elapsed;
+    };
+    auto num_components = [&component]() {
+      size_t count = 0;
+      for (size_t uid = 0; uid < component.size(); ++uid)
+        count += (component[uid] == static_cast<vertex_id_type>(uid)); // afforest roots are the smallest id
+      return count;
+    };
+
+    try {
+      fmt::println("================================================================");
+      fmt::println("Benchmarking Connected Components");
+      fmt::println("{} tests are run and the minimum is taken\n", cc_test_trials);
+      fmt::println("{:<22}  {:>7}  {:>12}  {:>11}  {:>7}", "Algorithm", "Threads", "Components", "Elapsed (s)",
+                   "Speedup");
+
+      const double seq_elapsed = min_elapsed([&]() { connected_components(g, expected); });
+      const size_t seq_count   = static_cast<size_t>(*std::ranges::max_element(expected)) + 1;
+      fmt::println("{:<22}  {:>7}  {:>12L}  {:>11.3f}  {:>7.2f}", "connected_components", 1, seq_count,
+                   seq_elapsed, 1.0);
+
+      const double aff_elapsed = min_elapsed([&]() { afforest(g, component); });
+      fmt::println("{:<22}  {:>7}  {:>12L}  {:>11.3f}  {:>7.2f}", "afforest", 1, num_components(), aff_elapsed,
+                   seq_elapsed / aff_elapsed);
+
+      for (size_t num_threads = 1;; num_threads = std::min(num_threads * 2, hardware_thread_count())) {
+        const double elapsed = min_elapsed([&]() { parallel_afforest(g, component, 2, num_threads); });
+        fmt::println("{:<22}  {:>7}  {:>12L}  {:>11.3f}  {:>7.2f}", "parallel_afforest", num_threads,
+                     num_components(), elapsed, seq_elapsed / elapsed);
+        if (num_components() != seq_count)
+          fmt::println("Error: the number of components differs from connected_components");
+        if (num_threads == hardware_thread_count())
+          break;
+      }
+      cout << endl;
+    } catch (const std::exception& e) {
+      fmt::print("Exception caught: {}\n", e.what());
+    }
+  }
+}
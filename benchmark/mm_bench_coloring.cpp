@@ -0,0 +1,72 @@
+#include <cstddef>
+
+#include <fmt/format.h>
+
+#include "mm_load.hpp"
+
+#include "graph/graph.hpp"
+#include "graph/algorithm/graph_coloring.hpp"
+#include <algorithm>
+
+using std::vector;
+using std::cout;
+using std::endl;
+
+using fmt::println;
+
+using namespace graph;
+
+//-------------------------------------------------------------------------------------------------
+// bench_coloring_runner
+//
+// Colors the symmetric graphs loaded into a compressed_graph with greedy_coloring in each order, then with
+// jones_plassmann_coloring and speculative_coloring for 1, 2, 4, ... threads, up to the number of hardware threads,
+// showing the colors, rounds, conflicts and time reported by each.
+//
+void bench_coloring_runner() {
+  using vertex_id_type = int64_t;
+  using G              = compressed_graph<int64_t, void, void, vertex_id_type, vertex_id_type>;
+
+  timer session_timer("Total session");
+
+  for (bench_files bench_source : {gap_road, gap_kron, gap_urand}) {
+    triplet_matrix<vertex_id_type, int64_t> triplet;
+    array_matrix<vertex_id_type>            sources;
+
+    // Read the Matrix Market file
+    load_matrix_market(bench_source, triplet, sources, true);
+    cout << endl;
+
+    // Load the graph
+    G           g;
+    graph_stats stats = load_graph(triplet, g);
+    fmt::println("Graph stats: {}", stats);
+    cout << endl;
+
+    vector<vertex_id_type> colors(num_vertices(g));
+    auto                   print = [](std::string_view name, size_t num_threads, const coloring_stats& s) {
+      fmt::println("{:<16}  {:>7}  {:>6}  {:>6}  {:>9}  {:>11.3f}", name, num_threads, s.num_colors, s.rounds,
+                   s.conflicts, s.seconds);
+    };
+
+    try {
+      fmt::println("================================================================");
+      fmt::println("Benchmarking graph coloring\n");
+      fmt::println("{:<16}  {:>7}  {:>6}  {:>6}  {:>9}  {:>11}", "Algorithm", "Threads", "Colors", "Rounds",
+                   "Conflicts", "Elapsed (s)");
+
+      print("natural", 1, greedy_coloring(g, colors, coloring_order::natural));
+      print("largest_first", 1, greedy_coloring(g, colors, coloring_order::largest_first));
+      print("smallest_last", 1, greedy_coloring(g, colors, coloring_order::smallest_last));
+      for (size_t num_threads = 1;; num_threads = std::min(num_threads * 2, hardware_thread_count())) {
+        print("jones_plassmann", num_threads, jones_plassmann_coloring(g, colors, 0, num_threads));
+        print("speculative", num_threads, speculative_coloring(g, colors, num_threads));
+        if (num_threads == hardware_thread_count())
+          break;
+      }
+      cout << endl;
+    } catch (const std::exception& e) {
+      fmt::print("Exception caught: {}\n", e.what());
+    }
+  }
+}
@@ -0,0 +1,88 @@
+#include <cstddef>
+
+// Number of trials to run to get the minimum time
+constexpr const size_t k_core_test_trials = 3;
+
+#include <fmt/format.h>
+
+#include "mm_load.hpp"
+
+#include "graph/graph.hpp"
+#include "graph/algorithm/k_core.hpp"
+#include <algorithm>
+#include <functional>
+
+using std::vector;
+using std::cout;
+using std::endl;
+
+using fmt::println;
+
+using namespace graph;
+
+//-------------------------------------------------------------------------------------------------
+// bench_k_core_runner
+//
+// Runs the serial Batagelj-Zaversnik k_core and parallel_k_core for 1, 2, 4, ... threads, up to the number of
+// hardware threads, on the symmetric graphs loaded into a compressed_graph. The core numbers of every run are
+// compared with those of k_core.
+//
+void bench_k_core_runner() {
+  using vertex_id_type = int64_t;
+  using G              = compressed_graph<int64_t, void, void, vertex_id_type, vertex_id_type>;
+
+  timer session_timer("Total session");
+
+  for (bench_files bench_source : {gap_road, gap_kron, gap_urand}) {
+    triplet_matrix<vertex_id_type, int64_t> triplet;
+    array_matrix<vertex_id_type>            sources;
+
+    // Read the Matrix Market file
+    load_matrix_market(bench_source, triplet, sources, true);
+    cout << endl;
+
+    // Load the graph
+    G           g;
+    graph_stats stats = load_graph(triplet, g);
+    fmt::println("Graph stats: {}", stats);
+    cout << endl;
+
+    vector<vertex_id_type> coreness(num_vertices(g));
+    vector<vertex_id_type> expected(num_vertices(g));
+
+    auto min_elapsed = [&](const std::function<void()>& run) {
+      double elapsed = std::numeric_limits<double>::max(); // seconds
+      for (size_t t = 0; t < k_core_test_trials; ++t) {
+        simple_timer run_time;
+        run();
+        elapsed = std::min(elapsed, run_time.elapsed());
+      }
+      return elapsed;
+    };
+
+    try {
+      fmt::println("================================================================");
+      fmt::println("Benchmarking k-core decomposition");
+      fmt::println("{} tests are run and the minimum is taken\n", k_core_test_trials);
+      fmt::println("{:<16}  {:>7}  {:>11}  {:>7}  {:>8}", "Algorithm", "Threads", "Elapsed (s)", "Speedup", "Max core");
+
+      size_t       max_core       = 0;
+      const double serial_elapsed = min_elapsed([&]() { max_core = k_core(g, expected); });
+      fmt::println("{:<16}  {:>7}  {:>11.3f}  {:>7.2f}  {:>8}", "k_core", 1, serial_elapsed, 1.0, max_core);
+
+      for (size_t num_threads = 1;; num_threads = std::min(num_threads * 2, hardware_thread_count())) {
+        const double elapsed = min_elapsed([&]() { max_core = parallel_k_core(g, coreness, num_threads); });
+        fmt::println("{:<16}  {:>7}  {:>11.3f}  {:>7.2f}  {:>8}", "parallel_k_core", num_threads, elapsed,
+                     serial_elapsed / elapsed, max_core);
+        if (coreness != expected) {
+          fmt::println("Error: the core numbers differ from k_core");
+        }
+        if (num_threads == hardware_thread_count())
+          break;
+      }
+      cout << endl;
+    } catch (const std::exception& e) {
+      fmt::print("Exception caught: {}\n", e.what());
+    }
+  }
+}
@@ -0,0 +1,78 @@
+#include <cstddef>
+
+#include <fmt/format.h>
+
+#include "mm_load.hpp"
+
+#include "graph/graph.hpp"
+#include "graph/algorithm/louvain.hpp"
+#include <algorithm>
+
+using std::vector;
+using std::cout;
+using std::endl;
+
+using fmt::println;
+
+using namespace graph;
+
+//-------------------------------------------------------------------------------------------------
+// bench_louvain_runner
+//
+// Runs louvain with unit weights for 1, 2, 4, ... threads, up to the number of hardware threads, on the symmetric
+// graphs loaded into a compressed_graph, showing the size, modularity and times of each level.
+//
+void bench_louvain_runner() {
+  using vertex_id_type = int64_t;
+  using G              = compressed_graph<int64_t, void, void, vertex_id_type, vertex_id_type>;
+
+  timer session_timer("Total session");
+
+  for (bench_files bench_source : {gap_road, gap_kron, gap_urand}) {
+    triplet_matrix<vertex_id_type, int64_t> triplet;
+    array_matrix<vertex_id_type>            sources;
+
+    // Read the Matrix Market file
+    load_matrix_market(bench_source, triplet, sources, true);
+    cout << endl;
+
+    // Load the graph
+    G           g;
+    graph_stats stats = load_graph(triplet, g);
+    fmt::println("Graph stats: {}", stats);
+    cout << endl;
+
+    vector<vertex_id_type> community(num_vertices(g));
+    vector<louvain_level>  levels;
+
+    try {
+      fmt::println("================================================================");
+      fmt::println("Benchmarking Louvain community detection\n");
+
+      double base_elapsed = 0;
+      for (size_t num_threads = 1;; num_threads = std::min(num_threads * 2, hardware_thread_count())) {
+        simple_timer run_time;
+        const double modularity = louvain(g, community, levels, unit_edge_weight<double>(), 1.0, 1e-6, num_threads);
+        const double elapsed    = run_time.elapsed();
+        if (num_threads == 1)
+          base_elapsed = elapsed;
+
+        fmt::println("{} threads: modularity {:.6f}, {:.3f}s, speedup {:.2f}", num_threads, modularity, elapsed,
+                     base_elapsed / elapsed);
+        fmt::println("{:>5}  {:>12}  {:>13}  {:>11}  {:>6}  {:>10}  {:>8}  {:>11}", "Level", "Vertices", "Edges",
+                     "Communities", "Passes", "Modularity", "Move (s)", "Coarsen (s)");
+        for (size_t i = 0; i < levels.size(); ++i) {
+          const louvain_level& level = levels[i];
+          fmt::println("{:>5}  {:>12}  {:>13}  {:>11}  {:>6}  {:>10.6f}  {:>8.3f}  {:>11.3f}", i, level.num_vertices,
+                       level.num_edges, level.num_communities, level.iterations, level.modularity, level.move_seconds,
+                       level.coarsen_seconds);
+        }
+        cout << endl;
+        if (num_threads == hardware_thread_count())
+          break;
+      }
+    } catch (const std::exception& e) {
+      fmt::print("Exception caught: {}\n", e.what());
+    }
+  }
+}
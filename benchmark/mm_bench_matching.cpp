@@ -0,0 +1,94 @@
+#include <cstddef>
+
+// Number of trials to run to get the minimum time
+constexpr const size_t matching_test_trials = 3;
+
+#include <fmt/format.h>
+
+#include "mm_load.hpp"
+
+#include "graph/graph.hpp"
+#include "graph/algorithm/bipartite_matching.hpp"
+#include <algorithm>
+#include <functional>
+
+using std::vector;
+using std::cout;
+using std::endl;
+
+using fmt::println;
+
+using namespace graph;
+
+//-------------------------------------------------------------------------------------------------
+// bench_matching_runner
+//
+// Finds a maximum matching of the bipartite double cover of the symmetric graphs, where left vertex u has an edge to
+// right vertex V + v for each edge (u,v), loaded into a compressed_graph with the left vertices in partition 0.
+// hopcroft_karp_matching is the baseline, followed by push_relabel_matching for 1, 2, 4, ... threads, up to the
+// number of hardware threads. The matching size of every run is compared with the baseline.
+//
+void bench_matching_runner() {
+  using vertex_id_type = int64_t;
+  using G              = compressed_graph<void, void, void, vertex_id_type, vertex_id_type>;
+
+  timer session_timer("Total session");
+
+  for (bench_files bench_source : {gap_road, gap_kron, gap_urand}) {
+    triplet_matrix<vertex_id_type, int64_t> triplet;
+    array_matrix<vertex_id_type>            sources;
+
+    // Read the Matrix Market file
+    load_matrix_market(bench_source, triplet, sources, true);
+    cout << endl;
+
+    // Load the bipartite double cover
+    const vertex_id_type n = static_cast<vertex_id_type>(triplet.nrows);
+
+    vector<copyable_edge_t<vertex_id_type, void>> cover_edges(triplet.rows.size());
+    for (size_t i = 0; i < triplet.rows.size(); ++i) {
+      cover_edges[i] = {triplet.rows[i], n + triplet.cols[i]};
+    }
+    std::ranges::sort(cover_edges, {}, [](auto& e) { return std::pair{e.source_id, e.target_id}; });
+    G g(cover_edges, std::identity(), vector<vertex_id_type>{0, n});
+    fmt::println("Bipartite double cover of {} + {} vertices and {} edges", n, num_vertices(g) - n,
+                 cover_edges.size());
+    cout << endl;
+
+    vector<vertex_id_type> mate(num_vertices(g));
+    auto                   min_elapsed = [&](const std::function<void()>& run) {
+      double elapsed = std::numeric_limits<double>::max(); // seconds
+      for (size_t t = 0; t < matching_test_trials; ++t) {
+        simple_timer run_time;
+        run();
+        elapsed = std::min(elapsed, run_time.elapsed());
+      }
+      return elapsed;
+    };
+
+    try {
+      fmt::println("================================================================");
+      fmt::println("Benchmarking bipartite matching");
+      fmt::println("{} tests are run and the minimum is taken\n", matching_test_trials);
+      fmt::println("{:<16}  {:>7}  {:>11}  {:>7}  {:>10}", "Algorithm", "Threads", "Elapsed (s)", "Speedup", "Matched");
+
+      size_t       expected       = 0, matched = 0;
+      const double serial_elapsed = min_elapsed([&]() { expected = hopcroft_karp_matching(g, mate); });
+      fmt::println("{:<16}  {:>7}  {:>11.3f}  {:>7.2f}  {:>10}", "hopcroft_karp", 1, serial_elapsed, 1.0, expected);
+
+      for (size_t num_threads = 1;; num_threads = std::min(num_threads * 2, hardware_thread_count())) {
+        const double elapsed = min_elapsed([&]() { matched = push_relabel_matching(g, mate, 0, num_threads); });
+        fmt::println("{:<16}  {:>7}  {:>11.3f}  {:>7.2f}  {:>10}", "push_relabel", num_threads, elapsed,
+                     serial_elapsed / elapsed, matched);
+        if (matched != expected) {
+          fmt::println("Error: the matching size differs from hopcroft_karp");
+        }
+        if (num_threads == hardware_thread_count())
+          break;
+      }
+      cout << endl;
+    } catch (const std::exception& e) {
+      fmt::print("Exception caught: {}\n", e.what());
+    }
+  }
+}
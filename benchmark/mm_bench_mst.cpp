@@ -0,0 +1,138 @@
+#include <cstddef>
+
+// Number of trials to run to get the minimum time
+constexpr const size_t mst_test_trials = 3;
+
+#include <fmt/format.h>
+
+#include "mm_load.hpp"
+
+#include "graph/graph.hpp"
+#include "graph/algorithm/mst.hpp"
+#include <algorithm>
+#include <functional>
+
+using std::vector;
+using std::cout;
+using std::endl;
+
+using fmt::println;
+
+using namespace graph;
+
+//-------------------------------------------------------------------------------------------------
+// bench_mst_runner
+//
+// Compares kruskal, prim, filter_kruskal and parallel_boruvka for 1, 2, 4, ... threads, up to the number
+// of hardware threads, on a compressed_graph. The GAP road graph is symmetric and weighted. kruskal is given the
+// edges of the graph in a separate edgelist, which isn't included in its time.
+//
+void bench_mst_runner() {
+  using vertex_id_type = int64_t;
+  using weight_type    = int64_t;
+  using G              = compressed_graph<weight_type, void, void, vertex_id_type, vertex_id_type>;
+  using tree_edge      = edge_info<vertex_id_type, true, void, weight_type>;
+
+  timer session_timer("Total session");
+
+  for (bench_files bench_source : {gap_road}) {
+    triplet_matrix<vertex_id_type, weight_type> triplet;
+    array_matrix<vertex_id_type>                sources;
+
+    // Read the Matrix Market file
+    load_matrix_market(bench_source, triplet, sources, true);
+    cout << endl;
+
+    // Load the graph
+    G           g;
+    graph_stats stats = load_graph(triplet, g);
+    fmt::println("Graph stats: {}", stats);
+    cout << endl;
+
+    vector<tree_edge> e;
+    e.reserve(num_edges(g));
+    for (auto&& [uid, vid, uv] : views::edgelist(g))
+      e.push_back({uid, vid, edge_value(g, uv)});
+
+    auto min_elapsed = [&](const std::function<weight_type()>& run, weight_type& total) {
+      double elapsed = std::numeric_limits<double>::max(); // seconds
+      for (size_t t = 0; t < mst_test_trials; ++t) {
+        simple_timer run_time;
+        total   = run();
+        elapsed = std::min(elapsed, run_time.elapsed());
+      }
+      return elapsed;
+    };
+    auto less        = [](auto&& i, auto&& j) { return i < j; };
+    auto tree_weight = [](const vector<tree_edge>& t) {
+      weight_type total = 0;
+      for (auto&& [uid, vid, w] : t)
+        total += w;
+      return total;
+    };
+
+    try {
+      fmt::println("================================================================");
+      fmt::println("Benchmarking Minimum Spanning Tree");
+      fmt::println("{} tests are run and the minimum is taken\n", mst_test_trials);
+      fmt::println("{:<18}  {:>7}  {:>16}  {:>11}  {:>7}", "Algorithm", "Threads", "Weight", "Elapsed (s)",
+                   "Speedup");
+
+      weight_type  expected     = 0;
+      const double base_elapsed = min_elapsed(
+            [&]() {
+              vector<tree_edge> t;
+              kruskal(e, t);
+              return tree_weight(t);
+            },
+            expected);
+      fmt::println("{:<18}  {:>7}  {:>16L}  {:>11.3f}  {:>7.2f}", "kruskal", 1, expected, base_elapsed, 1.0);
+
+      weight_type  total        = 0;
+      const double prim_elapsed = min_elapsed(
+            [&]() {
+              vector<vertex_id_type> predecessors(num_vertices(g));
+              vector<weight_type>    weights(num_vertices(g), 0);
+              prim(g, predecessors, weights);
+              weight_type sum = 0;
+              for (vertex_id_type uid = 1; uid < static_cast<vertex_id_type>(weights.size()); ++uid)
+                sum += weights[static_cast<size_t>(uid)];
+              return sum;
+            },
+            total);
+      fmt::println("{:<18}  {:>7}  {:>16L}  {:>11.3f}  {:>7.2f}", "prim", 1, total, prim_elapsed,
+                   base_elapsed / prim_elapsed);
+
+      for (size_t num_threads = 1;; num_threads = std::min(num_threads * 2, hardware_thread_count())) {
+        const double filter_elapsed = min_elapsed(
+              [&]() {
+                vector<tree_edge> t;
+                filter_kruskal(e, t, less, num_threads);
+                return tree_weight(t);
+              },
+              total);
+        fmt::println("{:<18}  {:>7}  {:>16L}  {:>11.3f}  {:>7.2f}", "filter_kruskal", num_threads, total,
+                     filter_elapsed, base_elapsed / filter_elapsed);
+        if (total != expected)
+          fmt::println("Error: the tree weight differs from kruskal");
+
+        const double elapsed = min_elapsed(
+              [&]() {
+                vector<tree_edge> t;
+                parallel_boruvka(g, t, num_threads);
+                return tree_weight(t);
+              },
+              total);
+        fmt::println("{:<18}  {:>7}  {:>16L}  {:>11.3f}  {:>7.2f}", "parallel_boruvka", num_threads, total, elapsed,
+                     base_elapsed / elapsed);
+        if (total != expected)
+          fmt::println("Error: the tree weight differs from kruskal");
+        if (num_threads == hardware_thread_count())
+          break;
+      }
+      cout << endl;
+    } catch (const std::exception& e) {
+      fmt::print("Exception caught: {}\n", e.what());
+    }
+  }
+}
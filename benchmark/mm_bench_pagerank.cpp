@@ -0,0 +1,104 @@
+#include <cstddef>
+
+// Number of trials to run to get the minimum time
+constexpr const size_t pagerank_test_trials = 3;
+
+#include <fmt/format.h>
+
+#include "mm_load.hpp"
+
+#include "graph/graph.hpp"
+#include "graph/algorithm/pagerank.hpp"
+#include <algorithm>
+#include <functional>
+#include <cmath>
+
+using std::vector;
+using std::cout;
+using std::endl;
+
+using fmt::println;
+
+using namespace graph;
+
+//-------------------------------------------------------------------------------------------------
+// bench_pagerank_runner
+//
+// Runs pagerank for 1, 2, 4, ... threads, up to the number of hardware threads, on the GAP graphs,
+// with the GAP benchmark's damping factor (0.85), L1 tolerance (1e-4) and at most 20 iterations. The
+// graph and its transpose are held in vector<vector<>> so they can be built without sorting the edges.
+//
+void bench_pagerank_runner() {
+  using vertex_id_type = int64_t;
+  using G              = vector<vector<vertex_id_type>>;
+
+  timer session_timer("Total session");
+
+  for (bench_files bench_source : {gap_road, gap_twitter, gap_web, gap_kron, gap_urand}) {
+    triplet_matrix<vertex_id_type, int64_t> triplet;
+    array_matrix<vertex_id_type>            sources;
+
+    // Read the Matrix Market file
+    load_matrix_market(bench_source, triplet, sources, false);
+    cout << endl;
+
+    // Load the graph and its transpose
+    G g(static_cast<size_t>(triplet.nrows)), g_t(static_cast<size_t>(triplet.nrows));
+    {
+      timer load_time("Loading the graph and transpose", true);
+      for (size_t i = 0; i < triplet.rows.size(); ++i) {
+        g[static_cast<size_t>(triplet.rows[i])].push_back(triplet.cols[i]);
+        g_t[static_cast<size_t>(triplet.cols[i])].push_back(triplet.rows[i]);
+      }
+      load_time.set_count(ssize(triplet.rows), "edges");
+    }
+    triplet = {};
+    fmt::println("Graph stats: {}", graph_stats(g));
+    cout << endl;
+
+    vector<double> scores(size(vertices(g)));
+    vector<double> expected(size(vertices(g)));
+
+    auto min_elapsed = [&](const std::function<size_t()>& run, size_t& iterations) {
+      double elapsed = std::numeric_limits<double>::max(); // seconds
+      for (size_t t = 0; t < pagerank_test_trials; ++t) {
+        simple_timer run_time;
+        iterations = run();
+        elapsed    = std::min(elapsed, run_time.elapsed());
+      }
+      return elapsed;
+    };
+
+    try {
+      fmt::println("================================================================");
+      fmt::println("Benchmarking PageRank");
+      fmt::println("{} tests are run and the minimum is taken\n", pagerank_test_trials);
+      fmt::println("{:<10}  {:>7}  {:>10}  {:>11}  {:>7}", "Algorithm", "Threads", "Iterations", "Elapsed (s)",
+                   "Speedup");
+
+      double base_elapsed = 0;
+      for (size_t num_threads = 1;; num_threads = std::min(num_threads * 2, hardware_thread_count())) {
+        size_t       iterations = 0;
+        const double elapsed    = min_elapsed(
+              [&]() { return pagerank(g, g_t, scores, 0.85, 1e-4, 20, pagerank_unit_weight(), num_threads); },
+              iterations);
+        if (num_threads == 1) {
+          base_elapsed = elapsed;
+          expected     = scores;
+        }
+        fmt::println("{:<10}  {:>7}  {:>10}  {:>11.3f}  {:>7.2f}", "pagerank", num_threads, iterations, elapsed,
+                     base_elapsed / elapsed);
+        double difference = 0;
+        for (size_t uid = 0; uid < scores.size(); ++uid)
+          difference += std::abs(scores[uid] - expected[uid]);
+        if (difference > 1e-9)
+          fmt::println("Error: the scores differ from 1 thread by {}", difference);
+        if (num_threads == hardware_thread_count())
+          break;
+      }
+      cout << endl;
+    } catch (const std::exception& e) {
+      fmt::print("Exception caught: {}\n", e.what());
+    }
+  }
+}
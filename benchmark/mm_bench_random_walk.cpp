@@ -0,0 +1,106 @@
+#include <cstddef>
+
+// Number of trials to run to get the minimum time
+constexpr const size_t random_walk_test_trials = 3;
+
+#include <fmt/format.h>
+
+#include "mm_load.hpp"
+
+#include "graph/graph.hpp"
+#include "graph/algorithm/random_walk.hpp"
+#include <algorithm>
+#include <functional>
+
+using std::vector;
+using std::cout;
+using std::endl;
+
+using fmt::println;
+
+using namespace graph;
+
+//-------------------------------------------------------------------------------------------------
+// bench_random_walk_runner
+//
+// Builds the alias tables of the symmetric graphs loaded into a compressed_graph, then runs DeepWalk walks and
+// node2vec walks (p = 0.5, q = 2) of 80 vertices from up to 1M start vertices, for 1, 2, 4, ... threads, up to
+// the number of hardware threads. The steps per second are shown for each run.
+//
+void bench_random_walk_runner() {
+  using vertex_id_type = int64_t;
+  using G              = compressed_graph<int64_t, void, void, vertex_id_type, vertex_id_type>;
+
+  constexpr size_t walk_length = 80;
+  constexpr size_t max_walks   = 1'000'000;
+
+  timer session_timer("Total session");
+
+  for (bench_files bench_source : {gap_road, gap_kron, gap_urand}) {
+    triplet_matrix<vertex_id_type, int64_t> triplet;
+    array_matrix<vertex_id_type>            sources;
+
+    // Read the Matrix Market file
+    load_matrix_market(bench_source, triplet, sources, true);
+    cout << endl;
+
+    // Load the graph
+    G           g;
+    graph_stats stats = load_graph(triplet, g);
+    fmt::println("Graph stats: {}", stats);
+    cout << endl;
+
+    const size_t           num_walks = std::min(max_walks, static_cast<size_t>(num_vertices(g)));
+    vector<vertex_id_type> starts(num_walks);
+    for (size_t i = 0; i < num_walks; ++i)
+      starts[i] = static_cast<vertex_id_type>(i * (num_vertices(g) / num_walks));
+    vector<vertex_id_type> walks(num_walks * walk_length);
+
+    auto min_elapsed = [&](const std::function<void()>& run) {
+      double elapsed = std::numeric_limits<double>::max(); // seconds
+      for (size_t t = 0; t < random_walk_test_trials; ++t) {
+        simple_timer run_time;
+        run();
+        elapsed = std::min(elapsed, run_time.elapsed());
+      }
+      return elapsed;
+    };
+
+    try {
+      fmt::println("================================================================");
+      fmt::println("Benchmarking random walks ({} walks of length {})", num_walks, walk_length);
+      fmt::println("{} tests are run and the minimum is taken\n", random_walk_test_trials);
+      fmt::println("{:<12}  {:>7}  {:>11}  {:>7}  {:>14}", "Algorithm", "Threads", "Elapsed (s)", "Speedup", "Steps/s");
+
+      double table_base = 0, deepwalk_base = 0, node2vec_base = 0;
+      for (size_t num_threads = 1;; num_threads = std::min(num_threads * 2, hardware_thread_count())) {
+        alias_table  table;
+        size_t       steps = 0;
+        const double table_elapsed =
+              min_elapsed([&]() { table = alias_table(g, unit_edge_weight<double>(), num_threads); });
+        const double deepwalk_elapsed =
+              min_elapsed([&]() { steps = random_walks(g, table, starts, walk_length, walks, 0, num_threads); });
+        const double deepwalk_rate    = static_cast<double>(steps) / deepwalk_elapsed;
+        const double node2vec_elapsed = min_elapsed(
+              [&]() { steps = node2vec_walks(g, table, starts, walk_length, walks, 0.5, 2.0, 0, num_threads); });
+        const double node2vec_rate = static_cast<double>(steps) / node2vec_elapsed;
+        if (num_threads == 1) {
+          table_base    = table_elapsed;
+          deepwalk_base = deepwalk_elapsed;
+          node2vec_base = node2vec_elapsed;
+        }
+        fmt::println("{:<12}  {:>7}  {:>11.3f}  {:>7.2f}", "alias_table", num_threads, table_elapsed,
+                     table_base / table_elapsed);
+        fmt::println("{:<12}  {:>7}  {:>11.3f}  {:>7.2f}  {:>14.0f}", "deepwalk", num_threads, deepwalk_elapsed,
+                     deepwalk_base / deepwalk_elapsed, deepwalk_rate);
+        fmt::println("{:<12}  {:>7}  {:>11.3f}  {:>7.2f}  {:>14.0f}", "node2vec", num_threads, node2vec_elapsed,
+                     node2vec_base / node2vec_elapsed, node2vec_rate);
+        if (num_threads == hardware_thread_count())
+          break;
+      }
+      cout << endl;
+    } catch (const std::exception& e) {
+      fmt::print("Exception caught: {}\n", e.what());
+    }
+  }
+}
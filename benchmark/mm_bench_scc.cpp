@@ -0,0 +1,107 @@
+#include <cstddef>
+
+// Number of trials to run to get the minimum time
+constexpr const size_t scc_test_trials = 3;
+
+#include <fmt/format.h>
+
+#include "mm_load.hpp"
+
+#include "graph/graph.hpp"
+#include "graph/algorithm/connected_components.hpp"
+#include <algorithm>
+#include <functional>
+
+using std::vector;
+using std::cout;
+using std::endl;
+
+using fmt::println;
+
+using namespace graph;
+
+//-------------------------------------------------------------------------------------------------
+// bench_scc_runner
+//
+// Compares kosaraju, tarjan_scc and forward_backward_scc for 1, 2, 4, ... threads, up to the number
+// of hardware threads, on the directed GAP graphs. The graph and its transpose are held in
+// vector<vector<>> so they can be built without sorting the edges.
+//
+void bench_scc_runner() {
+  using vertex_id_type = int64_t;
+  using G              = vector<vector<vertex_id_type>>;
+  using Component      = vector<vertex_id_type>;
+
+  timer session_timer("Total session");
+
+  for (bench_files bench_source : {gap_twitter, gap_web}) {
+    triplet_matrix<vertex_id_type, int64_t> triplet;
+    array_matrix<vertex_id_type>            sources;
+
+    // Read the Matrix Market file
+    load_matrix_market(bench_source, triplet, sources, false);
+    cout << endl;
+
+    // Load the graph and its transpose
+    G g(static_cast<size_t>(triplet.nrows)), g_t(static_cast<size_t>(triplet.nrows));
+    {
+      timer load_time("Loading the graph and transpose", true);
+      for (size_t i = 0; i < triplet.rows.size(); ++i) {
+        g[static_cast<size_t>(triplet.rows[i])].push_back(triplet.cols[i]);
+        g_t[static_cast<size_t>(triplet.cols[i])].push_back(triplet.rows[i]);
+      }
+      load_time.set_count(ssize(triplet.rows), "edges");
+    }
+    triplet = {};
+    fmt::println("Graph stats: {}", graph_stats(g));
+    cout << endl;
+
+    Component component(size(vertices(g)));
+
+    auto min_elapsed = [&](const std::function<size_t()>& run, size_t& num_components) {
+      double elapsed = std::numeric_limits<double>::max(); // seconds
+      for (size_t t = 0; t < scc_test_trials; ++t) {
+        simple_timer run_time;
+        num_components = run();
+        elapsed        = std::min(elapsed, run_time.elapsed());
+      }
+      return elapsed;
+    };
+
+    try {
+      fmt::println("================================================================");
+      fmt::println("Benchmarking Strongly Connected Components");
+      fmt::println("{} tests are run and the minimum is taken\n", scc_test_trials);
+      fmt::println("{:<22}  {:>7}  {:>12}  {:>11}  {:>7}", "Algorithm", "Threads", "Components", "Elapsed (s)",
+                   "Speedup");
+
+      size_t       expected     = 0;
+      const double base_elapsed = min_elapsed(
+            [&]() {
+              kosaraju(g, g_t, component);
+              return static_cast<size_t>(*std::ranges::max_element(component)) + 1;
+            },
+            expected);
+      fmt::println("{:<22}  {:>7}  {:>12L}  {:>11.3f}  {:>7.2f}", "kosaraju", 1, expected, base_elapsed, 1.0);
+
+      size_t       count          = 0;
+      const double tarjan_elapsed = min_elapsed([&]() { return tarjan_scc(g, component); }, count);
+      fmt::println("{:<22}  {:>7}  {:>12L}  {:>11.3f}  {:>7.2f}", "tarjan_scc", 1, count, tarjan_elapsed,
+                   base_elapsed / tarjan_elapsed);
+
+      for (size_t num_threads = 1;; num_threads = std::min(num_threads * 2, hardware_thread_count())) {
+        const double elapsed =
+              min_elapsed([&]() { return forward_backward_scc(g, g_t, component, num_threads); }, count);
+        fmt::println("{:<22}  {:>7}  {:>12L}  {:>11.3f}  {:>7.2f}", "forward_backward_scc", num_threads, count,
+                     elapsed, base_elapsed / elapsed);
+        if (count != expected)
+          fmt::println("Error: the number of components differs from kosaraju");
+        if (num_threads == hardware_thread_count())
+          break;
+      }
+      cout << endl;
+    } catch (const std::exception& e) {
+      fmt::print("Exception caught: {}\n", e.what());
+    }
+  }
+}
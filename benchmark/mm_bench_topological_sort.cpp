@@ -0,0 +1,142 @@
+#include <cstddef>
+
+// Number of trials to run to get the minimum time
+constexpr const size_t topological_sort_test_trials = 3;
+
+#include <fmt/format.h>
+
+#include "mm_load.hpp"
+
+#include "graph/graph.hpp"
+#include "graph/views/incidence.hpp"
+#include "graph/views/edgelist.hpp"
+#include "graph/algorithm/topological_sort.hpp"
+#include <algorithm>
+#include <functional>
+
+using std::vector;
+using std::cout;
+using std::endl;
+
+using fmt::println;
+
+using namespace graph;
+
+//-------------------------------------------------------------------------------------------------
+// bench_topological_sort_runner
+//
+// Compares topological_sort for 1, 2, 4, ... threads, up to the number of hardware threads, with the reverse
+// post-order of an iterative depth-first search. The GAP graphs have cycles, so only the edges from a lower to a
+// higher vertex id are kept to make them acyclic. The depth-first search view isn't used for the comparison
+// because it searches from a single seed and doesn't report when a vertex is finished.
+//
+void bench_topological_sort_runner() {
+  using vertex_id_type = int64_t;
+  using G              = compressed_graph<int64_t, void, void, vertex_id_type, vertex_id_type>;
+
+  timer session_timer("Total session");
+
+  for (bench_files bench_source : {gap_road, gap_twitter, gap_web}) {
+    triplet_matrix<vertex_id_type, int64_t> triplet;
+    array_matrix<vertex_id_type>            sources;
+
+    // Read the Matrix Market file
+    load_matrix_market(bench_source, triplet, sources, false);
+    cout << endl;
+
+    // Keep the edges from a lower to a higher id
+    size_t kept = 0;
+    for (size_t i = 0; i < triplet.rows.size(); ++i) {
+      if (triplet.rows[i] < triplet.cols[i]) {
+        triplet.rows[kept] = triplet.rows[i];
+        triplet.cols[kept] = triplet.cols[i];
+        triplet.vals[kept] = triplet.vals[i];
+        ++kept;
+      }
+    }
+    triplet.rows.resize(kept);
+    triplet.cols.resize(kept);
+    triplet.vals.resize(kept);
+
+    // Load the graph
+    G           g;
+    graph_stats stats = load_graph(triplet, g);
+    fmt::println("Graph stats: {}", stats);
+    cout << endl;
+
+    const size_t           N = num_vertices(g);
+    vector<vertex_id_type> order(N);
+    vector<vertex_id_type> levels(N);
+
+    auto min_elapsed = [&](const std::function<void()>& run) {
+      double elapsed = std::numeric_limits<double>::max(); // seconds
+      for (size_t t = 0; t < topological_sort_test_trials; ++t) {
+        simple_timer run_time;
+        run();
+        elapsed = std::min(elapsed, run_time.elapsed());
+      }
+      return elapsed;
+    };
+    auto is_topological = [&]() {
+      vector<vertex_id_type> position(N);
+      for (size_t i = 0; i < N; ++i)
+        position[static_cast<size_t>(order[i])] = static_cast<vertex_id_type>(i);
+      for (auto&& [uid, vid, uv] : views::edgelist(g))
+        if (position[static_cast<size_t>(uid)] >= position[static_cast<size_t>(vid)])
+          return false;
+      return true;
+    };
+
+    try {
+      fmt::println("================================================================");
+      fmt::println("Benchmarking Topological Sort");
+      fmt::println("{} tests are run and the minimum is taken\n", topological_sort_test_trials);
+      fmt::println("{:<16}  {:>7}  {:>11}  {:>7}", "Algorithm", "Threads", "Elapsed (s)", "Speedup");
+
+      // Reverse post-order of an iterative depth-first search from every unvisited vertex
+      const double base_elapsed = min_elapsed([&]() {
+        vector<char>                                      visited(N, false);
+        vector<std::pair<vertex_id_type, vertex_id_type>> stack; // vertex, next edge
+        size_t                                            next = N;
+        for (size_t root = 0; root < N; ++root) {
+          if (visited[root])
+            continue;
+          visited[root] = true;
+          stack.push_back({static_cast<vertex_id_type>(root), 0});
+          while (!stack.empty()) {
+            auto& [uid, e] = stack.back();
+            auto&& uvs     = edges(g, uid);
+            if (e < static_cast<vertex_id_type>(size(uvs))) {
+              const vertex_id_type vid = target_id(g, uvs[static_cast<size_t>(e++)]);
+              if (!visited[static_cast<size_t>(vid)]) {
+                visited[static_cast<size_t>(vid)] = true;
+                stack.push_back({vid, 0});
+              }
+            } else {
+              order[--next] = uid;
+              stack.pop_back();
+            }
+          }
+        }
+      });
+      fmt::println("{:<16}  {:>7}  {:>11.3f}  {:>7.2f}", "dfs", 1, base_elapsed, 1.0);
+      if (!is_topological())
+        fmt::println("Error: the depth-first order isn't topological");
+
+      for (size_t num_threads = 1;; num_threads = std::min(num_threads * 2, hardware_thread_count())) {
+        bool         sorted  = false;
+        const double elapsed = min_elapsed([&]() { sorted = topological_sort(g, order, levels, num_threads); });
+        fmt::println("{:<16}  {:>7}  {:>11.3f}  {:>7.2f}", "topological_sort", num_threads, elapsed,
+                     base_elapsed / elapsed);
+        if (!sorted || !is_topological())
+          fmt::println("Error: the order isn't topological");
+        if (num_threads == hardware_thread_count())
+          break;
+      }
+      fmt::println("Levels: {}", N > 0 ? *std::ranges::max_element(levels) + 1 : 0);
+      cout << endl;
+    } catch (const std::exception& e) {
+      fmt::print("Exception caught: {}\n", e.what());
+    }
+  }
+}
@@ -0,0 +1,362 @@
+/**
+ * @file all_pairs_shortest_paths.hpp
+ *
+ * @brief All-pairs shortest distances with a blocked Floyd-Warshall algorithm for dense graphs and Johnson's
+ * algorithm for sparse graphs.
+ *
+ * Both algorithms write the distances into a row-major V x V range, where distances[uid * V + vid] is the
+ * distance from uid to vid, or shortest_path_infinite_distance() if vid isn't reachable from uid. Negative edge
+ * weights are allowed, and a negative weight cycle is reported by returning false.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: BSL-1.0
+ *
+ * @authors
+ */
+
+#include "graph/graph.hpp"
+#include "graph/algorithm/common_shortest_paths.hpp"
+#include "graph/algorithm/bellman_ford_shortest_paths.hpp"
+#include "graph/detail/parallel.hpp"
+
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <atomic>
+#include <barrier>
+#include <stdexcept>
+#include <format>
+
+#ifndef GRAPH_ALL_PAIRS_SHORTEST_PATHS_HPP
+#  define GRAPH_ALL_PAIRS_SHORTEST_PATHS_HPP
+
+namespace graph {
+
+/**
+ * @brief The number of rows and columns in a block of the blocked Floyd-Warshall algorithm. Three blocks of
+ * doubles are 96KB, which fit in the L2 cache.
+*/
+inline constexpr size_t _floyd_warshall_block = 64;
+
+/**
+ * @brief Relaxes d[i][j] through d[i][k] + d[k][j] for i in [i0, i1), k in [k0, k1) and j in [j0, j1) of the
+ * row-major N x N matrix d, with k in the outer loop so the block may be updated in place.
+ *
+ * The inner loop is a branch-free min-plus over contiguous rows, which the compiler vectorizes. An infinite
+ * distance is never added to, so it doesn't overflow an integer or become finite with a negative weight. Signed
+ * integer sums saturate at the lowest value, since the distances keep decreasing around a negative weight cycle.
+*/
+template <class T>
+void _min_plus_block(T* d, size_t N, size_t i0, size_t i1, size_t k0, size_t k1, size_t j0, size_t j1) {
+  constexpr T infinite = shortest_path_infinite_distance<T>();
+  constexpr T lowest   = std::numeric_limits<T>::lowest();
+  auto        add      = [](const T a, const T b) {
+    if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+      return (b < 0 && a < lowest - b) ? lowest : static_cast<T>(a + b);
+    } else {
+      return static_cast<T>(a + b);
+    }
+  };
+  for (size_t k = k0; k < k1; ++k) {
+    const T* dk = d + k * N;
+    for (size_t i = i0; i < i1; ++i) {
+      T*      di  = d + i * N;
+      const T dik = di[k];
+      if (dik == infinite) {
+        continue;
+      }
+      for (size_t j = j0; j < j1; ++j) {
+        const T dkj = dk[j];
+        di[j]       = std::min(di[j], dkj == infinite ? infinite : add(dik, dkj));
+      }
+    }
+  }
+}
+
+/**
+ * @brief The blocked Floyd-Warshall algorithm on the row-major N x N matrix d.
+ *
+ * Each round k relaxes all distances through the vertices of diagonal block (k, k) in three phases: the diagonal
+ * block itself, then the other blocks in row k and column k, which only depend on the diagonal block, and then
+ * all remaining blocks, which only depend on the blocks of row k and column k. The blocks of a phase are
+ * independent and are taken by the threads in turn.
+*/
+template <class T>
+void _floyd_warshall(T* d, size_t N, size_t num_threads) {
+  constexpr size_t B  = _floyd_warshall_block;
+  const size_t     nb = (N + B - 1) / B;
+  if (nb == 0) {
+    return;
+  }
+  num_threads = std::max(std::min(num_threads, (nb - 1) * (nb - 1)), size_t(1));
+
+  auto bounds   = [&](size_t b) { return std::pair{b * B, std::min(b * B + B, N)}; };
+  auto diagonal = [&](size_t kb) {
+    const auto [k0, k1] = bounds(kb);
+    _min_plus_block(d, N, k0, k1, k0, k1, k0, k1);
+  };
+  auto other = [&](size_t b, size_t kb) { return b < kb ? b : b + 1; }; // the b-th block index other than kb
+
+  size_t         kb    = 0;
+  bool           cross = true; // the current phase is row and column kb rather than the remaining blocks
+  dynamic_chunks work(2 * (nb - 1), 1);
+
+  auto after_phase = [&]() noexcept {
+    if (cross) {
+      work.reset((nb - 1) * (nb - 1), 1);
+    } else if (++kb < nb) {
+      diagonal(kb);
+      work.reset(2 * (nb - 1), 1);
+    }
+    cross = !cross;
+  };
+  std::barrier phased(static_cast<std::ptrdiff_t>(num_threads), after_phase);
+
+  diagonal(0);
+  parallel_invoke(num_threads, [&](size_t) {
+    while (kb < nb) {
+      const auto [k0, k1] = bounds(kb);
+      if (cross) {
+        work.for_each([&](size_t first, size_t last) {
+          for (size_t t = first; t < last; ++t) {
+            if (t < nb - 1) { // block (kb, jb) in row kb
+              const auto [j0, j1] = bounds(other(t, kb));
+              _min_plus_block(d, N, k0, k1, k0, k1, j0, j1);
+            } else { // block (ib, kb) in column kb
+              const auto [i0, i1] = bounds(other(t - (nb - 1), kb));
+              _min_plus_block(d, N, i0, i1, k0, k1, k0, k1);
+            }
+          }
+        });
+      } else {
+        work.for_each([&](size_t first, size_t last) {
+          for (size_t t = first; t < last; ++t) {
+            const auto [i0, i1] = bounds(other(t / (nb - 1), kb));
+            const auto [j0, j1] = bounds(other(t % (nb - 1), kb));
+            _min_plus_block(d, N, i0, i1, k0, k1, j0, j1);
+          }
+        });
+      }
+      phased.arrive_and_wait();
+    }
+  });
+}
+
+/**
+ * @ingroup graph_algorithms
+ * @brief All-pairs shortest distances with a cache-blocked Floyd-Warshall algorithm, for small dense graphs.
+ *
+ * The distances are initialized from the edges, keeping the lowest weight of parallel edges, and then relaxed
+ * through each vertex in turn. The matrix is split into 64 x 64 blocks and each round relaxes the distances through
+ * one diagonal block in three phases, so the blocks of a phase can be relaxed in parallel and each block relaxation
+ * works on three blocks in the cache. The inner loop is a min-plus over contiguous rows that the compiler
+ * vectorizes.
+ *
+ * If distances is a contiguous range it's updated in place, and otherwise the distances are computed in a
+ * temporary matrix and copied to it.
+ *
+ * Complexity: O(V^3) time, and O(V^2) space for the distances
+ *
+ * Throws:
+ *  - out_of_range if distances is smaller than the number of vertices squared.
+ *
+ * @tparam G         The graph type.
+ * @tparam Distances The random access range of distances, with V x V values in row-major order.
+ * @tparam WF        The edge weight function. Defaults to unit_edge_weight, giving the number of edges in a
+ *                   shortest path.
+ *
+ * @param g           The graph.
+ * @param distances   [out] The distance from uid to vid in distances[uid * V + vid], or
+ *                    shortest_path_infinite_distance() if vid isn't reachable from uid.
+ * @param weight      The edge weight function, which may be called concurrently.
+ * @param num_threads The number of threads to use, including the calling thread.
+ *
+ * @return false if the graph has a negative weight cycle, in which case the distances are unspecified.
+ */
+template <index_adjacency_list G,
+          random_access_range  Distances,
+          class WF = unit_edge_weight<range_value_t<Distances>>>
+requires is_arithmetic_v<range_value_t<Distances>> && //
+         sized_range<Distances> &&                    //
+         basic_edge_weight_function<G, WF, range_value_t<Distances>, less<range_value_t<Distances>>,
+                                    plus<range_value_t<Distances>>>
+bool floyd_warshall_shortest_distances(G&&        g,
+                                       Distances& distances,
+                                       WF&&       weight      = unit_edge_weight<range_value_t<Distances>>(),
+                                       size_t     num_threads = hardware_thread_count()) {
+  using id_type       = vertex_id_t<G>;
+  using DistanceValue = range_value_t<Distances>;
+
+  const size_t N = num_vertices(g);
+  if (size(distances) < N * N) {
+    throw std::out_of_range(std::format(
+          "floyd_warshall_shortest_distances: size of distances of {} is less than the number of vertices squared {}",
+          size(distances), N * N));
+  }
+
+  std::vector<DistanceValue> temporary;
+  DistanceValue*             d = nullptr;
+  if constexpr (std::ranges::contiguous_range<Distances>) {
+    d = std::ranges::data(distances);
+  } else {
+    temporary.resize(N * N);
+    d = temporary.data();
+  }
+
+  constexpr DistanceValue zero = shortest_path_zero<DistanceValue>();
+  parallel_for(N, num_threads, 64, [&](size_t first, size_t last, size_t) {
+    for (size_t uid = first; uid < last; ++uid) {
+      DistanceValue* du = d + uid * N;
+      std::fill(du, du + N, shortest_path_infinite_distance<DistanceValue>());
+      du[uid] = zero;
+      for (auto&& uv : edges(g, static_cast<id_type>(uid))) {
+        const size_t vid = static_cast<size_t>(target_id(g, uv));
+        du[vid]          = std::min(du[vid], static_cast<DistanceValue>(weight(uv)));
+      }
+    }
+  });
+
+  _floyd_warshall(d, N, num_threads);
+
+  if constexpr (!std::ranges::contiguous_range<Distances>) {
+    std::ranges::copy(temporary, std::ranges::begin(distances));
+  }
+  for (size_t uid = 0; uid < N; ++uid) {
+    if (d[uid * N + uid] < zero) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @ingroup graph_algorithms
+ * @brief All-pairs shortest distances with Johnson's algorithm, running Dijkstra's algorithm from each source in
+ * parallel, for sparse graphs.
+ *
+ * If any edge weight is negative, a potential h(v) is found for each vertex with the Bellman-Ford algorithm from a
+ * virtual source with a zero-weight edge to every vertex, and each edge is reweighted to w(u,v) + h(u) - h(v),
+ * which isn't negative. When all weights are non-negative, the Bellman-Ford step is skipped. A Dijkstra search
+ * from each vertex then fills its row of distances, with d(u,v) = d'(u,v) - h(u) + h(v). Each thread takes sources
+ * in turn and reuses its own heap and distances.
+ *
+ * Complexity: O(V * E log V), plus O(V * E) for the Bellman-Ford algorithm when a weight is negative. O(V^2) space
+ * for the distances.
+ *
+ * Throws:
+ *  - out_of_range if distances is smaller than the number of vertices squared.
+ *
+ * @tparam G         The graph type.
+ * @tparam Distances The random access range of distances, with V x V values in row-major order.
+ * @tparam WF        The edge weight function. Defaults to unit_edge_weight, giving the number of edges in a
+ *                   shortest path.
+ *
+ * @param g           The graph.
+ * @param distances   [out] The distance from uid to vid in distances[uid * V + vid], or
+ *                    shortest_path_infinite_distance() if vid isn't reachable from uid.
+ * @param weight      The edge weight function, which may be called concurrently.
+ * @param num_threads The number of threads to use, including the calling thread.
+ *
+ * @return false if the graph has a negative weight cycle, in which case the distances are unchanged.
+ */
+template <index_adjacency_list G,
+          random_access_range  Distances,
+          class WF = unit_edge_weight<range_value_t<Distances>>>
+requires is_arithmetic_v<range_value_t<Distances>> && //
+         sized_range<Distances> &&                    //
+         basic_edge_weight_function<G, WF, range_value_t<Distances>, less<range_value_t<Distances>>,
+                                    plus<range_value_t<Distances>>>
+bool johnson_shortest_distances(G&&        g,
+                                Distances& distances,
+                                WF&&       weight      = unit_edge_weight<range_value_t<Distances>>(),
+                                size_t     num_threads = hardware_thread_count()) {
+  using id_type       = vertex_id_t<G>;
+  using DistanceValue = range_value_t<Distances>;
+
+  const size_t N = num_vertices(g);
+  if (size(distances) < N * N) {
+    throw std::out_of_range(std::format(
+          "johnson_shortest_distances: size of distances of {} is less than the number of vertices squared {}",
+          size(distances), N * N));
+  }
+  if (N == 0) {
+    return true;
+  }
+  num_threads = std::max(std::min(num_threads, N), size_t(1));
+
+  constexpr DistanceValue infinite = shortest_path_infinite_distance<DistanceValue>();
+  constexpr DistanceValue zero     = shortest_path_zero<DistanceValue>();
+
+  std::atomic<bool> negative = false;
+  parallel_for(N, num_threads, 1024, [&](size_t first, size_t last, size_t) {
+    for (size_t uid = first; uid < last && !negative.load(std::memory_order_relaxed); ++uid) {
+      for (auto&& uv : edges(g, static_cast<id_type>(uid))) {
+        if (static_cast<DistanceValue>(weight(uv)) < zero) {
+          negative.store(true, std::memory_order_relaxed);
+          break;
+        }
+      }
+    }
+  });
+
+  // The potentials are the distances from a virtual source with a zero-weight edge to every vertex
+  std::vector<DistanceValue> h(N, zero);
+  const bool                 reweight = negative.load();
+  if (reweight) {
+    std::vector<id_type> sources(N);
+    std::iota(sources.begin(), sources.end(), id_type(0));
+    if (bellman_ford_shortest_distances(g, sources, h, weight)) {
+      return false;
+    }
+  }
+
+  using queue_entry = std::pair<DistanceValue, id_type>;
+  std::vector<std::vector<DistanceValue>> dist(num_threads, std::vector<DistanceValue>(N));
+  std::vector<std::vector<queue_entry>>   heaps(num_threads);
+
+  parallel_for(N, num_threads, 16, [&](size_t first, size_t last, size_t tid) {
+    std::vector<DistanceValue>& du   = dist[tid];
+    std::vector<queue_entry>&   heap = heaps[tid];
+    for (size_t sid = first; sid < last; ++sid) {
+      std::ranges::fill(du, infinite);
+      du[sid] = zero;
+      heap.emplace_back(zero, static_cast<id_type>(sid));
+      while (!heap.empty()) {
+        std::ranges::pop_heap(heap, std::greater<>());
+        const auto [d_u, uid] = heap.back();
+        heap.pop_back();
+        if (d_u > du[static_cast<size_t>(uid)]) {
+          continue; // a stale entry
+        }
+        for (auto&& uv : edges(g, uid)) {
+          const id_type vid = target_id(g, uv);
+          DistanceValue w   = static_cast<DistanceValue>(weight(uv));
+          if (reweight) {
+            // Rounding may leave a reweighted floating point weight slightly negative
+            w = std::max(static_cast<DistanceValue>(w + h[static_cast<size_t>(uid)] - h[static_cast<size_t>(vid)]),
+                         zero);
+          }
+          if (d_u + w < du[static_cast<size_t>(vid)]) {
+            du[static_cast<size_t>(vid)] = d_u + w;
+            heap.emplace_back(d_u + w, vid);
+            std::ranges::push_heap(heap, std::greater<>());
+          }
+        }
+      }
+
+      const size_t row = sid * N;
+      for (size_t vid = 0; vid < N; ++vid) {
+        distances[row + vid] = du[vid] == infinite ? infinite : static_cast<DistanceValue>(du[vid] - h[sid] + h[vid]);
+      }
+    }
+  });
+  return true;
+}
+
+} // namespace graph
+
+#endif // GRAPH_ALL_PAIRS_SHORTEST_PATHS_HPP
@@ -17,6 +17,7 @@
 #include "graph/views/edgelist.hpp"
 #include "graph/algorithm/common_shortest_paths.hpp"
 
+#include <vector>
 #include <ranges>
 #include <optional>
 #include <stdexcept>
@@ -65,7 +66,7 @@ void find_negative_cycle(G&                              g,
  * 
  * The implementation was taken from boost::graph bellman_ford_shortest_paths.
  * 
- * Complexity: O(V * E)
+ * Complexity: O(V * E), or O(V + E) when the default unit_edge_weight is used without edge events
  * 
  * Pre-conditions:
  *  - 0 <= source < num_vertices(g)
@@ -82,7 +83,8 @@ void find_negative_cycle(G&                              g,
  * @tparam G            The graph type,
  * @tparam Distances    The distance random access range.
  * @tparam Predecessors The predecessor random access range.
- * @tparam WF           Edge weight function. Defaults to a function that returns 1.
+ * @tparam WF           Edge weight function. Defaults to unit_edge_weight, which returns 1 and evaluates
+ *                      the search as a breadth-first search.
  * @tparam Visitor      Visitor type with functions called for different events in the algorithm.
  *                      Function calls are removed by the optimizer if not used.
  * @tparam Compare      Comparison function for Distance values. Defaults to less<DistanceValue>.
@@ -96,7 +98,7 @@ template <index_adjacency_list G,
           input_range          Sources,
           random_access_range  Distances,
           random_access_range  Predecessors,
-          class WF      = function<range_value_t<Distances>(edge_reference_t<G>)>,
+          class WF      = unit_edge_weight<range_value_t<Distances>>,
           class Visitor = empty_visitor,
           class Compare = less<range_value_t<Distances>>,
           class Combine = plus<range_value_t<Distances>>>
@@ -111,7 +113,7 @@ requires convertible_to<range_value_t<Sources>, vertex_id_t<G>> &&      //
       const Sources& sources,
       Distances&     distances,
       Predecessors&  predecessor,
-      WF&&      weight  = [](edge_reference_t<G> uv) { return range_value_t<Distances>(1); }, // default weight(uv) -> 1
+      WF&&      weight  = unit_edge_weight<range_value_t<Distances>>(), // default weight(uv) -> 1
       Visitor&& visitor = empty_visitor(),
       Compare&& compare = less<range_value_t<Distances>>(),
       Combine&& combine = plus<range_value_t<Distances>>()) {
@@ -156,6 +158,15 @@ requires convertible_to<range_value_t<Sources>, vertex_id_t<G>> &&      //
 
   const id_type N = static_cast<id_type>(num_vertices(g));
 
+  // With unit edge weights there can't be a negative weight cycle and a breadth-first search gives the
+  // same distances in O(V + E). It's only used when no edge events are observed because their sequence
+  // is specific to the Bellman-Ford evaluation.
+  constexpr bool is_unit_weight = _unit_weight_search<WF, DistanceValue, Compare, Combine> &&
+                                  !has_on_examine_edge<G, Visitor> && !has_on_edge_relaxed<G, Visitor> &&
+                                  !has_on_edge_not_relaxed<G, Visitor> && !has_on_edge_minimized<G, Visitor> &&
+                                  !has_on_edge_not_minimized<G, Visitor>;
+  std::vector<id_type> frontier; // vertices at the current hop count for the breadth-first search
+
   // Seed the queue with the initial vertice(s)
   for (auto&& source : sources) {
     if (source >= N || source < 0) {
@@ -166,6 +177,26 @@ requires convertible_to<range_value_t<Sources>, vertex_id_t<G>> &&      //
     if constexpr (has_on_discover_vertex<G, Visitor>) {
       visitor.on_discover_vertex({source, *find_vertex(g, source)});
     }
+    if constexpr (is_unit_weight) {
+      frontier.push_back(source);
+    }
+  }
+
+  // Evaluate the shortest paths one hop count (level) at a time
+  if constexpr (is_unit_weight) {
+    std::vector<id_type> next;
+    while (!frontier.empty()) {
+      for (const id_type uid : frontier) {
+        for (auto&& [vid, uv, w] : views::incidence(g, uid, weight)) {
+          if (relax_target(uv, uid, w)) {
+            next.push_back(vid);
+          }
+        }
+      }
+      frontier.swap(next);
+      next.clear();
+    }
+    return return_type();
   }
 
   // Evaluate the shortest paths
@@ -214,7 +245,7 @@ requires convertible_to<range_value_t<Sources>, vertex_id_t<G>> &&      //
 template <index_adjacency_list G,
           random_access_range  Distances,
           random_access_range  Predecessors,
-          class WF      = function<range_value_t<Distances>(edge_reference_t<G>)>,
+          class WF      = unit_edge_weight<range_value_t<Distances>>,
           class Visitor = empty_visitor,
           class Compare = less<range_value_t<Distances>>,
           class Combine = plus<range_value_t<Distances>>>
@@ -228,7 +259,7 @@ requires is_arithmetic_v<range_value_t<Distances>> &&                   //
       vertex_id_t<G> source,
       Distances&     distances,
       Predecessors&  predecessor,
-      WF&&      weight  = [](edge_reference_t<G> uv) { return range_value_t<Distances>(1); }, // default weight(uv) -> 1
+      WF&&      weight  = unit_edge_weight<range_value_t<Distances>>(), // default weight(uv) -> 1
       Visitor&& visitor = empty_visitor(),
       Compare&& compare = less<range_value_t<Distances>>(),
       Combine&& combine = plus<range_value_t<Distances>>()) {
@@ -257,7 +288,8 @@ requires is_arithmetic_v<range_value_t<Distances>> &&                   //
  * 
  * @tparam G            The graph type,
  * @tparam Distances    The distance random access range.
- * @tparam WF           Edge weight function. Defaults to a function that returns 1.
+ * @tparam WF           Edge weight function. Defaults to unit_edge_weight, which returns 1 and evaluates
+ *                      the search as a breadth-first search.
  * @tparam Visitor      Visitor type with functions called for different events in the algorithm.
  *                      Function calls are removed by the optimizer if not used.
  * @tparam Compare      Comparison function for Distance values. Defaults to less<DistanceValue>.
@@ -270,7 +302,7 @@ requires is_arithmetic_v<range_value_t<Distances>> &&                   //
 template <index_adjacency_list G,
           input_range          Sources,
           random_access_range  Distances,
-          class WF      = function<range_value_t<Distances>(edge_reference_t<G>)>,
+          class WF      = unit_edge_weight<range_value_t<Distances>>,
           class Visitor = empty_visitor,
           class Compare = less<range_value_t<Distances>>,
           class Combine = plus<range_value_t<Distances>>>
@@ -282,7 +314,7 @@ requires convertible_to<range_value_t<Sources>, vertex_id_t<G>> && //
       G&&            g,
       const Sources& sources,
       Distances&     distances,
-      WF&&      weight  = [](edge_reference_t<G> uv) { return range_value_t<Distances>(1); }, // default weight(uv) -> 1
+      WF&&      weight  = unit_edge_weight<range_value_t<Distances>>(), // default weight(uv) -> 1
       Visitor&& visitor = empty_visitor(),
       Compare&& compare = less<range_value_t<Distances>>(),
       Combine&& combine = plus<range_value_t<Distances>>()) {
@@ -292,7 +324,7 @@ requires convertible_to<range_value_t<Sources>, vertex_id_t<G>> && //
 
 template <index_adjacency_list G,
           random_access_range  Distances,
-          class WF      = function<range_value_t<Distances>(edge_reference_t<G>)>,
+          class WF      = unit_edge_weight<range_value_t<Distances>>,
           class Visitor = empty_visitor,
           class Compare = less<range_value_t<Distances>>,
           class Combine = plus<range_value_t<Distances>>>
@@ -303,7 +335,7 @@ requires is_arithmetic_v<range_value_t<Distances>> && //
       G&&            g,
       vertex_id_t<G> source,
       Distances&     distances,
-      WF&&      weight  = [](edge_reference_t<G> uv) { return range_value_t<Distances>(1); }, // default weight(uv) -> 1
+      WF&&      weight  = unit_edge_weight<range_value_t<Distances>>(), // default weight(uv) -> 1
       Visitor&& visitor = empty_visitor(),
       Compare&& compare = less<range_value_t<Distances>>(),
       Combine&& combine = plus<range_value_t<Distances>>()) {
@@ -0,0 +1,298 @@
+/**
+ * @file betweenness_centrality.hpp
+ *
+ * @brief Betweenness centrality with Brandes' algorithm, exact or approximated by sampling the sources.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: BSL-1.0
+ *
+ * @authors
+ */
+
+#include "graph/graph.hpp"
+#include "graph/views/incidence.hpp"
+#include "graph/algorithm/common_shortest_paths.hpp"
+#include "graph/detail/parallel.hpp"
+
+#include <vector>
+#include <queue>
+#include <ranges>
+#include <random>
+#include <numeric>
+#include <utility>
+#include <cstdint>
+#include <cmath>
+#include <stdexcept>
+#include <format>
+
+#ifndef GRAPH_BETWEENNESS_CENTRALITY_HPP
+#  define GRAPH_BETWEENNESS_CENTRALITY_HPP
+
+namespace graph {
+
+/**
+ * @brief Implementation of the betweenness centrality used by the public functions.
+ *
+ * Runs Brandes' algorithm from each source, split across num_threads threads, and sets centrality[uid] to scale
+ * times the sum of the dependencies of the sources on uid. Each thread has its own search state and accumulates
+ * the dependencies in its own array, and the arrays are summed at the end.
+ *
+ * The search from a source counts the shortest paths to each vertex (sigma) with a breadth-first search for unit
+ * weights, or Dijkstra's algorithm otherwise, recording the vertices in the order they're finished. The
+ * dependencies are then accumulated in reverse order. The successors of a vertex on a shortest path are found
+ * again from its out-edges, so no predecessor lists are needed.
+*/
+template <index_adjacency_list G, random_access_range Sources, random_access_range Centrality, class WF>
+void _betweenness_centrality(
+      G&& g, const Sources& sources, Centrality& centrality, WF&& weight, double scale, size_t num_threads) {
+  using id_type       = vertex_id_t<G>;
+  using distance_type = remove_cvref_t<invoke_result_t<WF, edge_reference_t<G>>>;
+  using value_type    = range_value_t<Centrality>;
+
+  constexpr bool is_unit_weight = is_unit_edge_weight_v<WF>;
+  constexpr auto zero           = shortest_path_zero<distance_type>();
+  constexpr auto infinite       = shortest_path_infinite_distance<distance_type>();
+
+  const size_t N = num_vertices(g);
+  if (size(centrality) < N) {
+    throw std::out_of_range(
+          std::format("betweenness_centrality: size of centrality of {} is less than the number of vertices {}",
+                      size(centrality), N));
+  }
+  for (auto&& source : sources) {
+    if (std::cmp_less(source, 0) || std::cmp_greater_equal(source, N)) {
+      throw std::out_of_range(std::format("betweenness_centrality: source vertex id '{}' is out of range", source));
+    }
+  }
+
+  // The search state of a thread. The arrays are allocated by the thread's first search, and only the entries of
+  // the vertices reached are reset after each search.
+  struct search_state {
+    std::vector<distance_type> distance;
+    std::vector<double>        sigma; // number of shortest paths from the source
+    std::vector<double>        delta; // dependency of the source on the vertex
+    std::vector<id_type>       finished;
+    std::vector<double>        centrality;
+  };
+  const size_t              T = std::max(std::min(num_threads, size(sources)), size_t(1));
+  std::vector<search_state> states(T);
+
+  auto search = [&](search_state& st, id_type s) {
+    st.distance[static_cast<size_t>(s)] = zero;
+    st.sigma[static_cast<size_t>(s)]    = 1;
+    if constexpr (is_unit_weight) {
+      // The finished vertices are the breadth-first search queue
+      st.finished.push_back(s);
+      for (size_t head = 0; head < st.finished.size(); ++head) {
+        const id_type       uid = st.finished[head];
+        const distance_type d_v = st.distance[static_cast<size_t>(uid)] + 1;
+        for (auto&& uv : edges(g, uid)) {
+          const size_t vid = static_cast<size_t>(target_id(g, uv));
+          if (st.distance[vid] == infinite) {
+            st.distance[vid] = d_v;
+            st.finished.push_back(static_cast<id_type>(vid));
+          }
+          if (st.distance[vid] == d_v) {
+            st.sigma[vid] += st.sigma[static_cast<size_t>(uid)];
+          }
+        }
+      }
+    } else {
+      using entry = std::pair<distance_type, id_type>;
+      std::priority_queue<entry, std::vector<entry>, std::greater<entry>> queue;
+      queue.push({zero, s});
+      while (!queue.empty()) {
+        const auto [d_u, uid] = queue.top();
+        queue.pop();
+        if (d_u != st.distance[static_cast<size_t>(uid)] || st.delta[static_cast<size_t>(uid)] != 0) {
+          continue; // a stale entry, or already finished (delta marks finished vertices until the accumulation)
+        }
+        st.delta[static_cast<size_t>(uid)] = -1;
+        st.finished.push_back(uid);
+        for (auto&& [vid, uv, w] : views::incidence(g, uid, weight)) {
+          if (!(w > zero)) {
+            throw std::out_of_range(
+                  std::format("betweenness_centrality: invalid non-positive edge weight of '{}' encountered", w));
+          }
+          const distance_type d_v = d_u + w;
+          if (d_v < st.distance[static_cast<size_t>(vid)]) {
+            st.distance[static_cast<size_t>(vid)] = d_v;
+            st.sigma[static_cast<size_t>(vid)]    = st.sigma[static_cast<size_t>(uid)];
+            queue.push({d_v, vid});
+          } else if (d_v == st.distance[static_cast<size_t>(vid)]) {
+            st.sigma[static_cast<size_t>(vid)] += st.sigma[static_cast<size_t>(uid)];
+          }
+        }
+      }
+    }
+
+    // Accumulate the dependencies in the reverse of the order the vertices were finished
+    for (auto it = st.finished.rbegin(); it != st.finished.rend(); ++it) {
+      const size_t uid   = static_cast<size_t>(*it);
+      double       delta = 0;
+      for (auto&& [vid, uv, w] : views::incidence(g, *it, weight)) {
+        if (st.distance[static_cast<size_t>(vid)] == st.distance[uid] + w) {
+          delta += st.sigma[uid] / st.sigma[static_cast<size_t>(vid)] * (1 + st.delta[static_cast<size_t>(vid)]);
+        }
+      }
+      st.delta[uid] = delta;
+      if (*it != s) {
+        st.centrality[uid] += delta;
+      }
+    }
+
+    for (id_type uid : st.finished) {
+      st.distance[static_cast<size_t>(uid)] = infinite;
+      st.sigma[static_cast<size_t>(uid)]    = 0;
+      st.delta[static_cast<size_t>(uid)]    = 0;
+    }
+    st.finished.clear();
+  };
+
+  parallel_for(size(sources), T, 1, [&](size_t first, size_t last, size_t tid) {
+    search_state& st = states[tid];
+    if (st.distance.empty()) {
+      st.distance.assign(N, infinite);
+      st.sigma.assign(N, 0);
+      st.delta.assign(N, 0);
+      st.centrality.assign(N, 0);
+    }
+    for (size_t i = first; i < last; ++i) {
+      search(st, static_cast<id_type>(sources[i]));
+    }
+  });
+
+  parallel_for(N, num_threads, 4096, [&](size_t first, size_t last, size_t) {
+    for (size_t uid = first; uid < last; ++uid) {
+      double total = 0;
+      for (auto& st : states) {
+        if (!st.centrality.empty()) {
+          total += st.centrality[uid];
+        }
+      }
+      centrality[uid] = static_cast<value_type>(scale * total);
+    }
+  });
+}
+
+/**
+ * @ingroup graph_algorithms
+ * @brief Betweenness centrality of every vertex with Brandes' algorithm, searching from the sources in parallel.
+ *
+ * The betweenness centrality of a vertex v is the sum, over all ordered pairs of vertices s != v != t, of the
+ * fraction of the shortest paths from s to t that pass through v. For an undirected graph, where each edge is
+ * stored in both directions, each unordered pair is counted twice; halve the values for the usual definition.
+ *
+ * A search is run from every vertex, with a breadth-first search when the default unit_edge_weight is used and
+ * Dijkstra's algorithm otherwise. The searches are split across num_threads threads, each accumulating into its
+ * own array, so the memory is O(V) per thread. With floating-point weights, paths are only counted as equally
+ * short when their lengths are exactly equal.
+ *
+ * Complexity: O(V * E) for unit weights, O(V * (E + V) log V) otherwise
+ *
+ * Throws:
+ *  - out_of_range if centrality is smaller than the number of vertices, or an edge weight isn't positive.
+ *
+ * @tparam G          The graph type.
+ * @tparam Centrality The random access range of centrality values.
+ * @tparam WF         Edge weight function. Defaults to unit_edge_weight, which returns 1.
+ *
+ * @param g           The graph.
+ * @param centrality  [out] The betweenness centrality of each vertex, accessible through centrality[uid].
+ * @param weight      The edge weight function, which must return positive weights.
+ * @param num_threads The number of threads to use, including the calling thread.
+ */
+template <index_adjacency_list G,
+          random_access_range  Centrality,
+          class WF = unit_edge_weight<range_value_t<Centrality>>>
+requires std::floating_point<range_value_t<Centrality>> && sized_range<Centrality> &&
+         is_arithmetic_v<remove_cvref_t<invoke_result_t<WF, edge_reference_t<G>>>>
+void betweenness_centrality(G&&         g,
+                            Centrality& centrality,
+                            WF&&        weight      = unit_edge_weight<range_value_t<Centrality>>(),
+                            size_t      num_threads = hardware_thread_count()) {
+  std::vector<vertex_id_t<G>> sources(num_vertices(g));
+  std::iota(sources.begin(), sources.end(), vertex_id_t<G>(0));
+  _betweenness_centrality(g, sources, centrality, weight, 1.0, num_threads);
+}
+
+/**
+ * @ingroup graph_algorithms
+ * @brief The number of sources to sample for approximate_betweenness_centrality() so that, with probability at
+ * least 1 - delta, the error of every vertex's centrality is at most epsilon * N * (N - 2) for N vertices.
+ *
+ * The dependency of a source on a vertex is between 0 and N - 2, so by Hoeffding's inequality and a union bound
+ * over the N vertices, ln(2 * N / delta) / (2 * epsilon^2) samples are enough. epsilon is the error of the
+ * centrality normalized by N * (N - 2), the number of pairs that could pass through a vertex.
+ *
+ * @param num_vertices The number of vertices in the graph.
+ * @param epsilon      The error bound for the normalized centrality, in (0, 1).
+ * @param delta        The probability that the bound doesn't hold, in (0, 1).
+ *
+ * @return The number of sources to sample.
+ */
+inline size_t betweenness_sample_count(size_t num_vertices, double epsilon, double delta) {
+  if (!(epsilon > 0 && epsilon < 1) || !(delta > 0 && delta < 1)) {
+    throw std::out_of_range(
+          std::format("betweenness_sample_count: epsilon {} and delta {} must be in (0, 1)", epsilon, delta));
+  }
+  const double n = static_cast<double>(std::max(num_vertices, size_t(1)));
+  return static_cast<size_t>(std::ceil(std::log(2 * n / delta) / (2 * epsilon * epsilon)));
+}
+
+/**
+ * @ingroup graph_algorithms
+ * @brief Approximate betweenness centrality, from Brandes' algorithm run from sources sampled uniformly at random.
+ *
+ * The sources are drawn with replacement, and the dependencies on each vertex are scaled by N / num_samples, which
+ * is an unbiased estimate of its betweenness centrality. Use betweenness_sample_count() to choose num_samples for a
+ * given error bound. The result depends only on the seed, not on the number of threads, apart from rounding.
+ *
+ * Complexity: O(num_samples * E) for unit weights, O(num_samples * (E + V) log V) otherwise
+ *
+ * Throws:
+ *  - out_of_range if centrality is smaller than the number of vertices, or an edge weight isn't positive.
+ *
+ * @tparam G          The graph type.
+ * @tparam Centrality The random access range of centrality values.
+ * @tparam WF         Edge weight function. Defaults to unit_edge_weight, which returns 1.
+ *
+ * @param g           The graph.
+ * @param centrality  [out] The estimated betweenness centrality of each vertex, accessible through centrality[uid].
+ * @param num_samples The number of sources to sample.
+ * @param weight      The edge weight function, which must return positive weights.
+ * @param seed        The seed for choosing the sources.
+ * @param num_threads The number of threads to use, including the calling thread.
+ */
+template <index_adjacency_list G,
+          random_access_range  Centrality,
+          class WF = unit_edge_weight<range_value_t<Centrality>>>
+requires std::floating_point<range_value_t<Centrality>> && sized_range<Centrality> &&
+         is_arithmetic_v<remove_cvref_t<invoke_result_t<WF, edge_reference_t<G>>>>
+void approximate_betweenness_centrality(G&&         g,
+                                        Centrality& centrality,
+                                        size_t      num_samples,
+                                        WF&&        weight      = unit_edge_weight<range_value_t<Centrality>>(),
+                                        uint64_t    seed        = 0,
+                                        size_t      num_threads = hardware_thread_count()) {
+  using id_type  = vertex_id_t<G>;
+  const size_t N = num_vertices(g);
+  if (N == 0 || num_samples == 0) {
+    _betweenness_centrality(g, std::vector<id_type>(), centrality, weight, 0.0, num_threads);
+    return;
+  }
+
+  std::mt19937_64                       gen(seed);
+  std::uniform_int_distribution<size_t> pick(0, N - 1);
+  std::vector<id_type>                  sources(num_samples);
+  for (auto& s : sources) {
+    s = static_cast<id_type>(pick(gen));
+  }
+  _betweenness_centrality(g, sources, centrality, weight,
+                          static_cast<double>(N) / static_cast<double>(num_samples), num_threads);
+}
+
+} // namespace graph
+
+#endif // GRAPH_BETWEENNESS_CENTRALITY_HPP
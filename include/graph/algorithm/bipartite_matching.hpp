@@ -0,0 +1,487 @@
+/**
+ * @file bipartite_matching.hpp
+ *
+ * @brief Maximum cardinality matching of a bipartite graph: the Hopcroft-Karp algorithm, and a parallel
+ * push-relabel algorithm for very large graphs.
+ *
+ * The two sides of the graph are given by its partitions: the left vertices are those of one partition, given by
+ * vertices(g,pid), and the right vertices are all the others. Only the edges of the left vertices are used, so the
+ * graph may store each edge once, from its left vertex, or in both directions. An edge between two left vertices is
+ * ignored.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: BSL-1.0
+ *
+ * @authors
+ */
+
+#include "graph/graph.hpp"
+#include "graph/detail/parallel.hpp"
+
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <atomic>
+#include <barrier>
+#include <utility>
+#include <stdexcept>
+#include <format>
+
+#ifndef GRAPH_BIPARTITE_MATCHING_HPP
+#  define GRAPH_BIPARTITE_MATCHING_HPP
+
+namespace graph {
+
+/**
+ * @brief Sets lefts to the ids of the vertices in partition pid, and is_left to a flag for each vertex of the graph
+ * that is set if it's in the partition.
+ *
+ * Throws out_of_range if pid isn't a partition of g, naming the algorithm.
+*/
+template <index_adjacency_list G>
+void _partition_vertices(G&&                          g,
+                         partition_id_t<G>            pid,
+                         std::vector<vertex_id_t<G>>& lefts,
+                         std::vector<char>&           is_left,
+                         const char*                  algorithm) {
+  const auto num_parts = num_partitions(g);
+  if (static_cast<size_t>(pid) >= static_cast<size_t>(num_parts)) {
+    throw std::out_of_range(std::format("{}: left partition {} is not less than the number of partitions {}",
+                                        algorithm, pid, num_parts));
+  }
+
+  // The graph is const so that vertex_id() is given an iterator of the same constness as the graph
+  const auto& cg = std::as_const(g);
+  auto&&      vs = vertices(cg, pid);
+  is_left.assign(num_vertices(g), false);
+  for (auto ui = std::ranges::begin(vs); ui != std::ranges::end(vs); ++ui) {
+    lefts.push_back(vertex_id(cg, ui));
+    is_left[static_cast<size_t>(lefts.back())] = true;
+  }
+}
+
+/**
+ * @brief Hopcroft-Karp phases that grow the matching m until it's maximum.
+ *
+ * m[uid] is the vertex matched with uid, or the largest id value if uid is unmatched, and must be consistent on both
+ * sides. Each phase is a breadth-first search from the free left vertices that labels each left vertex with its
+ * layer, stopping at the first layer with an edge to a free right vertex, followed by a depth-first search from each
+ * free left vertex that augments along a shortest path through the layers. The searches are iterative, keeping the
+ * next edge of each left vertex, so no edge is looked at twice in a phase and the depth isn't limited by the stack.
+*/
+template <index_adjacency_list G>
+void _hopcroft_karp(G&&                                g,
+                    const std::vector<vertex_id_t<G>>& lefts,
+                    const std::vector<char>&           is_left,
+                    std::vector<vertex_id_t<G>>&       m) {
+  using id_type                  = vertex_id_t<G>;
+  constexpr id_type    none      = std::numeric_limits<id_type>::max();
+  constexpr size_t     unreached = std::numeric_limits<size_t>::max();
+  std::vector<size_t>  layer(m.size(), unreached);
+  std::vector<id_type> queue, path;
+  std::vector<vertex_edge_iterator_t<G>> next(m.size());
+  queue.reserve(lefts.size());
+
+  while (true) {
+    // Layer the left vertices from the free ones, up to the first layer adjacent to a free right vertex
+    queue.clear();
+    for (id_type uid : lefts) {
+      if (m[static_cast<size_t>(uid)] == none) {
+        layer[static_cast<size_t>(uid)] = 0;
+        next[static_cast<size_t>(uid)]  = std::ranges::begin(edges(g, uid));
+        queue.push_back(uid);
+      } else {
+        layer[static_cast<size_t>(uid)] = unreached;
+      }
+    }
+    const size_t num_free = queue.size();
+    size_t       last     = unreached; // the layer with an edge to a free right vertex
+    for (size_t i = 0; i < queue.size() && layer[static_cast<size_t>(queue[i])] <= last; ++i) {
+      const id_type uid = queue[i];
+      const size_t  lu  = layer[static_cast<size_t>(uid)];
+      for (auto&& uv : edges(g, uid)) {
+        const size_t vid = static_cast<size_t>(target_id(g, uv));
+        if (is_left[vid]) {
+          continue;
+        }
+        const id_type wid = m[vid];
+        if (wid == none) {
+          last = lu;
+        } else if (layer[static_cast<size_t>(wid)] == unreached) {
+          layer[static_cast<size_t>(wid)] = lu + 1;
+          next[static_cast<size_t>(wid)]  = std::ranges::begin(edges(g, wid));
+          queue.push_back(wid);
+        }
+      }
+    }
+    if (last == unreached) {
+      return; // no augmenting path
+    }
+
+    // Augment along vertex-disjoint shortest paths from the free left vertices
+    for (size_t i = 0; i < num_free; ++i) {
+      path.assign(1, queue[i]);
+      while (!path.empty()) {
+        const id_type xid = path.back();
+        const size_t  lx  = layer[static_cast<size_t>(xid)];
+        auto&         it  = next[static_cast<size_t>(xid)];
+        if (it == std::ranges::end(edges(g, xid))) {
+          layer[static_cast<size_t>(xid)] = unreached; // a dead end for the rest of the phase
+          path.pop_back();
+          continue;
+        }
+        const size_t vid = static_cast<size_t>(target_id(g, *it));
+        if (!is_left[vid]) {
+          const id_type wid = m[vid];
+          if (wid == none && lx == last) {
+            for (id_type yid : path) { // each vertex of the path is matched with the target of its next edge
+              const id_type zid               = target_id(g, *next[static_cast<size_t>(yid)]);
+              m[static_cast<size_t>(zid)]     = yid;
+              m[static_cast<size_t>(yid)]     = zid;
+              layer[static_cast<size_t>(yid)] = unreached; // matched, so no other path may use it in this phase
+            }
+            path.clear();
+            break;
+          }
+          if (wid != none && lx < last && layer[static_cast<size_t>(wid)] == lx + 1) {
+            path.push_back(wid); // the edge is kept in case wid is a dead end, and skipped when path returns here
+            continue;
+          }
+        }
+        ++it;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Copies the internal matching m to mate, with the largest value of mate for an unmatched vertex.
+ *
+ * @return The number of matched pairs.
+*/
+template <class Id, random_access_range Mates>
+size_t _store_matching(const std::vector<Id>& lefts, const std::vector<Id>& m, Mates& mate) {
+  using mate_type          = range_value_t<Mates>;
+  constexpr Id none        = std::numeric_limits<Id>::max();
+  size_t       num_matched = 0;
+  for (size_t uid = 0; uid < m.size(); ++uid) {
+    mate[uid] = m[uid] == none ? std::numeric_limits<mate_type>::max() : static_cast<mate_type>(m[uid]);
+  }
+  for (Id uid : lefts) {
+    num_matched += m[static_cast<size_t>(uid)] != none;
+  }
+  return num_matched;
+}
+
+/**
+ * @ingroup graph_algorithms
+ * @brief Maximum cardinality bipartite matching with the Hopcroft-Karp algorithm.
+ *
+ * The matching starts with a greedy pass that matches each left vertex with its first unmatched neighbor. Each
+ * phase then finds a maximal set of vertex-disjoint shortest augmenting paths with a breadth-first search that
+ * layers the left vertices and a depth-first search from each free left vertex, and augments along them. The number
+ * of phases is O(sqrt(V)).
+ *
+ * Complexity: O(E * sqrt(V))
+ *
+ * Throws:
+ *  - out_of_range if mate is smaller than the number of vertices, or if left isn't a partition of g.
+ *
+ * @tparam G     The graph type, with partitions.
+ * @tparam Mates The random access range of matched vertices.
+ *
+ * @param g    The graph.
+ * @param mate [out] The vertex matched with uid in mate[uid], or the largest value of mate if uid is unmatched.
+ * @param left The partition of the left vertices. The right vertices are all the vertices of the other partitions.
+ *
+ * @return The number of matched pairs.
+ */
+template <index_adjacency_list G, random_access_range Mates>
+requires integral<range_value_t<Mates>> && sized_range<Mates> && //
+         requires(G&& g, partition_id_t<G> pid) { vertices(g, pid); }
+size_t hopcroft_karp_matching(G&& g, Mates& mate, partition_id_t<G> left = partition_id_t<G>(0)) {
+  using id_type          = vertex_id_t<G>;
+  constexpr id_type none = std::numeric_limits<id_type>::max();
+
+  const size_t N = num_vertices(g);
+  if (size(mate) < N) {
+    throw std::out_of_range(std::format(
+          "hopcroft_karp_matching: size of mate of {} is less than the number of vertices {}", size(mate), N));
+  }
+  std::vector<id_type> lefts;
+  std::vector<char>    is_left;
+  _partition_vertices(g, left, lefts, is_left, "hopcroft_karp_matching");
+
+  std::vector<id_type> m(N, none);
+  for (id_type uid : lefts) {
+    for (auto&& uv : edges(g, uid)) {
+      const id_type vid = target_id(g, uv);
+      if (!is_left[static_cast<size_t>(vid)] && m[static_cast<size_t>(vid)] == none) {
+        m[static_cast<size_t>(vid)] = uid;
+        m[static_cast<size_t>(uid)] = vid;
+        break;
+      }
+    }
+  }
+
+  _hopcroft_karp(g, lefts, is_left, m);
+  return _store_matching(lefts, m, mate);
+}
+
+/**
+ * @ingroup graph_algorithms
+ * @brief Maximum cardinality bipartite matching with a parallel push-relabel algorithm, for very large graphs.
+ *
+ * Each right vertex has a label that is a lower bound on the length of an alternating path from it to a free right
+ * vertex. The active (unmatched) left vertices are processed in parallel rounds: each is matched with its neighbor
+ * with the lowest label, taking it from its previous mate with an atomic exchange, which makes the previous mate
+ * active in the next round. The label of the neighbor is raised to two more than the second lowest label, and a
+ * left vertex whose neighbors all have a label of at least V has no augmenting path and is dropped.
+ *
+ * The labels are set exactly by a global relabeling, a parallel breadth-first search from the free right vertices
+ * over the reverse of the left edges, which is done at the start and after every V pushes. It also drops the free
+ * left vertices that it doesn't reach. The matching starts with a parallel greedy pass, and a final Hopcroft-Karp
+ * search confirms there is no augmenting path left, or augments along any that the racing label updates missed.
+ *
+ * Complexity: O(V * E) in the worst case, but close to linear in practice
+ *
+ * Throws:
+ *  - out_of_range if mate is smaller than the number of vertices, or if left isn't a partition of g.
+ *
+ * @tparam G     The graph type, with partitions.
+ * @tparam Mates The random access range of matched vertices.
+ *
+ * @param g           The graph.
+ * @param mate        [out] The vertex matched with uid in mate[uid], or the largest value of mate if uid is unmatched.
+ * @param left        The partition of the left vertices. The right vertices are all the vertices of the other
+ *                    partitions.
+ * @param num_threads The number of threads to use, including the calling thread.
+ *
+ * @return The number of matched pairs.
+ */
+template <index_adjacency_list G, random_access_range Mates>
+requires integral<range_value_t<Mates>> && sized_range<Mates> && //
+         requires(G&& g, partition_id_t<G> pid) { vertices(g, pid); }
+size_t push_relabel_matching(G&&               g,
+                             Mates&            mate,
+                             partition_id_t<G> left        = partition_id_t<G>(0),
+                             size_t            num_threads = hardware_thread_count()) {
+  using id_type          = vertex_id_t<G>;
+  constexpr id_type none = std::numeric_limits<id_type>::max();
+
+  const size_t N = num_vertices(g);
+  if (size(mate) < N) {
+    throw std::out_of_range(std::format(
+          "push_relabel_matching: size of mate of {} is less than the number of vertices {}", size(mate), N));
+  }
+  std::vector<id_type> lefts;
+  std::vector<char>    is_left;
+  _partition_vertices(g, left, lefts, is_left, "push_relabel_matching");
+  const size_t num_lefts = lefts.size();
+  num_threads            = std::max(std::min(num_threads, (N + 1023) / 1024), size_t(1));
+
+  // The left neighbors of each right vertex, for the global relabeling
+  std::vector<size_t>  first(N + 1, 0);
+  std::vector<id_type> sources;
+  parallel_for(num_lefts, num_threads, 1024, [&](size_t i_first, size_t i_last, size_t) {
+    for (size_t i = i_first; i < i_last; ++i) {
+      for (auto&& uv : edges(g, lefts[i])) {
+        const size_t vid = static_cast<size_t>(target_id(g, uv));
+        if (!is_left[vid]) {
+          std::atomic_ref<size_t>(first[vid + 1]).fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+    }
+  });
+  std::inclusive_scan(first.begin(), first.end(), first.begin());
+  std::vector<size_t> pos(first.begin(), first.end() - 1);
+  sources.resize(first[N]);
+  parallel_for(num_lefts, num_threads, 1024, [&](size_t i_first, size_t i_last, size_t) {
+    for (size_t i = i_first; i < i_last; ++i) {
+      for (auto&& uv : edges(g, lefts[i])) {
+        const size_t vid = static_cast<size_t>(target_id(g, uv));
+        if (!is_left[vid]) {
+          sources[std::atomic_ref<size_t>(pos[vid]).fetch_add(1, std::memory_order_relaxed)] = lefts[i];
+        }
+      }
+    }
+  });
+
+  // m[vid] of a right vertex is its mate, and m[uid] of a left vertex is only its mate if m[m[uid]] == uid, because
+  // uid may have been taken from since. Only the right side is changed atomically.
+  std::vector<id_type> m(N, none);
+  parallel_for(num_lefts, num_threads, 1024, [&](size_t i_first, size_t i_last, size_t) {
+    for (size_t i = i_first; i < i_last; ++i) {
+      for (auto&& uv : edges(g, lefts[i])) {
+        const id_type vid      = target_id(g, uv);
+        id_type       expected = none;
+        if (!is_left[static_cast<size_t>(vid)] &&
+            std::atomic_ref<id_type>(m[static_cast<size_t>(vid)])
+                  .compare_exchange_strong(expected, lefts[i], std::memory_order_relaxed)) {
+          m[static_cast<size_t>(lefts[i])] = vid;
+          break;
+        }
+      }
+    }
+  });
+  auto is_matched = [&](id_type uid) {
+    const id_type vid = m[static_cast<size_t>(uid)];
+    return vid != none && m[static_cast<size_t>(vid)] == uid;
+  };
+
+  enum class step { relabel, search, collect, push, done };
+  const size_t         bound = N + 1; // above the length of any alternating path
+  std::vector<size_t>  label(N, 0);
+  std::vector<char>    reached(N, false);
+  std::vector<id_type> frontier, next;
+  std::atomic<size_t>  pushes = 0; // since the last global relabeling
+  size_t               level  = 0;
+  step                 state  = step::relabel;
+
+  // Each step has each thread fill local[tid] from chunks of the work, then copy it into next at an offset given by
+  // a prefix sum of the sizes. The completion function of stepped decides the next step.
+  std::vector<std::vector<id_type>> local(num_threads);
+  std::vector<size_t>               offsets(num_threads + 1, 0);
+  dynamic_chunks                    work(N, 1024);
+
+  auto sized = [&]() noexcept {
+    for (size_t tid = 0; tid < num_threads; ++tid) {
+      offsets[tid + 1] = offsets[tid] + local[tid].size();
+    }
+    next.resize(offsets[num_threads]);
+  };
+  std::barrier filled(static_cast<std::ptrdiff_t>(num_threads), sized);
+
+  auto after_step = [&]() noexcept {
+    frontier.swap(next);
+    switch (state) {
+    case step::relabel: // the free right vertices have a label of 0
+      level = 0;
+      state = frontier.empty() ? step::done : step::search;
+      work.reset(frontier.size(), 64);
+      break;
+    case step::search: // the right vertices matched with the reached left vertices have a label of level + 2
+      level += 2;
+      if (frontier.empty()) {
+        state = step::collect;
+        work.reset(num_lefts, 1024);
+      } else {
+        work.reset(frontier.size(), 64);
+      }
+      break;
+    case step::collect: // the free left vertices that were reached are active
+    case step::push:    // the left vertices taken from are active
+      if (frontier.empty()) {
+        state = step::done;
+      } else if (state == step::push && pushes.load(std::memory_order_relaxed) >= N) {
+        state = step::relabel;
+        work.reset(N, 1024);
+      } else {
+        if (state == step::collect) {
+          pushes.store(0, std::memory_order_relaxed);
+        }
+        state = step::push;
+        work.reset(frontier.size(), 64);
+      }
+      break;
+    case step::done:
+      break;
+    }
+  };
+  std::barrier stepped(static_cast<std::ptrdiff_t>(num_threads), after_step);
+
+  parallel_invoke(num_threads, [&](size_t tid) {
+    std::vector<id_type>& found = local[tid];
+    while (state != step::done) {
+      work.for_each([&](size_t i_first, size_t i_last) {
+        for (size_t i = i_first; i < i_last; ++i) {
+          switch (state) {
+          case step::relabel: {
+            if (is_left[i]) {
+              reached[i] = false;
+            } else if (m[i] == none) {
+              label[i] = 0;
+              found.push_back(static_cast<id_type>(i));
+            } else {
+              label[i] = bound;
+            }
+          } break;
+          case step::search: {
+            const size_t vid = static_cast<size_t>(frontier[i]);
+            for (size_t j = first[vid]; j < first[vid + 1]; ++j) {
+              const size_t uid = static_cast<size_t>(sources[j]);
+              if (!reached[uid] && !std::atomic_ref<char>(reached[uid]).exchange(true, std::memory_order_relaxed) &&
+                  is_matched(static_cast<id_type>(uid))) {
+                const size_t wid = static_cast<size_t>(m[uid]); // only reached through uid
+                label[wid]       = level + 2;
+                found.push_back(static_cast<id_type>(wid));
+              }
+            }
+          } break;
+          case step::collect: {
+            if (reached[static_cast<size_t>(lefts[i])] && !is_matched(lefts[i])) {
+              found.push_back(lefts[i]);
+            }
+          } break;
+          case step::push: {
+            const id_type uid = frontier[i];
+            size_t        low = bound, second = bound;
+            id_type       vid = none;
+            for (auto&& uv : edges(g, uid)) {
+              const id_type xid = target_id(g, uv);
+              if (is_left[static_cast<size_t>(xid)]) {
+                continue;
+              }
+              const size_t lx =
+                    std::atomic_ref<size_t>(label[static_cast<size_t>(xid)]).load(std::memory_order_relaxed);
+              if (lx < low) {
+                second = low;
+                low    = lx;
+                vid    = xid;
+              } else if (lx < second) {
+                second = lx;
+              }
+            }
+            if (low >= bound) {
+              m[static_cast<size_t>(uid)] = none; // no augmenting path
+              continue;
+            }
+            const id_type wid =
+                  std::atomic_ref<id_type>(m[static_cast<size_t>(vid)]).exchange(uid, std::memory_order_relaxed);
+            m[static_cast<size_t>(uid)] = vid;
+            atomic_fetch_max(label[static_cast<size_t>(vid)], std::min(second + 2, bound));
+            pushes.fetch_add(1, std::memory_order_relaxed);
+            if (wid != none) {
+              found.push_back(wid);
+            }
+          } break;
+          case step::done:
+            break;
+          }
+        }
+      });
+      filled.arrive_and_wait();
+      std::ranges::copy(found, next.begin() + static_cast<std::ptrdiff_t>(offsets[tid]));
+      found.clear();
+      stepped.arrive_and_wait();
+    }
+  });
+
+  // Make the left side consistent with the right side, then finish with Hopcroft-Karp
+  for (id_type uid : lefts) {
+    m[static_cast<size_t>(uid)] = none;
+  }
+  for (size_t vid = 0; vid < N; ++vid) {
+    if (!is_left[vid] && m[vid] != none) {
+      m[static_cast<size_t>(m[vid])] = static_cast<id_type>(vid);
+    }
+  }
+  _hopcroft_karp(g, lefts, is_left, m);
+  return _store_matching(lefts, m, mate);
+}
+
+} // namespace graph
+
+#endif // GRAPH_BIPARTITE_MATCHING_HPP
@@ -1,10 +1,10 @@
 /**
  * @file breadth_first_search.hpp
- * 
- * @brief Single-Source & multi-source breadth-first search.
- * 
+ *
+ * @brief Single-Source & multi-source breadth-first search, and batches of independent searches.
+ *
  * @copyright Copyright (c) 2024
- * 
+ *
  * SPDX-License-Identifier: BSL-1.0
  *
  * @authors
@@ -12,102 +12,792 @@
 
 #include "graph/graph.hpp"
 #include "graph/views/incidence.hpp"
+#include "graph/algorithm/common_shortest_paths.hpp"
+#include "graph/detail/parallel.hpp"
 
 #include <vector>
-#include <queue>
 #include <ranges>
 #include <limits>
+#include <bit>
+#include <atomic>
+#include <barrier>
+#include <cstdint>
+#include <stdexcept>
+#include <format>
 
 #ifndef GRAPH_BREADTH_FIRST_SEARCH_HPP
 #  define GRAPH_BREADTH_FIRST_SEARCH_HPP
 
 namespace graph {
 
-using vertex_id_type = int;
-using Graph          = std::vector<std::vector<vertex_id_type>>;
-using Predecessors   = std::vector<vertex_id_type>;
-using Source         = vertex_id_type;
-using Sources        = std::vector<Source>;
-using Distance       = int;
-using Distances      = std::vector<Distance>;
-
-class dfs_visitor_base {
-  // Types
-public:
-  // Visitor Functions
+/**
+ * @brief A bitmap with one bit per vertex, used to represent a frontier for the bottom-up steps
+ * of a breadth-first search.
+ *
+ * This is not in the P1709 proposal. It's an implementation detail for the breadth-first search
+ * algorithms.
+*/
+class _frontier_bitmap {
 public:
-  // vertex visitor functions
-  void on_initialize_vertex(const vertex_id_type& uid) {}
-  void on_discover_vertex(const vertex_id_type& uid) {}
-  void on_examine_vertex(const vertex_id_type& uid) {}
-  void on_finish_vertex(const vertex_id_type& uid) {}
-
-  // edge visitor functions
-  void on_examine_edge(const vertex_id_type& uid) {}
+  using word_type                       = uint64_t;
+  static constexpr size_t bits_per_word = std::numeric_limits<word_type>::digits;
+
+  _frontier_bitmap() = default;
+  explicit _frontier_bitmap(size_t n) : words_((n + bits_per_word - 1) / bits_per_word), size_(n) {}
+
+  constexpr size_t size() const noexcept { return size_; }
+
+  void set(size_t i) noexcept { words_[i / bits_per_word] |= word_type(1) << (i % bits_per_word); }
+  bool test(size_t i) const noexcept { return (words_[i / bits_per_word] >> (i % bits_per_word)) & 1; }
+  void clear() noexcept { std::ranges::fill(words_, word_type(0)); }
+  void swap(_frontier_bitmap& other) noexcept {
+    words_.swap(other.words_);
+    std::swap(size_, other.size_);
+  }
+
+  /**
+   * @brief Calls f(i) for each bit i that is set, in increasing order.
+  */
+  template <class F>
+  void for_each_set(F&& f) const {
+    for (size_t w = 0; w < words_.size(); ++w) {
+      for (word_type bits = words_[w]; bits != 0; bits &= bits - 1) {
+        f(w * bits_per_word + static_cast<size_t>(std::countr_zero(bits)));
+      }
+    }
+  }
+
+private:
+  std::vector<word_type> words_;
+  size_t                 size_ = 0;
 };
 
 /**
- * @ingroup graph_algorithms
- * @brief Returns the largest value used to represent an infinite distance.
- * 
- * @return The largest possible distance value.
+ * @brief Implementation of the breadth-first search used by the public overloads.
+ *
+ * When UseBottomUp is false only top-down steps are taken and g_t isn't used.
 */
-inline Distance bfs_infinite_distance() { return std::numeric_limits<Distance>::max(); }
+template <bool UseBottomUp,
+          index_adjacency_list G,
+          index_adjacency_list GT,
+          input_range          Sources,
+          random_access_range  Distances,
+          random_access_range  Predecessors>
+void _breadth_first_search(G&&            g,
+                           GT&&           g_t,
+                           const Sources& sources,
+                           Distances&     distances,
+                           Predecessors&  predecessor,
+                           const size_t   alpha,
+                           const size_t   beta) {
+  using id_type       = vertex_id_t<G>;
+  using distance_type = range_value_t<Distances>;
+
+  if (size(distances) < size(vertices(g))) {
+    throw std::out_of_range(
+          std::format("breadth_first_search: size of distances of {} is less than the number of vertices {}",
+                      size(distances), size(vertices(g))));
+  }
+  if constexpr (!is_same_v<Predecessors, _null_range_type>) {
+    if (size(predecessor) < size(vertices(g))) {
+      throw std::out_of_range(
+            std::format("breadth_first_search: size of predecessor of {} is less than the number of vertices {}",
+                        size(predecessor), size(vertices(g))));
+    }
+  }
+  if constexpr (UseBottomUp) {
+    if (size(vertices(g_t)) != size(vertices(g))) {
+      throw std::out_of_range(
+            std::format("breadth_first_search: number of vertices in the transpose graph of {} is not {}",
+                        size(vertices(g_t)), size(vertices(g))));
+    }
+  }
+
+  constexpr auto zero     = shortest_path_zero<distance_type>();
+  constexpr auto infinite = shortest_path_infinite_distance<distance_type>();
+
+  const id_type N = static_cast<id_type>(num_vertices(g));
+
+  auto out_degree = [&g](id_type uid) -> size_t {
+    return static_cast<size_t>(std::ranges::distance(edges(g, uid)));
+  };
+
+  // Seed the frontier with the source vertice(s)
+  std::vector<id_type> frontier;
+  size_t               scout_count = 0; // number of edges out of the frontier
+  for (auto&& source : sources) {
+    if (source >= N || source < 0) {
+      throw std::out_of_range(std::format("breadth_first_search: source vertex id '{}' is out of range", source));
+    }
+    if (distances[static_cast<size_t>(source)] == zero) {
+      continue; // duplicate source
+    }
+    distances[static_cast<size_t>(source)] = zero;
+    frontier.push_back(source);
+    scout_count += out_degree(source);
+  }
+
+  // Top-down step: examine the edges out of each vertex in the frontier. Returns the number of edges
+  // out of the new frontier.
+  auto top_down_step = [&g, &distances, &predecessor, &out_degree](const std::vector<id_type>& curr,
+                                                                   std::vector<id_type>&       next,
+                                                                   const distance_type         curr_level) -> size_t {
+    size_t next_scout_count = 0;
+    for (const id_type uid : curr) {
+      for (auto&& uv : edges(g, uid)) {
+        const id_type vid = target_id(g, uv);
+        if (distances[static_cast<size_t>(vid)] == infinite) {
+          distances[static_cast<size_t>(vid)] = curr_level + 1;
+          if constexpr (!is_same_v<Predecessors, _null_range_type>) {
+            predecessor[static_cast<size_t>(vid)] = uid;
+          }
+          next.push_back(vid);
+          next_scout_count += out_degree(vid);
+        }
+      }
+    }
+    return next_scout_count;
+  };
+
+  distance_type level = zero;
+  if constexpr (UseBottomUp) {
+    // Bottom-up step: each undiscovered vertex looks for a parent in the frontier through its in-edges,
+    // stopping at the first one found. Returns the number of vertices in the new frontier.
+    auto bottom_up_step = [&g_t, &distances, &predecessor, N](const _frontier_bitmap& curr, _frontier_bitmap& next,
+                                                              const distance_type curr_level) -> size_t {
+      size_t awake_count = 0;
+      next.clear();
+      for (id_type vid = 0; vid < N; ++vid) {
+        if (distances[static_cast<size_t>(vid)] != infinite) {
+          continue;
+        }
+        for (auto&& vu : edges(g_t, vid)) {
+          const id_type uid = static_cast<id_type>(target_id(g_t, vu));
+          if (curr.test(static_cast<size_t>(uid))) {
+            distances[static_cast<size_t>(vid)] = curr_level + 1;
+            if constexpr (!is_same_v<Predecessors, _null_range_type>) {
+              predecessor[static_cast<size_t>(vid)] = uid;
+            }
+            next.set(static_cast<size_t>(vid));
+            ++awake_count;
+            break;
+          }
+        }
+      }
+      return awake_count;
+    };
+
+    const size_t         alpha_1        = std::max(alpha, size_t(1)); // 0 would divide by zero; take it as 1
+    const size_t         beta_1         = std::max(beta, size_t(1));
+    size_t               edges_to_check = static_cast<size_t>(num_edges(g)); // edges out of unexplored vertices
+    std::vector<id_type> next;
+    _frontier_bitmap     curr_bitmap(static_cast<size_t>(N));
+    _frontier_bitmap     next_bitmap(static_cast<size_t>(N));
+
+    while (!frontier.empty()) {
+      if (scout_count > edges_to_check / alpha_1) {
+        // The frontier is large: switch to bottom-up until it shrinks again (Beamer's heuristic)
+        curr_bitmap.clear();
+        for (const id_type uid : frontier) {
+          curr_bitmap.set(static_cast<size_t>(uid));
+        }
+        size_t awake_count = frontier.size();
+        size_t old_awake_count;
+        do {
+          old_awake_count = awake_count;
+          awake_count     = bottom_up_step(curr_bitmap, next_bitmap, level);
+          ++level;
+          curr_bitmap.swap(next_bitmap);
+        } while (awake_count >= old_awake_count || awake_count > static_cast<size_t>(N) / beta_1);
+
+        frontier.clear();
+        curr_bitmap.for_each_set([&frontier](size_t uid) { frontier.push_back(static_cast<id_type>(uid)); });
+        scout_count = 1;
+      } else {
+        edges_to_check -= std::min(scout_count, edges_to_check);
+        scout_count = top_down_step(frontier, next, level);
+        ++level;
+        frontier.swap(next);
+        next.clear();
+      }
+    }
+  } else {
+    std::vector<id_type> next;
+    while (!frontier.empty()) {
+      top_down_step(frontier, next, level);
+      ++level;
+      frontier.swap(next);
+      next.clear();
+    }
+  }
+}
 
 /**
- * @ingroup graph_algorithms
- * @brief Returns a distance value of zero.
- * 
- * @return A value of zero distance.
-*/
-inline Distance bfs_zero() { return 0; }
+ * @brief Direction-optimizing breadth-first search from one or more sources.
+ *
+ * Each step of the search is either top-down, where the edges out of each vertex in the frontier are
+ * examined, or bottom-up, where each undiscovered vertex searches its in-edges for a parent in the
+ * frontier and stops at the first one found. The direction is chosen using Beamer's heuristic: switch
+ * to bottom-up when the edges out of the frontier exceed 1/alpha of the edges out of unexplored vertices,
+ * and back to top-down when the frontier is smaller than 1/beta of the vertices and shrinking. Bottom-up
+ * frontiers are represented as bitmaps. On low-diameter graphs most of the edges are skipped in the
+ * middle steps.
+ *
+ * The in-edges are taken from g_t, the transpose of g. For an undirected graph, where every edge is
+ * stored in both directions, g can be passed for g_t.
+ *
+ * Complexity: O(V + E)
+ *
+ * Pre-conditions:
+ *  - 0 <= source < num_vertices(g) for each source
+ *  - predecessors has been initialized with init_shortest_paths().
+ *  - distances has been initialized with init_shortest_paths().
+ *  - num_vertices(g_t) == num_vertices(g) and g_t has an edge (v,u) for each edge (u,v) in g.
+ *
+ * Throws:
+ *  - out_of_range if a source vertex is out of range or a range is smaller than the number of vertices.
+ *
+ * @tparam G            The graph type.
+ * @tparam GT           The transpose graph type.
+ * @tparam Sources      The range of source vertex ids.
+ * @tparam Distances    The distance random access range.
+ * @tparam Predecessors The predecessor random access range.
+ *
+ * @param g           The graph.
+ * @param g_t         The transpose of g, giving the in-edges of each vertex.
+ * @param sources     The source vertex ids.
+ * @param distances   [inout] The number of edges from the nearest source for each vertex. Vertices that
+ *                    aren't reachable are left unchanged.
+ * @param predecessor [inout] The predecessor of each vertex reached, other than the sources.
+ * @param alpha       The top-down to bottom-up switching factor. A value of 0 is taken as 1.
+ * @param beta        The bottom-up to top-down switching factor. A value of 0 is taken as 1.
+ */
+template <index_adjacency_list G,
+          index_adjacency_list GT,
+          input_range          Sources,
+          random_access_range  Distances,
+          random_access_range  Predecessors>
+requires convertible_to<range_value_t<Sources>, vertex_id_t<G>> && //
+         is_arithmetic_v<range_value_t<Distances>> &&              //
+         sized_range<Distances> &&                                 //
+         sized_range<Predecessors> &&                              //
+         convertible_to<vertex_id_t<G>, range_value_t<Predecessors>>
+void breadth_first_search(G&&            g,
+                          GT&&           g_t,
+                          const Sources& sources,
+                          Distances&     distances,
+                          Predecessors&  predecessor,
+                          const size_t   alpha = 15,
+                          const size_t   beta  = 18) {
+  _breadth_first_search<true>(g, g_t, sources, distances, predecessor, alpha, beta);
+}
+
+template <index_adjacency_list G,
+          index_adjacency_list GT,
+          random_access_range  Distances,
+          random_access_range  Predecessors>
+requires is_arithmetic_v<range_value_t<Distances>> && //
+         sized_range<Distances> &&                    //
+         sized_range<Predecessors> &&                 //
+         convertible_to<vertex_id_t<G>, range_value_t<Predecessors>>
+void breadth_first_search(G&&            g,
+                          GT&&           g_t,
+                          vertex_id_t<G> source,
+                          Distances&     distances,
+                          Predecessors&  predecessor,
+                          const size_t   alpha = 15,
+                          const size_t   beta  = 18) {
+  _breadth_first_search<true>(g, g_t, subrange(&source, (&source + 1)), distances, predecessor, alpha, beta);
+}
 
 /**
- * @ingroup graph_algorithms
- * @brief Intializes the distance values to the infinite value.
- * 
- * @param distances The range of distance values to initialize.
-*/
-inline void init_bfs(Distances& distances) {
-  for (size_t i = 0; i < distances.size(); ++i) {
-    distances[i] = bfs_infinite_distance();
+ * @brief Top-down breadth-first search from one or more sources.
+ *
+ * This is used when the in-edges of g aren't available. The frontier of each level is kept in a vector
+ * instead of a FIFO queue.
+ *
+ * Complexity: O(V + E)
+ *
+ * Pre-conditions:
+ *  - 0 <= source < num_vertices(g) for each source
+ *  - predecessors has been initialized with init_shortest_paths().
+ *  - distances has been initialized with init_shortest_paths().
+ *
+ * Throws:
+ *  - out_of_range if a source vertex is out of range or a range is smaller than the number of vertices.
+ *
+ * @tparam G            The graph type.
+ * @tparam Sources      The range of source vertex ids.
+ * @tparam Distances    The distance random access range.
+ * @tparam Predecessors The predecessor random access range.
+ *
+ * @param g           The graph.
+ * @param sources     The source vertex ids.
+ * @param distances   [inout] The number of edges from the nearest source for each vertex. Vertices that
+ *                    aren't reachable are left unchanged.
+ * @param predecessor [inout] The predecessor of each vertex reached, other than the sources.
+ */
+template <index_adjacency_list G,
+          input_range          Sources,
+          random_access_range  Distances,
+          random_access_range  Predecessors>
+requires convertible_to<range_value_t<Sources>, vertex_id_t<G>> && //
+         is_arithmetic_v<range_value_t<Distances>> &&              //
+         sized_range<Distances> &&                                 //
+         sized_range<Predecessors> &&                              //
+         convertible_to<vertex_id_t<G>, range_value_t<Predecessors>>
+void breadth_first_search(G&& g, const Sources& sources, Distances& distances, Predecessors& predecessor) {
+  _breadth_first_search<false>(g, g, sources, distances, predecessor, 0, 0);
+}
+
+template <index_adjacency_list G, random_access_range Distances, random_access_range Predecessors>
+requires is_arithmetic_v<range_value_t<Distances>> && //
+         sized_range<Distances> &&                    //
+         sized_range<Predecessors> &&                 //
+         convertible_to<vertex_id_t<G>, range_value_t<Predecessors>>
+void breadth_first_search(G&& g, vertex_id_t<G> source, Distances& distances, Predecessors& predecessor) {
+  _breadth_first_search<false>(g, g, subrange(&source, (&source + 1)), distances, predecessor, 0, 0);
+}
+
+/**
+ * @brief Parallel level-synchronous breadth-first search from one or more sources.
+ *
+ * The vertices in a level's frontier are expanded by num_threads threads. A vertex is claimed with a
+ * compare-and-swap on its distance, so exactly one thread sets its distance and predecessor and adds
+ * it to its own local frontier buffer. The local buffers are merged into the next frontier at offsets
+ * given by a prefix sum of their sizes.
+ *
+ * When the edge ranges are random access (e.g. compressed_graph), the work for a level is the edges out
+ * of the frontier, handed out to the threads in fixed-size chunks using a prefix sum of the frontier's
+ * degrees. The edges of a high-degree vertex are then split across threads instead of being expanded by
+ * a single thread. Otherwise, chunks of frontier vertices are handed out. Threads that finish early take
+ * the remaining chunks.
+ *
+ * Complexity: O(V + E) work
+ *
+ * Pre-conditions:
+ *  - 0 <= source < num_vertices(g) for each source
+ *  - predecessors has been initialized with init_shortest_paths().
+ *  - distances has been initialized with init_shortest_paths().
+ *
+ * Throws:
+ *  - out_of_range if a source vertex is out of range or a range is smaller than the number of vertices.
+ *
+ * @tparam G            The graph type.
+ * @tparam Sources      The range of source vertex ids.
+ * @tparam Distances    The distance random access range.
+ * @tparam Predecessors The predecessor random access range.
+ *
+ * @param g           The graph.
+ * @param sources     The source vertex ids.
+ * @param distances   [inout] The number of edges from the nearest source for each vertex. Vertices that
+ *                    aren't reachable are left unchanged.
+ * @param predecessor [inout] The predecessor of each vertex reached, other than the sources. When more
+ *                    than one vertex in a level has an edge to a vertex, any of them may be chosen.
+ * @param num_threads The number of threads to use, including the calling thread.
+ */
+template <index_adjacency_list G,
+          input_range          Sources,
+          random_access_range  Distances,
+          random_access_range  Predecessors>
+requires convertible_to<range_value_t<Sources>, vertex_id_t<G>> &&                          //
+         is_arithmetic_v<range_value_t<Distances>> &&                                       //
+         is_same_v<range_reference_t<Distances>, range_value_t<Distances>&> &&              //
+         sized_range<Distances> &&                                                          //
+         sized_range<Predecessors> &&                                                       //
+         convertible_to<vertex_id_t<G>, range_value_t<Predecessors>>
+void parallel_breadth_first_search(G&&            g,
+                                   const Sources& sources,
+                                   Distances&     distances,
+                                   Predecessors&  predecessor,
+                                   size_t         num_threads = hardware_thread_count()) {
+  using id_type       = vertex_id_t<G>;
+  using distance_type = range_value_t<Distances>;
+
+  if (size(distances) < size(vertices(g))) {
+    throw std::out_of_range(
+          std::format("parallel_breadth_first_search: size of distances of {} is less than the number of vertices {}",
+                      size(distances), size(vertices(g))));
+  }
+  if constexpr (!is_same_v<Predecessors, _null_range_type>) {
+    if (size(predecessor) < size(vertices(g))) {
+      throw std::out_of_range(std::format(
+            "parallel_breadth_first_search: size of predecessor of {} is less than the number of vertices {}",
+            size(predecessor), size(vertices(g))));
+    }
   }
+
+  constexpr auto zero        = shortest_path_zero<distance_type>();
+  constexpr auto infinite    = shortest_path_infinite_distance<distance_type>();
+  constexpr bool split_edges = random_access_range<vertex_edge_range_t<G>>;
+
+  const id_type N = static_cast<id_type>(num_vertices(g));
+  num_threads     = std::max(num_threads, size_t(1));
+
+  // Seed the frontier with the source vertice(s)
+  std::vector<id_type> frontier;
+  for (auto&& source : sources) {
+    if (source >= N || source < 0) {
+      throw std::out_of_range(
+            std::format("parallel_breadth_first_search: source vertex id '{}' is out of range", source));
+    }
+    if (distances[static_cast<size_t>(source)] == zero) {
+      continue; // duplicate source
+    }
+    distances[static_cast<size_t>(source)] = zero;
+    frontier.push_back(source);
+  }
+
+  std::vector<id_type>              next;
+  std::vector<size_t>               edge_offsets; // edges out of frontier[0,i) when split_edges; +1 terminating
+  std::vector<std::vector<id_type>> local(num_threads);
+  std::vector<size_t>               thread_offsets(num_threads + 1); // where local[tid] goes in next
+  std::vector<size_t>               thread_edges(num_threads + 1);   // edges out of local[tid] (prefix sum)
+  dynamic_chunks                    work;
+  distance_type                     level = zero;
+  bool                              done  = frontier.empty();
+
+  auto reset_work = [&]() {
+    if constexpr (split_edges) {
+      const size_t total = edge_offsets.back();
+      work.reset(total, std::max(size_t(1024), total / (16 * num_threads)));
+    } else {
+      work.reset(frontier.size(), 64);
+    }
+  };
+
+  if constexpr (split_edges) {
+    edge_offsets.resize(frontier.size() + 1);
+    edge_offsets[0] = 0;
+    for (size_t i = 0; i < frontier.size(); ++i) {
+      edge_offsets[i + 1] = edge_offsets[i] + static_cast<size_t>(size(edges(g, frontier[i])));
+    }
+  }
+  reset_work();
+
+  // The serial work between the phases of a level is done by the barrier's completion function
+  int  phase      = 0;
+  auto completion = [&]() noexcept {
+    if (phase == 0) { // local frontiers are complete: evaluate where they go in the next frontier
+      for (size_t tid = 0; tid < num_threads; ++tid) {
+        thread_offsets[tid + 1] = thread_offsets[tid] + local[tid].size();
+      }
+      next.resize(thread_offsets[num_threads]);
+      if constexpr (split_edges) {
+        edge_offsets.resize(next.size() + 1);
+      }
+    } else if (phase == 1) { // next frontier is complete: prepare for the next level
+      frontier.swap(next);
+      if constexpr (split_edges) {
+        for (size_t tid = 0; tid < num_threads; ++tid) {
+          thread_edges[tid + 1] += thread_edges[tid]; // inclusive scan of edges out of each local frontier
+        }
+        edge_offsets.back() = thread_edges[num_threads];
+      }
+      ++level;
+      done = frontier.empty();
+    } else { // edge offsets are complete
+      reset_work();
+    }
+    phase = (phase + 1) % 3;
+  };
+  std::barrier sync(static_cast<std::ptrdiff_t>(num_threads), completion);
+
+  auto visit = [&g, &distances, &predecessor](id_type uid, auto&& uv, distance_type next_level,
+                                               std::vector<id_type>& discovered) {
+    const id_type                  vid = target_id(g, uv);
+    std::atomic_ref<distance_type> vdist(distances[static_cast<size_t>(vid)]);
+    distance_type                  expected = infinite;
+    if (vdist.load(std::memory_order_relaxed) == infinite &&
+        vdist.compare_exchange_strong(expected, next_level, std::memory_order_relaxed)) {
+      if constexpr (!is_same_v<Predecessors, _null_range_type>) {
+        predecessor[static_cast<size_t>(vid)] = uid;
+      }
+      discovered.push_back(vid);
+    }
+  };
+
+  parallel_invoke(num_threads, [&](size_t tid) {
+    std::vector<id_type>& discovered = local[tid];
+    while (!done) {
+      // Expand the frontier into the thread's local frontier
+      const distance_type next_level = level + 1;
+      if constexpr (split_edges) {
+        work.for_each([&](size_t first, size_t last) {
+          // frontier[i] is the vertex with edge (first - edge_offsets[i]) at the start of the chunk
+          size_t i = static_cast<size_t>(std::upper_bound(edge_offsets.begin(), edge_offsets.end(), first) -
+                                         edge_offsets.begin()) -
+                     1;
+          for (size_t e = first; e < last; ++i) {
+            const id_type uid  = frontier[i];
+            auto&&        uvs  = edges(g, uid);
+            auto          it   = begin(uvs) + static_cast<std::ptrdiff_t>(e - edge_offsets[i]);
+            const size_t  stop = std::min(last, edge_offsets[i + 1]);
+            for (; e < stop; ++e, ++it) {
+              visit(uid, *it, next_level, discovered);
+            }
+          }
+        });
+      } else {
+        work.for_each([&](size_t first, size_t last) {
+          for (size_t i = first; i < last; ++i) {
+            const id_type uid = frontier[i];
+            for (auto&& uv : edges(g, uid)) {
+              visit(uid, uv, next_level, discovered);
+            }
+          }
+        });
+      }
+      sync.arrive_and_wait();
+
+      // Merge the local frontiers into the next frontier
+      const size_t offset = thread_offsets[tid];
+      std::ranges::copy(discovered, next.begin() + static_cast<std::ptrdiff_t>(offset));
+      if constexpr (split_edges) {
+        size_t edge_count = 0;
+        for (size_t i = 0; i < discovered.size(); ++i) {
+          edge_offsets[offset + i] = edge_count; // relative to this thread's first edge, adjusted below
+          edge_count += static_cast<size_t>(size(edges(g, discovered[i])));
+        }
+        thread_edges[tid + 1] = edge_count;
+      }
+      const size_t count = discovered.size();
+      discovered.clear();
+      sync.arrive_and_wait();
+
+      if constexpr (split_edges) {
+        for (size_t i = offset; i < offset + count; ++i) {
+          edge_offsets[i] += thread_edges[tid];
+        }
+      }
+      sync.arrive_and_wait();
+    }
+  });
+}
+
+template <index_adjacency_list G, random_access_range Distances, random_access_range Predecessors>
+requires is_arithmetic_v<range_value_t<Distances>> &&                          //
+         is_same_v<range_reference_t<Distances>, range_value_t<Distances>&> && //
+         sized_range<Distances> &&                                             //
+         sized_range<Predecessors> &&                                          //
+         convertible_to<vertex_id_t<G>, range_value_t<Predecessors>>
+void parallel_breadth_first_search(G&&            g,
+                                   vertex_id_t<G> source,
+                                   Distances&     distances,
+                                   Predecessors&  predecessor,
+                                   size_t         num_threads = hardware_thread_count()) {
+  parallel_breadth_first_search(g, subrange(&source, (&source + 1)), distances, predecessor, num_threads);
 }
 
 /**
- * @ingroup graph_algorithms
- * @brief Intializes the distance and predecessor values for bfs.
- * 
- * @param distances The range of distance values to initialize. Each value will be assigned the infinite distance.
- * @param predecessors The range of predecessors to initialize. Each value will be assigned the vertex id.
+ * @brief Implementation of the batched breadth-first searches used by the public functions.
+ *
+ * Up to BatchSize independent searches are run at once, one per bit (lane) of BatchSize/64 words kept for
+ * each vertex. seen holds the lanes that have reached a vertex and visit the lanes for which the vertex is
+ * in the frontier. When a vertex's edges are scanned, all of its lanes in the frontier are propagated to the
+ * target with a single OR, so the scan is shared by all the searches in the batch. on_reach(i, vid, level)
+ * is called when the search from sources[i] first reaches vid, including the sources themselves at level 0.
 */
-inline void init_bfs(Distances& distances, Predecessors& predecessors) {
-  init_bfs(distances);
-  for (size_t i = 0; i < predecessors.size(); ++i) {
-    predecessors[i] = static_cast<range_value_t<Predecessors>>(i);
+template <size_t BatchSize, index_adjacency_list G, class OnReach>
+void _batched_breadth_first_search(G&&                                g,
+                                   const std::vector<vertex_id_t<G>>& sources,
+                                   const size_t                       max_hops,
+                                   OnReach&&                          on_reach) {
+  static_assert(BatchSize > 0 && BatchSize % 64 == 0, "BatchSize must be a multiple of 64");
+  using id_type                    = vertex_id_t<G>;
+  using word_type                  = uint64_t;
+  constexpr size_t bits_per_word   = std::numeric_limits<word_type>::digits;
+  constexpr size_t words_per_batch = BatchSize / bits_per_word;
+
+  const size_t N = static_cast<size_t>(num_vertices(g));
+  for (auto&& source : sources) {
+    if (static_cast<size_t>(source) >= N || source < 0) {
+      throw std::out_of_range(
+            std::format("batched_breadth_first_search: source vertex id '{}' is out of range", source));
+    }
+  }
+
+  // The lanes of vertex vid are in words [vid * words_per_batch, (vid + 1) * words_per_batch)
+  std::vector<word_type> seen(N * words_per_batch);
+  std::vector<word_type> visit(N * words_per_batch);
+  std::vector<word_type> next(N * words_per_batch);
+  std::vector<id_type>   frontier;
+  std::vector<id_type>   touched; // vertices with lanes in next
+
+  for (size_t first = 0; first < sources.size(); first += BatchSize) {
+    const size_t count = std::min(BatchSize, sources.size() - first);
+    std::ranges::fill(seen, word_type(0));
+    frontier.clear();
+
+    for (size_t lane = 0; lane < count; ++lane) {
+      const id_type source = sources[first + lane];
+      word_type*    vis    = &visit[static_cast<size_t>(source) * words_per_batch];
+      if (std::ranges::all_of(vis, vis + words_per_batch, [](word_type w) { return w == 0; })) {
+        frontier.push_back(source);
+      }
+      const word_type bit = word_type(1) << (lane % bits_per_word);
+      vis[lane / bits_per_word] |= bit;
+      seen[static_cast<size_t>(source) * words_per_batch + lane / bits_per_word] |= bit;
+      on_reach(first + lane, source, size_t(0));
+    }
+
+    for (size_t level = 1; !frontier.empty(); ++level) {
+      if (level > max_hops) {
+        for (id_type uid : frontier) {
+          std::fill_n(&visit[static_cast<size_t>(uid) * words_per_batch], words_per_batch, word_type(0));
+        }
+        break;
+      }
+
+      // Propagate the frontier lanes of each vertex along its edges
+      touched.clear();
+      for (id_type uid : frontier) {
+        word_type* vis = &visit[static_cast<size_t>(uid) * words_per_batch];
+        for (auto&& uv : edges(g, uid)) {
+          word_type* nxt = &next[static_cast<size_t>(target_id(g, uv)) * words_per_batch];
+          word_type  was = 0;
+          for (size_t w = 0; w < words_per_batch; ++w) {
+            was |= nxt[w];
+            nxt[w] |= vis[w];
+          }
+          if (was == 0) {
+            touched.push_back(target_id(g, uv));
+          }
+        }
+        std::fill_n(vis, words_per_batch, word_type(0));
+      }
+
+      // Lanes that haven't reached a vertex before are in the next frontier
+      frontier.clear();
+      for (id_type vid : touched) {
+        const size_t offset = static_cast<size_t>(vid) * words_per_batch;
+        word_type    any    = 0;
+        for (size_t w = 0; w < words_per_batch; ++w) {
+          const word_type bits = next[offset + w] & ~seen[offset + w];
+          next[offset + w]     = 0;
+          seen[offset + w] |= bits;
+          visit[offset + w] = bits;
+          any |= bits;
+          for (word_type b = bits; b != 0; b &= b - 1) {
+            on_reach(first + w * bits_per_word + static_cast<size_t>(std::countr_zero(b)), vid, level);
+          }
+        }
+        if (any != 0) {
+          frontier.push_back(vid);
+        }
+      }
+    }
   }
 }
 
 /**
- * @brief Single-source breadth-first search.
- * 
- * @param g            The graph.
- * @param source	   The source vertex.
- * @param predecessors The predecessor vertex for g[uid].
+ * @brief Runs an independent breadth-first search from each source, BatchSize of them at a time, sharing
+ * each scan of a vertex's edges across the searches in a batch (MS-BFS).
+ *
+ * This is useful when many searches are run on the same graph, such as for closeness estimates or k-hop
+ * queries for a set of seeds. The searches in a batch are represented by the bits of BatchSize/64 words
+ * per vertex, so larger batches share more of the work at the cost of (3 * BatchSize / 8) bytes per vertex.
+ *
+ * Complexity: O((S/BatchSize) * (V + E) * BatchSize/64 + S*V) for S sources
+ *
+ * Pre-conditions:
+ *  - 0 <= source < num_vertices(g) for each source
+ *  - Each distances[i] has been initialized with init_shortest_paths().
+ *
+ * Throws:
+ *  - out_of_range if a source vertex is out of range, there are fewer distance ranges than sources or a
+ *    distance range is smaller than the number of vertices.
+ *
+ * @tparam BatchSize The number of searches run at once. It must be a multiple of 64.
+ * @tparam G         The graph type.
+ * @tparam Sources   The range of source vertex ids.
+ * @tparam Distances A random access range of distance random access ranges, one per source.
+ *
+ * @param g         The graph.
+ * @param sources   The source vertex ids. A source may appear more than once.
+ * @param distances [inout] distances[i][vid] is the number of edges from sources[i] to vid. Vertices that
+ *                  aren't reached are left unchanged.
+ * @param max_hops  The maximum number of edges from a source. Vertices further away aren't reached.
  */
+template <size_t BatchSize = 64, index_adjacency_list G, forward_range Sources, random_access_range Distances>
+requires convertible_to<range_value_t<Sources>, vertex_id_t<G>> && //
+         random_access_range<range_value_t<Distances>> &&           //
+         is_arithmetic_v<range_value_t<range_value_t<Distances>>>
+void batched_breadth_first_distances(G&&            g,
+                                     const Sources& sources,
+                                     Distances&     distances,
+                                     const size_t   max_hops = std::numeric_limits<size_t>::max()) {
+  using distance_type = range_value_t<range_value_t<Distances>>;
+
+  std::vector<vertex_id_t<G>> source_ids;
+  for (auto&& source : sources) {
+    source_ids.push_back(static_cast<vertex_id_t<G>>(source));
+  }
+  if (size(distances) < source_ids.size()) {
+    throw std::out_of_range(
+          std::format("batched_breadth_first_distances: size of distances of {} is less than the number of sources {}",
+                      size(distances), source_ids.size()));
+  }
+  for (size_t i = 0; i < source_ids.size(); ++i) {
+    if (size(distances[i]) < size(vertices(g))) {
+      throw std::out_of_range(std::format(
+            "batched_breadth_first_distances: size of distances[{}] of {} is less than the number of vertices {}", i,
+            size(distances[i]), size(vertices(g))));
+    }
+  }
 
-// C++
-inline void
-breadth_first_search(const Graph& g, const Source& source, Distances& distances, Predecessors& predecessors) {}
+  _batched_breadth_first_search<BatchSize>(g, source_ids, max_hops, [&distances](size_t i, auto vid, size_t level) {
+    distances[i][static_cast<size_t>(vid)] = static_cast<distance_type>(level);
+  });
+}
 
-// C
-inline void breadth_first_search(const Graph*  g,
-                                 const Source  source,
-                                 const size_t  distances_len,
-                                 Distances*    distances,
-                                 const size_t  predecessors_len,
-                                 Predecessors* predecessors) {}
+/**
+ * @brief Counts the vertices reached by an independent breadth-first search from each source, BatchSize of
+ * them at a time, sharing each scan of a vertex's edges across the searches in a batch (MS-BFS).
+ *
+ * This is the same as batched_breadth_first_distances(), without the memory for a distance per vertex for
+ * each source. With max_hops = k it gives the size of the k-hop neighborhood of each source.
+ *
+ * Complexity: O((S/BatchSize) * (V + E) * BatchSize/64 + S*V) for S sources
+ *
+ * Pre-conditions:
+ *  - 0 <= source < num_vertices(g) for each source
+ *
+ * Throws:
+ *  - out_of_range if a source vertex is out of range or there are fewer counts than sources.
+ *
+ * @tparam BatchSize The number of searches run at once. It must be a multiple of 64.
+ * @tparam G         The graph type.
+ * @tparam Sources   The range of source vertex ids.
+ * @tparam Counts    The count random access range.
+ *
+ * @param g         The graph.
+ * @param sources   The source vertex ids. A source may appear more than once.
+ * @param counts    [out] counts[i] is the number of vertices reached from sources[i], including itself.
+ * @param max_hops  The maximum number of edges from a source. Vertices further away aren't counted.
+ */
+template <size_t BatchSize = 64, index_adjacency_list G, forward_range Sources, random_access_range Counts>
+requires convertible_to<range_value_t<Sources>, vertex_id_t<G>> && is_arithmetic_v<range_value_t<Counts>>
+void batched_breadth_first_reach_counts(G&&            g,
+                                        const Sources& sources,
+                                        Counts&        counts,
+                                        const size_t   max_hops = std::numeric_limits<size_t>::max()) {
+  std::vector<vertex_id_t<G>> source_ids;
+  for (auto&& source : sources) {
+    source_ids.push_back(static_cast<vertex_id_t<G>>(source));
+  }
+  if (size(counts) < source_ids.size()) {
+    throw std::out_of_range(
+          std::format("batched_breadth_first_reach_counts: size of counts of {} is less than the number of sources {}",
+                      size(counts), source_ids.size()));
+  }
 
+  for (size_t i = 0; i < source_ids.size(); ++i) {
+    counts[i] = 0;
+  }
+  _batched_breadth_first_search<BatchSize>(g, source_ids, max_hops,
+                                           [&counts](size_t i, auto, size_t) { counts[i] += 1; });
+}
 
 } // namespace graph
 
@@ -75,6 +75,44 @@ constexpr void init_shortest_paths(Distances& distances, Predecessors& predecess
   iota(predecessors.begin(), predecessors.end(), 0);
 }
 
+/**
+ * @ingroup graph_algorithms
+ * @brief Edge weight function that returns 1 for every edge.
+ * 
+ * This is the default weight function for the shortest paths algorithms. Because it is a distinct type
+ * the algorithms can detect it at compile time and evaluate the hop count with a breadth-first search,
+ * using a FIFO queue instead of a priority queue or repeated passes over all edges. Unlike a default of
+ * function<DistanceValue(edge_reference_t<G>)>, there is no indirect call for each edge.
+ * 
+ * @tparam DistanceValue The type of the weight returned, typically the distance type.
+*/
+template <class DistanceValue>
+struct unit_edge_weight {
+  template <class E>
+  constexpr DistanceValue operator()(E&&) const noexcept {
+    return DistanceValue(1);
+  }
+};
+
+template <class WF>
+struct is_unit_edge_weight : public false_type {};
+template <class DistanceValue>
+struct is_unit_edge_weight<unit_edge_weight<DistanceValue>> : public true_type {};
+
+template <class WF>
+inline constexpr bool is_unit_edge_weight_v = is_unit_edge_weight<remove_cvref_t<WF>>::value;
+
+/**
+ * @brief True when a shortest paths search can be evaluated as a breadth-first search.
+ * 
+ * This requires unit_edge_weight for the weight function, with the default compare and combine
+ * functions so that distances are hop counts.
+*/
+template <class WF, class DistanceValue, class Compare, class Combine> // For exposition only
+concept _unit_weight_search = is_unit_edge_weight_v<WF> &&                              //
+                              is_same_v<remove_cvref_t<Compare>, less<DistanceValue>> && //
+                              is_same_v<remove_cvref_t<Combine>, plus<DistanceValue>>;
+
 //
 // Visitor concepts and classes
 //
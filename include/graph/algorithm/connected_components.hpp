@@ -19,9 +19,14 @@
 #include "graph/views/vertexlist.hpp"
 #include "graph/views/depth_first_search.hpp"
 #include "graph/views/breadth_first_search.hpp"
+#include "graph/detail/parallel.hpp"
+#include "graph/detail/concurrent_union_find.hpp"
 #include <stack>
 #include <random>
 #include <numeric>
+#include <algorithm>
+#include <atomic>
+#include <bit>
 
 #ifndef GRAPH_CC_HPP
 #  define GRAPH_CC_HPP
@@ -87,6 +92,108 @@ void kosaraju(G&&        g,        // graph
   }
 }
 
+/**
+ * @brief Implementation of Tarjan's algorithm used by tarjan_scc() and forward_backward_scc().
+ *
+ * Only vertices for which is_active(uid) is true are visited. on_component(first, last) is called with
+ * the vertex ids of each strongly connected component found, in reverse topological order.
+*/
+template <adjacency_list G, class IsActive, class OnComponent>
+requires random_access_range<vertex_range_t<G>> && integral<vertex_id_t<G>>
+void _tarjan_scc(G&& g, IsActive&& is_active, OnComponent&& on_component) {
+  using id_type       = vertex_id_t<G>;
+  using edge_iterator = iterator_t<vertex_edge_range_t<G>>;
+  constexpr size_t unvisited = std::numeric_limits<size_t>::max();
+
+  size_t                                         N(size(vertices(g)));
+  std::vector<size_t>                            index(N, unvisited);
+  std::vector<size_t>                            low(N);
+  std::vector<bool>                              on_stack(N, false);
+  std::vector<id_type>                           S;      // vertices not yet assigned to a component
+  std::vector<std::pair<id_type, edge_iterator>> active; // depth-first search path, with the next edge of each
+  size_t                                         counter = 0;
+
+  auto discover = [&](id_type uid) {
+    index[static_cast<size_t>(uid)] = low[static_cast<size_t>(uid)] = counter++;
+    on_stack[static_cast<size_t>(uid)]                              = true;
+    S.push_back(uid);
+    active.emplace_back(uid, begin(edges(g, uid)));
+  };
+
+  for (id_type sid = 0; sid < static_cast<id_type>(N); ++sid) {
+    if (index[static_cast<size_t>(sid)] != unvisited || !is_active(sid)) {
+      continue;
+    }
+    discover(sid);
+    while (!active.empty()) {
+      auto& [uid, it] = active.back();
+      if (it != end(edges(g, uid))) {
+        const id_type vid = static_cast<id_type>(target_id(g, *it));
+        ++it;
+        if (!is_active(vid)) {
+          continue;
+        }
+        if (index[static_cast<size_t>(vid)] == unvisited) {
+          discover(vid); // invalidates uid & it
+        } else if (on_stack[static_cast<size_t>(vid)]) {
+          low[static_cast<size_t>(uid)] = std::min(low[static_cast<size_t>(uid)], index[static_cast<size_t>(vid)]);
+        }
+        continue;
+      }
+
+      // All edges of uid have been visited
+      const id_type finished = uid;
+      active.pop_back();
+      if (low[static_cast<size_t>(finished)] == index[static_cast<size_t>(finished)]) {
+        auto first = std::ranges::find(S.rbegin(), S.rend(), finished).base() - 1;
+        for (auto vit = first; vit != S.end(); ++vit) {
+          on_stack[static_cast<size_t>(*vit)] = false;
+        }
+        on_component(first, S.end());
+        S.erase(first, S.end());
+      }
+      if (!active.empty()) {
+        const id_type parent = active.back().first;
+        low[static_cast<size_t>(parent)] =
+              std::min(low[static_cast<size_t>(parent)], low[static_cast<size_t>(finished)]);
+      }
+    }
+  }
+}
+
+/**
+ * @brief Strongly connected components using an iterative version of Tarjan's algorithm.
+ *
+ * Unlike kosaraju(), the transpose of the graph isn't needed and a single depth-first search is made,
+ * using an explicit stack so deep graphs can't overflow the call stack.
+ *
+ * Complexity: O(V + E)
+ *
+ * @param g         The graph.
+ * @param component [out] The strongly connected component of each vertex, numbered from 0 in reverse
+ *                  topological order of the condensed graph (an edge between components goes from a
+ *                  higher to a lower or equal component number).
+ *
+ * @return The number of strongly connected components.
+*/
+template <adjacency_list G, random_access_range Component>
+requires random_access_range<vertex_range_t<G>> && integral<vertex_id_t<G>>
+size_t tarjan_scc(G&&        g,        // graph
+                  Component& component // out: strongly connected component assignment
+) {
+  using CT   = range_value_t<Component>;
+  size_t cid = 0;
+  _tarjan_scc(
+        g, [](auto) { return true; },
+        [&component, &cid](auto first, auto last) {
+          for (; first != last; ++first) {
+            component[static_cast<size_t>(*first)] = static_cast<CT>(cid);
+          }
+          ++cid;
+        });
+  return cid;
+}
+
 template <adjacency_list      G,
           random_access_range Component>
 requires random_access_range<vertex_range_t<G>> && integral<vertex_id_t<G>>
@@ -161,17 +268,27 @@ static void compress(Component& component) {
 
 template <typename vertex_id_t, random_access_range Component>
 static vertex_id_t sample_frequent_element(Component& component, size_t num_samples = 1024) {
-  std::unordered_map<vertex_id_t, int>       counts(32);
+  std::vector<vertex_id_t>                   samples(num_samples);
   std::mt19937                               gen;
   std::uniform_int_distribution<vertex_id_t> distribution(0, component.size() - 1);
 
   for (size_t i = 0; i < num_samples; ++i) {
-    vertex_id_t sample = distribution(gen);
-    counts[component[sample]]++;
+    samples[i] = static_cast<vertex_id_t>(component[static_cast<size_t>(distribution(gen))]);
   }
 
-  auto&& [num, count] = *std::max_element(counts.begin(), counts.end(),
-                                          [](auto&& a, auto&& b) { return std::get<1>(a) < std::get<1>(b); });
+  // The most frequent component is the longest run of equal samples
+  std::ranges::sort(samples);
+  vertex_id_t num   = samples.empty() ? vertex_id_t() : samples[0];
+  size_t      count = 0;
+  for (size_t first = 0, last = 0; first < samples.size(); first = last) {
+    while (last < samples.size() && samples[last] == samples[first]) {
+      ++last;
+    }
+    if (last - first > count) {
+      num   = samples[first];
+      count = last - first;
+    }
+  }
   return num;
 }
 
@@ -257,6 +374,621 @@ void afforest(G&&          g,         // graph
   compress(component);
 }
 
+template <random_access_range Component>
+static void parallel_compress(Component& component, const size_t num_threads) {
+  using CT  = range_value_t<Component>;
+  auto load = [&component](CT i) {
+    return std::atomic_ref<CT>(component[static_cast<size_t>(i)]).load(std::memory_order_relaxed);
+  };
+
+  parallel_for(component.size(), num_threads, 4096, [&](size_t first, size_t last, size_t) {
+    for (size_t i = first; i < last; ++i) {
+      CT c  = load(static_cast<CT>(i));
+      CT cc = load(c);
+      while (c != cc) {
+        c  = cc;
+        cc = load(c);
+      }
+      std::atomic_ref<CT>(component[i]).store(c, std::memory_order_relaxed);
+    }
+  });
+}
+
+template <bool HasTranspose, adjacency_list G, adjacency_list GT, random_access_range Component>
+void _parallel_afforest(G&&          g,
+                        GT&&         g_t,
+                        Component&   component,
+                        const size_t neighbor_rounds,
+                        const size_t num_threads) {
+  using CT = range_value_t<Component>;
+  size_t N(size(vertices(g)));
+  if (N == 0) {
+    return;
+  }
+  parallel_for(N, num_threads, 4096, [&component](size_t first, size_t last, size_t) {
+    std::iota(component.begin() + static_cast<std::ptrdiff_t>(first),
+              component.begin() + static_cast<std::ptrdiff_t>(last), static_cast<CT>(first));
+  });
+
+  // Link each vertex to its r-th neighbor only, approximating the components from a sparse subgraph
+  for (size_t r = 0; r < neighbor_rounds; ++r) {
+    parallel_for(N, num_threads, 1024, [&](size_t first, size_t last, size_t) {
+      for (size_t i = first; i < last; ++i) {
+        vertex_id_t<G> uid = static_cast<vertex_id_t<G>>(i);
+        if (r < size(edges(g, uid))) {
+          auto it = edges(g, uid).begin();
+          std::advance(it, r);
+          concurrent_union_find(component, static_cast<CT>(uid), static_cast<CT>(target_id(g, *it)));
+        }
+      }
+    });
+    parallel_compress(component, num_threads);
+  }
+
+  // The remaining edges of vertices in the largest intermediate component can be skipped
+  const CT c = static_cast<CT>(sample_frequent_element<vertex_id_t<G>>(component));
+
+  parallel_for(N, num_threads, 256, [&](size_t first, size_t last, size_t) {
+    for (size_t i = first; i < last; ++i) {
+      vertex_id_t<G> uid = static_cast<vertex_id_t<G>>(i);
+      if (std::atomic_ref<CT>(component[i]).load(std::memory_order_relaxed) == c) {
+        continue;
+      }
+      if (neighbor_rounds < size(edges(g, uid))) {
+        auto it = edges(g, uid).begin();
+        std::advance(it, neighbor_rounds);
+        for (; it != edges(g, uid).end(); ++it) {
+          concurrent_union_find(component, static_cast<CT>(uid), static_cast<CT>(target_id(g, *it)));
+        }
+      }
+      if constexpr (HasTranspose) {
+        for (auto&& uv : edges(g_t, uid)) {
+          concurrent_union_find(component, static_cast<CT>(uid), static_cast<CT>(target_id(g_t, uv)));
+        }
+      }
+    }
+  });
+
+  parallel_compress(component, num_threads);
+}
+
+/**
+ * @brief Multi-threaded Afforest connected components.
+ *
+ * This is afforest() with the vertices of each phase divided among num_threads threads. The component
+ * trees are linked with a compare-and-swap on the root being linked, so concurrent links can't lose an
+ * update, and each vertex is compressed to its root independently.
+ *
+ * The component assigned to each vertex is the smallest vertex id in its component.
+ *
+ * @param g               The graph. For a directed graph, use the overload with a transpose to get the
+ *                        weakly connected components.
+ * @param component       [out] The component of each vertex.
+ * @param neighbor_rounds The number of neighbors of each vertex linked before sampling.
+ * @param num_threads     The number of threads to use, including the calling thread.
+*/
+template <adjacency_list G, random_access_range Component>
+requires random_access_range<vertex_range_t<G>> && integral<vertex_id_t<G>> &&
+         std::convertible_to<range_value_t<Component>, vertex_id_t<G>> &&
+         std::convertible_to<vertex_id_t<G>, range_value_t<Component>> && integral<range_value_t<Component>> &&
+         is_same_v<range_reference_t<Component>, range_value_t<Component>&>
+void parallel_afforest(G&&          g,         // graph
+                       Component&   component, // out: connected component assignment
+                       const size_t neighbor_rounds = 2,
+                       const size_t num_threads     = hardware_thread_count()) {
+  _parallel_afforest<false>(g, g, component, neighbor_rounds, num_threads);
+}
+
+/**
+ * @brief Multi-threaded Afforest weakly connected components of a directed graph, using its transpose
+ * for the in-edges of each vertex.
+*/
+template <adjacency_list G, adjacency_list GT, random_access_range Component>
+requires random_access_range<vertex_range_t<G>> && integral<vertex_id_t<G>> &&
+         std::convertible_to<range_value_t<Component>, vertex_id_t<G>> &&
+         std::convertible_to<vertex_id_t<G>, range_value_t<Component>> && integral<range_value_t<Component>> &&
+         is_same_v<range_reference_t<Component>, range_value_t<Component>&>
+void parallel_afforest(G&&          g,         // graph
+                       GT&&         g_t,       // graph transpose
+                       Component&   component, // out: connected component assignment
+                       const size_t neighbor_rounds = 2,
+                       const size_t num_threads     = hardware_thread_count()) {
+  _parallel_afforest<true>(g, g_t, component, neighbor_rounds, num_threads);
+}
+
+/**
+ * @brief Multi-threaded hook-and-compress connected components, using the FastSV variant of the
+ * Shiloach-Vishkin algorithm.
+ *
+ * Each vertex has a parent, starting with itself. On each iteration, for every edge (u,v) the trees of
+ * u and v are hooked to the smaller of their grandparents (stochastic and aggressive hooking) and every
+ * vertex is shortcut to its grandparent, until no grandparent changes. Each edge is hooked in both
+ * directions, so the components of a directed graph are its weakly connected components.
+ *
+ * The number of iterations is O(log V), independent of the diameter of the graph, which makes this a good
+ * choice for high-diameter graphs such as road networks.
+ *
+ * Complexity: O((V + E) log V) work
+ *
+ * @param g           The graph.
+ * @param component   [out] The component of each vertex, the smallest vertex id in its component.
+ * @param num_threads The number of threads to use, including the calling thread.
+*/
+template <adjacency_list G, random_access_range Component>
+requires random_access_range<vertex_range_t<G>> && integral<vertex_id_t<G>> &&
+         std::convertible_to<range_value_t<Component>, vertex_id_t<G>> &&
+         std::convertible_to<vertex_id_t<G>, range_value_t<Component>> && integral<range_value_t<Component>> &&
+         is_same_v<range_reference_t<Component>, range_value_t<Component>&>
+void shiloach_vishkin(G&&          g,         // graph
+                      Component&   component, // out: connected component assignment
+                      const size_t num_threads = hardware_thread_count()) {
+  using CT = range_value_t<Component>;
+  size_t N(size(vertices(g)));
+
+  // component is the parent of each vertex
+  std::vector<CT> grandparent(N);
+  parallel_for(N, num_threads, 4096, [&](size_t first, size_t last, size_t) {
+    for (size_t i = first; i < last; ++i) {
+      component[i]   = static_cast<CT>(i);
+      grandparent[i] = static_cast<CT>(i);
+    }
+  });
+  auto parent = [&component](CT i) {
+    return std::atomic_ref<CT>(component[static_cast<size_t>(i)]).load(std::memory_order_relaxed);
+  };
+
+  for (bool changed = true; changed;) {
+    // Hooking: grandparent isn't changed, parents are only lowered
+    parallel_for(N, num_threads, 1024, [&](size_t first, size_t last, size_t) {
+      for (size_t i = first; i < last; ++i) {
+        const CT uid = static_cast<CT>(i);
+        for (auto&& uv : edges(g, static_cast<vertex_id_t<G>>(i))) {
+          const CT vid = static_cast<CT>(target_id(g, uv));
+          const size_t u = static_cast<size_t>(uid), v = static_cast<size_t>(vid);
+          atomic_fetch_min(component[static_cast<size_t>(parent(uid))], grandparent[v]); // stochastic hooking
+          atomic_fetch_min(component[static_cast<size_t>(parent(vid))], grandparent[u]);
+          atomic_fetch_min(component[u], grandparent[v]); // aggressive hooking
+          atomic_fetch_min(component[v], grandparent[u]);
+        }
+      }
+    });
+
+    // Shortcutting
+    parallel_for(N, num_threads, 4096, [&](size_t first, size_t last, size_t) {
+      for (size_t i = first; i < last; ++i) {
+        atomic_fetch_min(component[i], grandparent[i]);
+      }
+    });
+
+    // Update the grandparents, stopping when none change
+    std::vector<char> thread_changed(std::max(num_threads, size_t(1)), false);
+    parallel_for(N, num_threads, 4096, [&](size_t first, size_t last, size_t tid) {
+      for (size_t i = first; i < last; ++i) {
+        const CT gp = component[static_cast<size_t>(component[i])];
+        if (gp != grandparent[i]) {
+          grandparent[i]      = gp;
+          thread_changed[tid] = true;
+        }
+      }
+    });
+    changed = std::ranges::any_of(thread_changed, [](char c) { return c != 0; });
+  }
+}
+
+/**
+ * @brief Multi-threaded frontier-based label propagation connected components of an undirected graph.
+ *
+ * Each vertex starts with its own id as its label. Vertices whose label was lowered in the last round
+ * push it to their neighbors with an atomic min, and the neighbors that are lowered make up the frontier
+ * of the next round. The number of rounds is at most the diameter of the graph plus one, so this is a
+ * good choice for low-diameter graphs such as social networks, and a poor one for road networks.
+ *
+ * Complexity: O((V + E) * D) work in the worst case for a graph with diameter D
+ *
+ * @param g           The graph. Each edge must be in both directions.
+ * @param component   [out] The component of each vertex, the smallest vertex id in its component.
+ * @param num_threads The number of threads to use, including the calling thread.
+*/
+template <adjacency_list G, random_access_range Component>
+requires random_access_range<vertex_range_t<G>> && integral<vertex_id_t<G>> &&
+         std::convertible_to<range_value_t<Component>, vertex_id_t<G>> &&
+         std::convertible_to<vertex_id_t<G>, range_value_t<Component>> && integral<range_value_t<Component>> &&
+         is_same_v<range_reference_t<Component>, range_value_t<Component>&>
+void label_propagation_components(G&&          g,         // graph
+                                  Component&   component, // out: connected component assignment
+                                  const size_t num_threads = hardware_thread_count()) {
+  using CT = range_value_t<Component>;
+  size_t N(size(vertices(g)));
+
+  std::vector<vertex_id_t<G>> frontier(N);
+  std::vector<char>           in_next(N, false);
+  parallel_for(N, num_threads, 4096, [&](size_t first, size_t last, size_t) {
+    for (size_t i = first; i < last; ++i) {
+      component[i] = static_cast<CT>(i);
+      frontier[i]  = static_cast<vertex_id_t<G>>(i);
+    }
+  });
+
+  std::vector<std::vector<vertex_id_t<G>>> local(std::max(num_threads, size_t(1)));
+  while (!frontier.empty()) {
+    parallel_for(frontier.size(), num_threads, 256, [&](size_t first, size_t last, size_t tid) {
+      for (size_t i = first; i < last; ++i) {
+        const vertex_id_t<G> uid = frontier[i];
+        const CT label = std::atomic_ref<CT>(component[static_cast<size_t>(uid)]).load(std::memory_order_relaxed);
+        for (auto&& uv : edges(g, uid)) {
+          const vertex_id_t<G> vid = target_id(g, uv);
+          if (atomic_fetch_min(component[static_cast<size_t>(vid)], label) &&
+              !std::atomic_ref<char>(in_next[static_cast<size_t>(vid)]).exchange(true, std::memory_order_relaxed)) {
+            local[tid].push_back(vid);
+          }
+        }
+      }
+    });
+
+    frontier.clear();
+    for (auto& next : local) {
+      for (vertex_id_t<G> vid : next) {
+        in_next[static_cast<size_t>(vid)] = false;
+      }
+      frontier.insert(frontier.end(), next.begin(), next.end());
+      next.clear();
+    }
+  }
+}
+
+/**
+ * @brief The connected components algorithms that auto_connected_components() selects from.
+*/
+enum class cc_algorithm {
+  depth_first,      // connected_components()
+  afforest,         // parallel_afforest()
+  shiloach_vishkin, // shiloach_vishkin()
+  label_propagation // label_propagation_components()
+};
+
+/**
+ * @brief Selects the connected components algorithm expected to be fastest for an undirected graph, from
+ * estimates of its degree distribution and diameter.
+ *
+ *  - With a single thread, the sequential connected_components() does the least work.
+ *  - When the maximum degree is much larger than the average, there is usually a giant component whose
+ *    edges afforest skips after sampling.
+ *  - Otherwise a breadth-first search from the highest degree vertex, stopped after examining a fraction
+ *    of the edges, estimates the diameter. Label propagation is used when it's within O(log V), and
+ *    Shiloach-Vishkin, whose number of iterations doesn't depend on the diameter, otherwise.
+ *
+ * Complexity: O(V + E)
+ *
+ * @param g           The graph.
+ * @param num_threads The number of threads that will be used.
+ *
+ * @return The algorithm selected.
+*/
+template <adjacency_list G>
+requires random_access_range<vertex_range_t<G>> && integral<vertex_id_t<G>>
+cc_algorithm select_connected_components(G&& g, const size_t num_threads = hardware_thread_count()) {
+  using id_type = vertex_id_t<G>;
+  size_t N(size(vertices(g)));
+  if (N == 0 || num_threads <= 1) {
+    return cc_algorithm::depth_first;
+  }
+
+  size_t  num_edges  = 0;
+  size_t  max_degree = 0;
+  id_type hub        = 0;
+  for (id_type uid = 0; static_cast<size_t>(uid) < N; ++uid) {
+    const size_t deg = static_cast<size_t>(std::ranges::distance(edges(g, uid)));
+    num_edges += deg;
+    if (deg > max_degree) {
+      max_degree = deg;
+      hub        = uid;
+    }
+  }
+  const double avg_degree = static_cast<double>(num_edges) / static_cast<double>(N);
+  if (static_cast<double>(max_degree) > 32.0 * std::max(avg_degree, 1.0)) {
+    return cc_algorithm::afforest;
+  }
+
+  // Levels reached by a BFS from the hub before it examines its budget of edges or finishes
+  const size_t         max_depth   = 2 * std::bit_width(N);
+  size_t               edge_budget = std::max(num_edges / 8, size_t(1024));
+  size_t               depth       = 0;
+  std::vector<char>    visited(N, false);
+  std::vector<id_type> frontier{hub}, next;
+  visited[static_cast<size_t>(hub)] = true;
+  while (!frontier.empty() && edge_budget > 0 && depth <= max_depth) {
+    for (id_type uid : frontier) {
+      for (auto&& uv : edges(g, uid)) {
+        const id_type vid = target_id(g, uv);
+        if (!visited[static_cast<size_t>(vid)]) {
+          visited[static_cast<size_t>(vid)] = true;
+          next.push_back(vid);
+        }
+        edge_budget -= (edge_budget > 0);
+      }
+    }
+    frontier.swap(next);
+    next.clear();
+    ++depth;
+  }
+
+  return depth <= max_depth ? cc_algorithm::label_propagation : cc_algorithm::shiloach_vishkin;
+}
+
+/**
+ * @brief Connected components of an undirected graph, using the algorithm from
+ * select_connected_components().
+ *
+ * Vertices in the same component are assigned the same component id. The ids are the smallest vertex
+ * id in each component, except for cc_algorithm::depth_first where they are numbered from 0.
+ *
+ * @param g           The graph.
+ * @param component   [out] The component of each vertex.
+ * @param num_threads The number of threads to use, including the calling thread.
+ *
+ * @return The algorithm used.
+*/
+template <adjacency_list G, random_access_range Component>
+requires random_access_range<vertex_range_t<G>> && integral<vertex_id_t<G>> &&
+         std::convertible_to<range_value_t<Component>, vertex_id_t<G>> &&
+         std::convertible_to<vertex_id_t<G>, range_value_t<Component>> && integral<range_value_t<Component>> &&
+         is_same_v<range_reference_t<Component>, range_value_t<Component>&>
+cc_algorithm auto_connected_components(G&&          g,         // graph
+                                       Component&   component, // out: connected component assignment
+                                       const size_t num_threads = hardware_thread_count()) {
+  const cc_algorithm algorithm = select_connected_components(g, num_threads);
+  switch (algorithm) {
+  case cc_algorithm::depth_first: connected_components(g, component); break;
+  case cc_algorithm::afforest: parallel_afforest(g, component, 2, num_threads); break;
+  case cc_algorithm::shiloach_vishkin: shiloach_vishkin(g, component, num_threads); break;
+  case cc_algorithm::label_propagation: label_propagation_components(g, component, num_threads); break;
+  }
+  return algorithm;
+}
+
+/**
+ * @brief Marks the vertices reachable from source with a level-synchronous parallel breadth-first
+ * search. claim(vid) returns true the first time it's called for a vertex that can be reached, and false
+ * otherwise, and must be thread-safe.
+*/
+template <adjacency_list G, class Claim>
+void _parallel_reach(G&& g, vertex_id_t<G> source, Claim&& claim, const size_t num_threads) {
+  using id_type = vertex_id_t<G>;
+  if (!claim(source)) {
+    return;
+  }
+  std::vector<id_type>              frontier{source};
+  std::vector<std::vector<id_type>> local(std::max(num_threads, size_t(1)));
+  while (!frontier.empty()) {
+    parallel_for(frontier.size(), num_threads, 64, [&](size_t first, size_t last, size_t tid) {
+      for (size_t i = first; i < last; ++i) {
+        for (auto&& uv : edges(g, frontier[i])) {
+          const id_type vid = static_cast<id_type>(target_id(g, uv));
+          if (claim(vid)) {
+            local[tid].push_back(vid);
+          }
+        }
+      }
+    });
+    frontier.clear();
+    for (auto& next : local) {
+      frontier.insert(frontier.end(), next.begin(), next.end());
+      next.clear();
+    }
+  }
+}
+
+/**
+ * @brief Multi-threaded strongly connected components for large directed graphs, using trimming,
+ * forward-backward search and coloring (the Multistep method).
+ *
+ *  1. Trimming: vertices without in-edges or without out-edges from the remaining vertices are trivial
+ *     components. They're removed repeatedly, which also removes the DAG-like parts of the graph.
+ *  2. Forward-backward: the vertices reached both forward and backward from a pivot, chosen for having
+ *     the most in and out edges, are a component. This finds the giant component of most real graphs
+ *     using two parallel breadth-first searches.
+ *  3. Coloring: each remaining vertex takes the smallest vertex id that reaches it as its color by
+ *     parallel label propagation. The vertices with each color that reach the vertex with that id are
+ *     a component, found with a backward search per color in parallel.
+ *  4. When few vertices remain, or coloring stops making progress, the rest are found with Tarjan's
+ *     algorithm.
+ *
+ * Complexity: O(V + E) for trimming and forward-backward, O((V + E) * D) for each coloring round with
+ *             the diameter D of the remaining subgraph
+ *
+ * @param g           The graph.
+ * @param g_t         The transpose of the graph.
+ * @param component   [out] The strongly connected component of each vertex, numbered from 0.
+ * @param num_threads The number of threads to use, including the calling thread.
+ *
+ * @return The number of strongly connected components.
+*/
+template <adjacency_list G, adjacency_list GT, random_access_range Component>
+requires random_access_range<vertex_range_t<G>> && integral<vertex_id_t<G>> && integral<range_value_t<Component>>
+size_t forward_backward_scc(G&&          g,         // graph
+                            GT&&         g_t,       // graph transpose
+                            Component&   component, // out: strongly connected component assignment
+                            const size_t num_threads = hardware_thread_count()) {
+  using id_type = vertex_id_t<G>;
+  using CT      = range_value_t<Component>;
+  size_t N(size(vertices(g)));
+
+  std::vector<char>   done(N, false); // vertex has been assigned a component
+  std::atomic<size_t> next_cid{0};
+  auto is_active = [&done](id_type uid) {
+    return !std::atomic_ref<char>(done[static_cast<size_t>(uid)]).load(std::memory_order_relaxed);
+  };
+  auto claim = [&](id_type uid, size_t cid) {
+    if (std::atomic_ref<char>(done[static_cast<size_t>(uid)]).exchange(true, std::memory_order_relaxed)) {
+      return false;
+    }
+    component[static_cast<size_t>(uid)] = static_cast<CT>(cid);
+    return true;
+  };
+  auto claim_trivial = [&](id_type uid) { // a component of its own
+    if (std::atomic_ref<char>(done[static_cast<size_t>(uid)]).exchange(true, std::memory_order_relaxed)) {
+      return false;
+    }
+    component[static_cast<size_t>(uid)] = static_cast<CT>(next_cid++);
+    return true;
+  };
+  std::vector<std::vector<id_type>> local(std::max(num_threads, size_t(1)));
+  auto                              gather = [&local](std::vector<id_type>& frontier) {
+    frontier.clear();
+    for (auto& next : local) {
+      frontier.insert(frontier.end(), next.begin(), next.end());
+      next.clear();
+    }
+  };
+
+  // 1. Trimming, using the number of in and out edges from other vertices
+  std::vector<size_t> in_degree(N), out_degree(N);
+  parallel_for(N, num_threads, 1024, [&](size_t first, size_t last, size_t) {
+    for (size_t i = first; i < last; ++i) {
+      for (auto&& uv : edges(g, static_cast<id_type>(i)))
+        out_degree[i] += (static_cast<size_t>(target_id(g, uv)) != i);
+      for (auto&& uv : edges(g_t, static_cast<id_type>(i)))
+        in_degree[i] += (static_cast<size_t>(target_id(g_t, uv)) != i);
+    }
+  });
+  std::vector<id_type> frontier;
+  parallel_for(N, num_threads, 4096, [&](size_t first, size_t last, size_t tid) {
+    for (size_t i = first; i < last; ++i) {
+      if ((in_degree[i] == 0 || out_degree[i] == 0) && claim_trivial(static_cast<id_type>(i))) {
+        local[tid].push_back(static_cast<id_type>(i));
+      }
+    }
+  });
+  gather(frontier);
+  while (!frontier.empty()) {
+    parallel_for(frontier.size(), num_threads, 64, [&](size_t first, size_t last, size_t tid) {
+      auto remove_edge = [&](id_type vid, size_t& degree) {
+        if (is_active(vid) && std::atomic_ref<size_t>(degree).fetch_sub(1, std::memory_order_relaxed) == 1 &&
+            claim_trivial(vid)) {
+          local[tid].push_back(vid);
+        }
+      };
+      for (size_t i = first; i < last; ++i) {
+        const id_type uid = frontier[i];
+        for (auto&& uv : edges(g, uid)) {
+          const id_type vid = static_cast<id_type>(target_id(g, uv));
+          if (vid != uid)
+            remove_edge(vid, in_degree[static_cast<size_t>(vid)]);
+        }
+        for (auto&& uv : edges(g_t, uid)) {
+          const id_type vid = static_cast<id_type>(target_id(g_t, uv));
+          if (vid != uid)
+            remove_edge(vid, out_degree[static_cast<size_t>(vid)]);
+        }
+      }
+    });
+    gather(frontier);
+  }
+
+  // 2. Forward-backward from the remaining vertex with the most in and out edges
+  size_t  remaining = 0;
+  id_type pivot     = 0;
+  for (id_type uid = 0; uid < static_cast<id_type>(N); ++uid) {
+    if (is_active(uid)) {
+      const size_t u = static_cast<size_t>(uid), p = static_cast<size_t>(pivot);
+      if (remaining == 0 || in_degree[u] * out_degree[u] > in_degree[p] * out_degree[p])
+        pivot = uid;
+      ++remaining;
+    }
+  }
+  if (remaining > 0) {
+    std::vector<char> forward(N, false);
+    _parallel_reach(
+          g, pivot,
+          [&](id_type vid) {
+            return is_active(vid) &&
+                   !std::atomic_ref<char>(forward[static_cast<size_t>(vid)]).exchange(true, std::memory_order_relaxed);
+          },
+          num_threads);
+    const size_t cid = next_cid++;
+    _parallel_reach(
+          g_t, pivot,
+          [&](id_type vid) {
+            return std::atomic_ref<char>(forward[static_cast<size_t>(vid)]).load(std::memory_order_relaxed) &&
+                   claim(vid, cid);
+          },
+          num_threads);
+  }
+
+  // 3. Coloring
+  const size_t         serial_threshold = 1024;
+  size_t               prev_remaining   = std::numeric_limits<size_t>::max();
+  std::vector<id_type> color(N);
+  std::vector<char>    in_next(N, false);
+  for (;;) {
+    frontier.clear();
+    for (id_type uid = 0; uid < static_cast<id_type>(N); ++uid) {
+      if (is_active(uid)) {
+        color[static_cast<size_t>(uid)] = uid;
+        frontier.push_back(uid);
+      }
+    }
+    remaining = frontier.size();
+    if (remaining < serial_threshold || remaining > prev_remaining - prev_remaining / 100) {
+      break; // too few left, or too little progress in the last round
+    }
+    prev_remaining = remaining;
+
+    while (!frontier.empty()) {
+      parallel_for(frontier.size(), num_threads, 256, [&](size_t first, size_t last, size_t tid) {
+        for (size_t i = first; i < last; ++i) {
+          const id_type uid = frontier[i];
+          const id_type c   = std::atomic_ref<id_type>(color[static_cast<size_t>(uid)]).load(std::memory_order_relaxed);
+          for (auto&& uv : edges(g, uid)) {
+            const id_type vid = static_cast<id_type>(target_id(g, uv));
+            if (is_active(vid) && atomic_fetch_min(color[static_cast<size_t>(vid)], c) &&
+                !std::atomic_ref<char>(in_next[static_cast<size_t>(vid)]).exchange(true, std::memory_order_relaxed)) {
+              local[tid].push_back(vid);
+            }
+          }
+        }
+      });
+      gather(frontier);
+      for (id_type vid : frontier)
+        in_next[static_cast<size_t>(vid)] = false;
+    }
+
+    // The vertices with a color that reach the vertex with the color's id are its component
+    std::vector<id_type> roots;
+    for (id_type uid = 0; uid < static_cast<id_type>(N); ++uid) {
+      if (is_active(uid) && color[static_cast<size_t>(uid)] == uid)
+        roots.push_back(uid);
+    }
+    parallel_for(roots.size(), num_threads, 1, [&](size_t first, size_t last, size_t) {
+      std::vector<id_type> stack;
+      for (size_t i = first; i < last; ++i) {
+        const id_type root = roots[i];
+        const size_t  cid  = next_cid++;
+        claim(root, cid);
+        stack.push_back(root);
+        while (!stack.empty()) {
+          const id_type uid = stack.back();
+          stack.pop_back();
+          for (auto&& uv : edges(g_t, uid)) {
+            const id_type vid = static_cast<id_type>(target_id(g_t, uv));
+            if (color[static_cast<size_t>(vid)] == root && is_active(vid) && claim(vid, cid))
+              stack.push_back(vid);
+          }
+        }
+      }
+    });
+  }
+
+  // 4. Tarjan's algorithm for the rest
+  _tarjan_scc(g, is_active, [&](auto first, auto last) {
+    const size_t cid = next_cid++;
+    for (; first != last; ++first)
+      claim(*first, cid);
+  });
+
+  return next_cid.load();
+}
+
 } // namespace graph
 
 #endif //GRAPH_CC_HPP
@@ -31,7 +31,7 @@ namespace graph {
  * 
  * The implementation was taken from boost::graph dijkstra_shortest_paths_no_init.
  * 
- * Complexity: O((V + E) log V)
+ * Complexity: O((V + E) log V), or O(V + E) when the default unit_edge_weight is used
  * 
  * Pre-conditions:
  *  - 0 <= source < num_vertices(g)
@@ -50,7 +50,8 @@ namespace graph {
  * @tparam G            The graph type,
  * @tparam Distances    The distance random access range.
  * @tparam Predecessors The predecessor random access range.
- * @tparam WF           Edge weight function. Defaults to a function that returns 1.
+ * @tparam WF           Edge weight function. Defaults to unit_edge_weight, which returns 1 and evaluates
+ *                      the search as a breadth-first search.
  * @tparam Visitor      Visitor type with functions called for different events in the algorithm.
  *                      Function calls are removed by the optimizer if not used.
  * @tparam Compare      Comparison function for Distance values. Defaults to less<distance_type>.
@@ -60,7 +61,7 @@ template <index_adjacency_list G,
           input_range          Sources,
           random_access_range  Distances,
           random_access_range  Predecessors,
-          class WF      = function<range_value_t<Distances>(edge_reference_t<G>)>,
+          class WF      = unit_edge_weight<range_value_t<Distances>>,
           class Visitor = empty_visitor,
           class Compare = less<range_value_t<Distances>>,
           class Combine = plus<range_value_t<Distances>>>
@@ -75,7 +76,7 @@ constexpr void dijkstra_shortest_paths(
       const Sources& sources,
       Distances&     distances,
       Predecessors&  predecessor,
-      WF&&      weight  = [](edge_reference_t<G> uv) { return range_value_t<Distances>(1); }, // default weight(uv) -> 1
+      WF&&      weight  = unit_edge_weight<range_value_t<Distances>>(), // default weight(uv) -> 1
       Visitor&& visitor = empty_visitor(),
       Compare&& compare = less<range_value_t<Distances>>(),
       Combine&& combine = plus<range_value_t<Distances>>()) {
@@ -118,11 +119,21 @@ constexpr void dijkstra_shortest_paths(
 
   const id_type N = static_cast<id_type>(num_vertices(g));
 
+  // With unit edge weights a FIFO queue already returns vertices in non-decreasing distance order,
+  // turning the search into a breadth-first search without the cost of maintaining a heap.
+  constexpr bool is_unit_weight = _unit_weight_search<WF, distance_type, Compare, Combine>;
+
   auto qcompare = [&distances](id_type a, id_type b) {
     return distances[static_cast<size_t>(a)] > distances[static_cast<size_t>(b)];
   };
-  using Queue = std::priority_queue<id_type, std::vector<id_type>, decltype(qcompare)>;
-  Queue queue(qcompare);
+  using Queue = conditional_t<is_unit_weight, std::queue<id_type>,
+                              std::priority_queue<id_type, std::vector<id_type>, decltype(qcompare)>>;
+  Queue queue = [&qcompare]() {
+    if constexpr (is_unit_weight)
+      return Queue();
+    else
+      return Queue(qcompare);
+  }();
 
   // (The optimizer removes this loop if on_initialize_vertex() is empty.)
   if constexpr (has_on_initialize_vertex<G, Visitor>) {
@@ -145,7 +156,11 @@ constexpr void dijkstra_shortest_paths(
 
   // Main loop to process the queue
   while (!queue.empty()) {
-    const id_type uid = queue.top();
+    id_type uid;
+    if constexpr (is_unit_weight)
+      uid = queue.front();
+    else
+      uid = queue.top();
     queue.pop();
     if constexpr (has_on_examine_vertex<G, Visitor>) {
       visitor.on_examine_vertex({uid, *find_vertex(g, uid)});
@@ -158,7 +173,7 @@ constexpr void dijkstra_shortest_paths(
       }
 
       // Negative weights are not allowed for Dijkstra's algorithm
-      if constexpr (is_signed_v<weight_type>) {
+      if constexpr (is_signed_v<weight_type> && !is_unit_weight) {
         if (w < zero) {
           throw std::out_of_range(
                 std::format("dijkstra_shortest_paths: invalid negative edge weight of '{}' encountered", w));
@@ -210,7 +225,7 @@ constexpr void dijkstra_shortest_paths(
 template <index_adjacency_list G,
           random_access_range  Distances,
           random_access_range  Predecessors,
-          class WF      = function<range_value_t<Distances>(edge_reference_t<G>)>,
+          class WF      = unit_edge_weight<range_value_t<Distances>>,
           class Visitor = empty_visitor,
           class Compare = less<range_value_t<Distances>>,
           class Combine = plus<range_value_t<Distances>>>
@@ -224,7 +239,7 @@ constexpr void dijkstra_shortest_paths(
       vertex_id_t<G> source,
       Distances&     distances,
       Predecessors&  predecessor,
-      WF&&      weight  = [](edge_reference_t<G> uv) { return range_value_t<Distances>(1); }, // default weight(uv) -> 1
+      WF&&      weight  = unit_edge_weight<range_value_t<Distances>>(), // default weight(uv) -> 1
       Visitor&& visitor = empty_visitor(),
       Compare&& compare = less<range_value_t<Distances>>(),
       Combine&& combine = plus<range_value_t<Distances>>()) {
@@ -252,7 +267,8 @@ constexpr void dijkstra_shortest_paths(
  * 
  * @tparam G            The graph type,
  * @tparam Distances    The distance random access range.
- * @tparam WF           Edge weight function. Defaults to a function that returns 1.
+ * @tparam WF           Edge weight function. Defaults to unit_edge_weight, which returns 1 and evaluates
+ *                      the search as a breadth-first search.
  * @tparam Visitor      Visitor type with functions called for different events in the algorithm.
  *                      Function calls are removed by the optimizer if not used.
  * @tparam Compare      Comparison function for Distance values. Defaults to less<distance_type>.
@@ -261,7 +277,7 @@ constexpr void dijkstra_shortest_paths(
 template <index_adjacency_list G,
           input_range          Sources,
           random_access_range  Distances,
-          class WF      = function<range_value_t<Distances>(edge_reference_t<G>)>,
+          class WF      = unit_edge_weight<range_value_t<Distances>>,
           class Visitor = empty_visitor,
           class Compare = less<range_value_t<Distances>>,
           class Combine = plus<range_value_t<Distances>>>
@@ -273,7 +289,7 @@ constexpr void dijkstra_shortest_distances(
       G&&            g,
       const Sources& sources,
       Distances&     distances,
-      WF&&      weight  = [](edge_reference_t<G> uv) { return range_value_t<Distances>(1); }, // default weight(uv) -> 1
+      WF&&      weight  = unit_edge_weight<range_value_t<Distances>>(), // default weight(uv) -> 1
       Visitor&& visitor = empty_visitor(),
       Compare&& compare = less<range_value_t<Distances>>(),
       Combine&& combine = plus<range_value_t<Distances>>()) {
@@ -283,7 +299,7 @@ constexpr void dijkstra_shortest_distances(
 
 template <index_adjacency_list G,
           random_access_range  Distances,
-          class WF      = function<range_value_t<Distances>(edge_reference_t<G>)>,
+          class WF      = unit_edge_weight<range_value_t<Distances>>,
           class Visitor = empty_visitor,
           class Compare = less<range_value_t<Distances>>,
           class Combine = plus<range_value_t<Distances>>>
@@ -294,7 +310,7 @@ constexpr void dijkstra_shortest_distances(
       G&&            g,
       vertex_id_t<G> source,
       Distances&     distances,
-      WF&&      weight  = [](edge_reference_t<G> uv) { return range_value_t<Distances>(1); }, // default weight(uv) -> 1
+      WF&&      weight  = unit_edge_weight<range_value_t<Distances>>(), // default weight(uv) -> 1
       Visitor&& visitor = empty_visitor(),
       Compare&& compare = less<range_value_t<Distances>>(),
       Combine&& combine = plus<range_value_t<Distances>>()) {
@@ -0,0 +1,388 @@
+/**
+ * @file graph_coloring.hpp
+ *
+ * @brief Vertex coloring of an undirected graph, where neighbors always have different colors: greedy coloring
+ * with ordering heuristics, and parallel Jones-Plassmann and speculative coloring.
+ *
+ * The vertices of a color are independent, so the updates of all the vertices of a color can run at the same time
+ * without conflicts. Each coloring uses at most one more color than the largest degree.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: BSL-1.0
+ *
+ * @authors
+ */
+
+#include "graph/graph.hpp"
+#include "graph/algorithm/k_core.hpp"
+#include "graph/algorithm/mis.hpp"
+#include "graph/detail/parallel.hpp"
+
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <atomic>
+#include <barrier>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <format>
+
+#ifndef GRAPH_COLORING_HPP
+#  define GRAPH_COLORING_HPP
+
+namespace graph {
+
+/**
+ * @brief The order greedy_coloring() colors the vertices in.
+*/
+enum class coloring_order {
+  natural,       // by vertex id
+  largest_first, // by decreasing degree (Welsh-Powell)
+  smallest_last  // the reverse of repeatedly removing a vertex of the lowest remaining degree (Matula-Beck)
+};
+
+/**
+ * @brief The colors used by a coloring, and how long it took.
+*/
+struct coloring_stats {
+  size_t num_colors = 0; // colors used, numbered from 0
+  size_t rounds     = 0; // passes over the vertices left to color, which is 1 for greedy_coloring()
+  size_t conflicts  = 0; // vertices colored again because a neighbor took the same color
+  double seconds    = 0; // time taken, including the ordering of the vertices
+};
+
+/**
+ * @brief The lowest color that no neighbor of uid has, where color_of(vid) is the color of vid or npos. mark is
+ * indexed by color, and the colors of the neighbors are marked with stamp, which must differ from the stamps of the
+ * previous calls with the same mark.
+*/
+template <index_adjacency_list G, class ColorOf>
+size_t _first_fit(G&& g, const size_t uid, ColorOf&& color_of, std::vector<size_t>& mark, const size_t stamp) {
+  for (auto&& uv : edges(g, static_cast<vertex_id_t<G>>(uid))) {
+    const size_t vid = static_cast<size_t>(target_id(g, uv));
+    const size_t c   = vid != uid ? color_of(vid) : std::numeric_limits<size_t>::max();
+    if (c != std::numeric_limits<size_t>::max()) {
+      if (c >= mark.size()) {
+        mark.resize(c + 1, 0);
+      }
+      mark[c] = stamp;
+    }
+  }
+  size_t c = 0;
+  while (c < mark.size() && mark[c] == stamp) {
+    ++c;
+  }
+  return c;
+}
+
+/**
+ * @brief Copies color to colors and evaluates the number of colors used.
+*/
+template <class Colors>
+size_t _store_colors(const std::vector<size_t>& color, Colors& colors) {
+  size_t num_colors = 0;
+  for (size_t uid = 0; uid < color.size(); ++uid) {
+    colors[uid] = static_cast<range_value_t<Colors>>(color[uid]);
+    num_colors  = std::max(num_colors, color[uid] + 1);
+  }
+  return num_colors;
+}
+
+/**
+ * @ingroup graph_algorithms
+ * @brief Greedy coloring, giving each vertex in turn the lowest color that none of its colored neighbors has.
+ *
+ * The number of colors depends on the order of the vertices. largest_first colors the vertices with the most
+ * neighbors first, while they have the most colors to choose from. smallest_last colors each vertex when it has at
+ * most d colored neighbors, where d is the degeneracy of the graph (its largest core number), so it uses at most
+ * d + 1 colors; it is found with the bucket algorithm of k_core(). Both usually need fewer colors than the natural
+ * order.
+ *
+ * The graph must be undirected, with each edge stored in both directions. Self loops are ignored.
+ *
+ * Complexity: O(V + E)
+ *
+ * Throws:
+ *  - out_of_range if colors is smaller than the number of vertices.
+ *
+ * @tparam G      The graph type.
+ * @tparam Colors The random access range of colors.
+ *
+ * @param g      The graph.
+ * @param colors [out] The color of each vertex, accessible through colors[uid]. The colors are numbered from 0.
+ * @param order  The order to color the vertices in.
+ *
+ * @return The number of colors used and the time taken.
+ */
+template <index_adjacency_list G, random_access_range Colors>
+requires integral<range_value_t<Colors>> && sized_range<Colors>
+coloring_stats greedy_coloring(G&& g, Colors& colors, const coloring_order order = coloring_order::largest_first) {
+  using id_type = vertex_id_t<G>;
+  using clock   = std::chrono::steady_clock;
+
+  const size_t N = num_vertices(g);
+  if (size(colors) < N) {
+    throw std::out_of_range(
+          std::format("greedy_coloring: size of colors of {} is less than the number of vertices {}", size(colors), N));
+  }
+  const auto start = clock::now();
+
+  std::vector<size_t> sequence(N);
+  if (order == coloring_order::natural) {
+    std::iota(sequence.begin(), sequence.end(), size_t(0));
+  } else {
+    std::vector<size_t> deg(N);
+    for (size_t uid = 0; uid < N; ++uid) {
+      deg[uid] = static_cast<size_t>(std::ranges::distance(edges(g, static_cast<id_type>(uid))));
+    }
+    if (order == coloring_order::largest_first) {
+      // A counting sort by decreasing degree, keeping the vertices of a degree in order of id
+      const size_t        max_degree = N > 0 ? std::ranges::max(deg) : 0;
+      std::vector<size_t> next(max_degree + 2, 0);
+      for (size_t uid = 0; uid < N; ++uid) {
+        ++next[max_degree - deg[uid] + 1];
+      }
+      std::inclusive_scan(next.begin(), next.end(), next.begin());
+      for (size_t uid = 0; uid < N; ++uid) {
+        sequence[next[max_degree - deg[uid]]++] = uid;
+      }
+    } else {
+      _core_order(g, deg, sequence);
+      std::ranges::reverse(sequence);
+    }
+  }
+
+  std::vector<size_t> color(N, std::numeric_limits<size_t>::max()), mark;
+  auto                color_of = [&color](size_t vid) { return color[vid]; };
+  for (size_t i = 0; i < N; ++i) {
+    color[sequence[i]] = _first_fit(g, sequence[i], color_of, mark, i + 1);
+  }
+
+  coloring_stats stats;
+  stats.num_colors = _store_colors(color, colors);
+  stats.rounds     = N > 0 ? 1 : 0;
+  stats.seconds    = std::chrono::duration<double>(clock::now() - start).count();
+  return stats;
+}
+
+/**
+ * @ingroup graph_algorithms
+ * @brief Jones-Plassmann coloring on multiple threads.
+ *
+ * Each vertex is given a random priority from its id and random_seed. In each round, every uncolored vertex whose
+ * neighbors of higher priority are all colored takes the lowest color none of them has, so no two neighbors are
+ * ever colored at the same time and there are no conflicts to resolve. The coloring is the one greedy_coloring()
+ * finds when it visits the vertices by decreasing priority. It depends on random_seed but not on the number of
+ * threads, and takes O(log V / log log V) rounds with high probability for a graph of bounded degree.
+ *
+ * The graph must be undirected, with each edge stored in both directions. Self loops are ignored.
+ *
+ * Complexity: O(V + E) work per round, for the vertices left to color
+ *
+ * Throws:
+ *  - out_of_range if colors is smaller than the number of vertices.
+ *
+ * @tparam G      The graph type.
+ * @tparam Colors The random access range of colors.
+ *
+ * @param g           The graph.
+ * @param colors      [out] The color of each vertex, accessible through colors[uid]. The colors are numbered from 0.
+ * @param random_seed The seed for the vertex priorities.
+ * @param num_threads The number of threads to use, including the calling thread.
+ *
+ * @return The number of colors used, the number of rounds and the time taken.
+ */
+template <index_adjacency_list G, random_access_range Colors>
+requires integral<range_value_t<Colors>> && sized_range<Colors>
+coloring_stats jones_plassmann_coloring(G&&            g,
+                                        Colors&        colors,
+                                        const uint64_t random_seed = 0,
+                                        size_t         num_threads = hardware_thread_count()) {
+  using id_type          = vertex_id_t<G>;
+  using clock            = std::chrono::steady_clock;
+  constexpr size_t npos  = std::numeric_limits<size_t>::max();
+
+  const size_t N = num_vertices(g);
+  if (size(colors) < N) {
+    throw std::out_of_range(std::format(
+          "jones_plassmann_coloring: size of colors of {} is less than the number of vertices {}", size(colors), N));
+  }
+  const auto     start = clock::now();
+  coloring_stats stats;
+  num_threads = std::max(std::min(num_threads, (N + 1023) / 1024), size_t(1));
+
+  std::vector<size_t>  color(N, npos);
+  std::vector<size_t>  colored_in(N, npos); // the round each vertex was colored in
+  std::vector<id_type> active(N);
+  std::iota(active.begin(), active.end(), id_type(0));
+  auto color_of = [&color](size_t vid) { return std::atomic_ref<size_t>(color[vid]).load(std::memory_order_relaxed); };
+  auto round_of = [&colored_in](size_t vid) {
+    return std::atomic_ref<size_t>(colored_in[vid]).load(std::memory_order_relaxed);
+  };
+
+  std::vector<std::vector<id_type>> local(num_threads);
+  dynamic_chunks                    chunks(N, 1024);
+  bool                              done = (N == 0);
+
+  // The vertices that are still uncolored are the next round
+  auto after_round = [&]() noexcept {
+    active.clear();
+    for (auto& l : local) {
+      active.insert(active.end(), l.begin(), l.end());
+      l.clear();
+    }
+    ++stats.rounds;
+    done = active.empty();
+    chunks.reset(active.size(), 1024);
+  };
+  std::barrier round_done(static_cast<std::ptrdiff_t>(num_threads), after_round);
+
+  parallel_invoke(num_threads, [&](size_t tid) {
+    std::vector<size_t> mark;
+    size_t              stamp = 0;
+    while (!done) {
+      // Only the neighbors colored in earlier rounds count as colored, so the rounds don't depend on the order the
+      // threads run in
+      const size_t round = stats.rounds;
+      chunks.for_each([&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+          const size_t   uid      = static_cast<size_t>(active[i]);
+          const uint64_t priority = _mis_priority(random_seed, uid);
+          bool           ready    = true;
+          for (auto&& uv : edges(g, active[i])) {
+            const size_t vid = static_cast<size_t>(target_id(g, uv));
+            if (const size_t r = round_of(vid); vid != uid && (r == npos || r == round)) {
+              const uint64_t vid_priority = _mis_priority(random_seed, vid);
+              if (vid_priority > priority || (vid_priority == priority && vid < uid)) {
+                ready = false;
+                break;
+              }
+            }
+          }
+          if (ready) {
+            const size_t c = _first_fit(g, uid, color_of, mark, ++stamp);
+            std::atomic_ref<size_t>(color[uid]).store(c, std::memory_order_relaxed);
+            std::atomic_ref<size_t>(colored_in[uid]).store(round, std::memory_order_relaxed);
+          } else {
+            local[tid].push_back(active[i]);
+          }
+        }
+      });
+      round_done.arrive_and_wait();
+    }
+  });
+
+  stats.num_colors = _store_colors(color, colors);
+  stats.seconds    = std::chrono::duration<double>(clock::now() - start).count();
+  return stats;
+}
+
+/**
+ * @ingroup graph_algorithms
+ * @brief Speculative coloring with conflict resolution on multiple threads (Gebremedhin-Manne).
+ *
+ * In each round, the vertices left to color each take the lowest color none of their neighbors has, at the same
+ * time, reading the colors of the neighbors as they are being written. Two neighbors colored at the same time can
+ * take the same color, so the vertices of the round are then checked, and of two neighbors with the same color the
+ * one with the higher id is colored again in the next round. There are usually few conflicts and few rounds, and
+ * the number of colors is close to that of greedy_coloring() in natural order, but the coloring depends on the
+ * timing of the threads.
+ *
+ * The graph must be undirected, with each edge stored in both directions. Self loops are ignored.
+ *
+ * Complexity: O(V + E) work per round, for the vertices left to color
+ *
+ * Throws:
+ *  - out_of_range if colors is smaller than the number of vertices.
+ *
+ * @tparam G      The graph type.
+ * @tparam Colors The random access range of colors.
+ *
+ * @param g           The graph.
+ * @param colors      [out] The color of each vertex, accessible through colors[uid]. The colors are numbered from 0.
+ * @param num_threads The number of threads to use, including the calling thread.
+ *
+ * @return The number of colors used, the number of rounds and conflicts, and the time taken.
+ */
+template <index_adjacency_list G, random_access_range Colors>
+requires integral<range_value_t<Colors>> && sized_range<Colors>
+coloring_stats speculative_coloring(G&& g, Colors& colors, size_t num_threads = hardware_thread_count()) {
+  using id_type         = vertex_id_t<G>;
+  using clock           = std::chrono::steady_clock;
+  constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+  const size_t N = num_vertices(g);
+  if (size(colors) < N) {
+    throw std::out_of_range(std::format(
+          "speculative_coloring: size of colors of {} is less than the number of vertices {}", size(colors), N));
+  }
+  const auto     start = clock::now();
+  coloring_stats stats;
+  num_threads = std::max(std::min(num_threads, (N + 1023) / 1024), size_t(1));
+
+  std::vector<size_t>  color(N, npos);
+  std::vector<id_type> work(N);
+  std::iota(work.begin(), work.end(), id_type(0));
+  auto color_of = [&color](size_t vid) { return std::atomic_ref<size_t>(color[vid]).load(std::memory_order_relaxed); };
+
+  std::vector<std::vector<id_type>> local(num_threads);
+  dynamic_chunks                    chunks(N, 1024);
+  bool                              done = (N == 0);
+
+  auto after_color  = [&]() noexcept { chunks.reset(work.size(), 1024); };
+  auto after_detect = [&]() noexcept {
+    work.clear();
+    for (auto& l : local) {
+      work.insert(work.end(), l.begin(), l.end());
+      l.clear();
+    }
+    ++stats.rounds;
+    stats.conflicts += work.size();
+    done = work.empty();
+    chunks.reset(work.size(), 1024);
+  };
+  std::barrier colored(static_cast<std::ptrdiff_t>(num_threads), after_color);
+  std::barrier detected(static_cast<std::ptrdiff_t>(num_threads), after_detect);
+
+  parallel_invoke(num_threads, [&](size_t tid) {
+    std::vector<size_t> mark;
+    size_t              stamp = 0;
+    while (!done) {
+      // Color the vertices speculatively
+      chunks.for_each([&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+          const size_t uid = static_cast<size_t>(work[i]);
+          std::atomic_ref<size_t>(color[uid]).store(_first_fit(g, uid, color_of, mark, ++stamp),
+                                                    std::memory_order_relaxed);
+        }
+      });
+      colored.arrive_and_wait();
+
+      // Find the conflicts, which can only be between vertices colored in this round
+      chunks.for_each([&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+          const size_t uid = static_cast<size_t>(work[i]);
+          for (auto&& uv : edges(g, work[i])) {
+            const size_t vid = static_cast<size_t>(target_id(g, uv));
+            if (vid < uid && color[vid] == color[uid]) {
+              local[tid].push_back(work[i]);
+              break;
+            }
+          }
+        }
+      });
+      detected.arrive_and_wait();
+    }
+  });
+
+  stats.num_colors = _store_colors(color, colors);
+  stats.seconds    = std::chrono::duration<double>(clock::now() - start).count();
+  return stats;
+}
+
+} // namespace graph
+
+#endif // GRAPH_COLORING_HPP
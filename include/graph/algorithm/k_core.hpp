@@ -0,0 +1,305 @@
+/**
+ * @file k_core.hpp
+ *
+ * @brief k-core decomposition: the core number of every vertex of an undirected graph.
+ *
+ * The k-core of a graph is the largest subgraph in which every vertex has at least k neighbors, and the core
+ * number (coreness) of a vertex is the largest k for which it is in the k-core. The vertices with a core number
+ * of at least k are the k-core.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: BSL-1.0
+ *
+ * @authors
+ */
+
+#include "graph/graph.hpp"
+#include "graph/detail/parallel.hpp"
+
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <atomic>
+#include <barrier>
+#include <stdexcept>
+#include <format>
+
+#ifndef GRAPH_K_CORE_HPP
+#  define GRAPH_K_CORE_HPP
+
+namespace graph {
+
+/**
+ * @brief The Batagelj-Zaversnik bucket algorithm, removing a vertex of the lowest remaining degree at each step.
+ *
+ * On entry deg has the degree of each vertex, and on exit its core number. vert is set to the vertices in the order
+ * they were removed, which is a smallest-last (degeneracy) order when reversed.
+ *
+ * @return The largest core number, or 0 for an empty graph.
+*/
+template <index_adjacency_list G>
+size_t _core_order(G&& g, std::vector<size_t>& deg, std::vector<size_t>& vert) {
+  using id_type = vertex_id_t<G>;
+
+  const size_t N          = deg.size();
+  const size_t max_degree = N > 0 ? std::ranges::max(deg) : 0;
+
+  // bin[d] is the position in vert of the first vertex with degree d
+  std::vector<size_t> bin(max_degree + 1, 0), pos(N);
+  vert.resize(N);
+  for (size_t uid = 0; uid < N; ++uid) {
+    ++bin[deg[uid]];
+  }
+  std::exclusive_scan(bin.begin(), bin.end(), bin.begin(), size_t(0));
+  for (size_t uid = 0; uid < N; ++uid) {
+    pos[uid]       = bin[deg[uid]]++;
+    vert[pos[uid]] = uid;
+  }
+  std::shift_right(bin.begin(), bin.end(), 1);
+  bin[0] = 0;
+
+  size_t max_core = 0;
+  for (size_t i = 0; i < N; ++i) {
+    const size_t vid = vert[i];
+    max_core         = std::max(max_core, deg[vid]);
+    for (auto&& vu : edges(g, static_cast<id_type>(vid))) {
+      const size_t uid = static_cast<size_t>(target_id(g, vu));
+      if (deg[uid] > deg[vid]) {
+        // Swap u with the first vertex of its bin, then move the bin's start past it
+        const size_t du = deg[uid], pu = pos[uid], pw = bin[du], wid = vert[pw];
+        if (uid != wid) {
+          pos[uid] = pw;
+          vert[pu] = wid;
+          pos[wid] = pu;
+          vert[pw] = uid;
+        }
+        ++bin[du];
+        --deg[uid];
+      }
+    }
+  }
+  return max_core;
+}
+
+/**
+ * @ingroup graph_algorithms
+ * @brief Core numbers with the Batagelj-Zaversnik algorithm.
+ *
+ * The vertices are kept sorted by their remaining degree, with the first vertex of each degree in a bin array.
+ * The vertex with the lowest remaining degree is removed next, and each neighbor with a higher remaining degree is
+ * moved to the start of its bin and then into the bin below, in constant time. The degrees are read with degree(g,uid),
+ * which is O(1) for compressed_graph.
+ *
+ * The graph must be undirected, with each edge stored in both directions. A self loop counts once in the degree of
+ * its vertex and is never removed.
+ *
+ * Complexity: O(V + E)
+ *
+ * Throws:
+ *  - out_of_range if coreness is smaller than the number of vertices.
+ *
+ * @tparam G        The graph type.
+ * @tparam Coreness The random access range of core numbers.
+ *
+ * @param g        The graph.
+ * @param coreness [out] The core number of each vertex, accessible through coreness[uid].
+ *
+ * @return The largest core number (the degeneracy of the graph), or 0 for an empty graph.
+ */
+template <index_adjacency_list G, random_access_range Coreness>
+requires integral<range_value_t<Coreness>> && sized_range<Coreness>
+size_t k_core(G&& g, Coreness& coreness) {
+  using id_type = vertex_id_t<G>;
+
+  const size_t N = num_vertices(g);
+  if (size(coreness) < N) {
+    throw std::out_of_range(
+          std::format("k_core: size of coreness of {} is less than the number of vertices {}", size(coreness), N));
+  }
+
+  std::vector<size_t> deg(N), vert;
+  for (size_t uid = 0; uid < N; ++uid) {
+    deg[uid] = static_cast<size_t>(degree(g, static_cast<id_type>(uid)));
+  }
+  const size_t max_core = _core_order(g, deg, vert);
+
+  for (size_t uid = 0; uid < N; ++uid) {
+    coreness[uid] = static_cast<range_value_t<Coreness>>(deg[uid]);
+  }
+  return max_core;
+}
+
+/**
+ * @ingroup graph_algorithms
+ * @brief Core numbers by peeling the vertices in parallel, a bucket of equal degree at a time.
+ *
+ * The vertices are peeled in rounds for k = 0, 1, 2, ... The frontier of k starts as the remaining vertices with a
+ * degree of at most k, which are assigned the core number k. Each edge out of the frontier atomically decrements the
+ * degree of its target, and the thread whose decrement takes a target from k + 1 to k adds it to the next frontier
+ * of the same k. When a frontier is empty, k advances to the lowest remaining degree, skipping the empty buckets,
+ * and the list of remaining vertices is compacted so each scan only visits vertices that haven't been peeled.
+ *
+ * The graph must be undirected, with each edge stored in both directions. A self loop counts once in the degree of
+ * its vertex and is never removed.
+ *
+ * Complexity: O(V + E) work for the peeling, plus a scan of the remaining vertices for each distinct core number
+ *
+ * Throws:
+ *  - out_of_range if coreness is smaller than the number of vertices.
+ *
+ * @tparam G        The graph type.
+ * @tparam Coreness The random access range of core numbers.
+ *
+ * @param g           The graph.
+ * @param coreness    [out] The core number of each vertex, accessible through coreness[uid].
+ * @param num_threads The number of threads to use, including the calling thread.
+ *
+ * @return The largest core number (the degeneracy of the graph), or 0 for an empty graph.
+ */
+template <index_adjacency_list G, random_access_range Coreness>
+requires integral<range_value_t<Coreness>> && sized_range<Coreness>
+size_t parallel_k_core(G&& g, Coreness& coreness, size_t num_threads = hardware_thread_count()) {
+  using id_type = vertex_id_t<G>;
+
+  const size_t N = num_vertices(g);
+  if (size(coreness) < N) {
+    throw std::out_of_range(std::format(
+          "parallel_k_core: size of coreness of {} is less than the number of vertices {}", size(coreness), N));
+  }
+  if (N == 0) {
+    return 0;
+  }
+  num_threads = std::max(std::min(num_threads, (N + 1023) / 1024), size_t(1));
+
+  std::vector<size_t> deg(N);
+  std::vector<char>   peeled(N, false);
+  parallel_for(N, num_threads, 4096, [&](size_t first, size_t last, size_t) {
+    for (size_t uid = first; uid < last; ++uid) {
+      deg[uid] = static_cast<size_t>(degree(g, static_cast<id_type>(uid)));
+    }
+  });
+
+  struct alignas(64) thread_min {
+    size_t value = std::numeric_limits<size_t>::max();
+  };
+  std::vector<id_type>              remaining(N), frontier, next;
+  std::vector<std::vector<id_type>> local(num_threads);
+  std::vector<size_t>               offsets(num_threads + 1, 0); // where local[tid] goes in the destination
+  std::vector<thread_min>           lowest(num_threads);
+  std::iota(remaining.begin(), remaining.end(), id_type(0));
+
+  dynamic_chunks work(N, 1024);
+  size_t         k = 0, num_peeled = 0;
+  bool           scan = true; // find the next k and its frontier from the remaining vertices
+
+  // Each step has each thread fill local[tid] from chunks of a list, then copy it into a destination list at an
+  // offset given by a prefix sum of the sizes. The completion functions do the serial work between the steps.
+  std::vector<id_type>* destination = nullptr;
+  auto                  sized       = [&]() noexcept {
+    for (size_t tid = 0; tid < num_threads; ++tid) {
+      offsets[tid + 1] = offsets[tid] + local[tid].size();
+    }
+    destination->resize(offsets[num_threads]);
+  };
+  std::barrier filled(static_cast<std::ptrdiff_t>(num_threads), sized);
+
+  auto after_compact = [&]() noexcept {
+    remaining.swap(next);
+    size_t low = std::numeric_limits<size_t>::max();
+    for (auto& m : lowest) {
+      low     = std::min(low, m.value);
+      m.value = std::numeric_limits<size_t>::max();
+    }
+    k = std::max(k, low); // every remaining vertex has a degree above the previous k
+    destination = &frontier;
+    work.reset(remaining.size(), 1024);
+  };
+  std::barrier compacted(static_cast<std::ptrdiff_t>(num_threads), after_compact);
+
+  auto after_step = [&]() noexcept {
+    if (destination == &frontier) { // the frontier is selected: peel it
+      destination = &next;
+      work.reset(frontier.size(), 256);
+      scan = false;
+    } else { // the next frontier is found
+      num_peeled += frontier.size();
+      frontier.swap(next);
+      scan = frontier.empty();
+      if (scan) {
+        destination = &next;
+        work.reset(remaining.size(), 1024);
+      } else {
+        work.reset(frontier.size(), 256);
+      }
+    }
+  };
+  std::barrier stepped(static_cast<std::ptrdiff_t>(num_threads), after_step);
+
+  auto copy_local = [&](size_t tid) {
+    std::ranges::copy(local[tid], destination->begin() + static_cast<std::ptrdiff_t>(offsets[tid]));
+    local[tid].clear();
+  };
+
+  destination = &next;
+  parallel_invoke(num_threads, [&](size_t tid) {
+    std::vector<id_type>& found = local[tid];
+    while (num_peeled < N) {
+      if (scan) {
+        // Compact the remaining vertices, finding their lowest degree
+        size_t low = std::numeric_limits<size_t>::max();
+        work.for_each([&](size_t first, size_t last) {
+          for (size_t i = first; i < last; ++i) {
+            const id_type uid = remaining[i];
+            if (!peeled[static_cast<size_t>(uid)]) {
+              found.push_back(uid);
+              low = std::min(low, deg[static_cast<size_t>(uid)]);
+            }
+          }
+        });
+        lowest[tid].value = low;
+        filled.arrive_and_wait();
+        copy_local(tid);
+        compacted.arrive_and_wait();
+
+        // The frontier is the remaining vertices with a degree of at most k
+        work.for_each([&](size_t first, size_t last) {
+          for (size_t i = first; i < last; ++i) {
+            if (deg[static_cast<size_t>(remaining[i])] <= k) {
+              found.push_back(remaining[i]);
+            }
+          }
+        });
+        filled.arrive_and_wait();
+        copy_local(tid);
+        stepped.arrive_and_wait();
+      }
+
+      // Peel the frontier. A target with a degree of at most k has been peeled or is in a frontier of k.
+      work.for_each([&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+          const size_t uid = static_cast<size_t>(frontier[i]);
+          coreness[uid]    = static_cast<range_value_t<Coreness>>(k);
+          peeled[uid]      = true;
+          for (auto&& uv : edges(g, static_cast<id_type>(uid))) {
+            const size_t            vid = static_cast<size_t>(target_id(g, uv));
+            std::atomic_ref<size_t> vdeg(deg[vid]);
+            if (vdeg.load(std::memory_order_relaxed) > k && vdeg.fetch_sub(1, std::memory_order_relaxed) == k + 1) {
+              found.push_back(static_cast<id_type>(vid));
+            }
+          }
+        }
+      });
+      filled.arrive_and_wait();
+      copy_local(tid);
+      stepped.arrive_and_wait();
+    }
+  });
+
+  return k;
+}
+
+} // namespace graph
+
+#endif // GRAPH_K_CORE_HPP
@@ -0,0 +1,515 @@
+/**
+ * @file louvain.hpp
+ *
+ * @brief Louvain community detection: a partition of the vertices of an undirected graph into communities with a
+ * high modularity.
+ *
+ * The modularity of a partition is the fraction of the edge weight inside the communities, less the fraction
+ * expected if the edges were placed at random with the same vertex degrees:
+ *
+ *     Q = sum over communities c of (in(c) / 2m - resolution * (tot(c) / 2m)^2)
+ *
+ * where in(c) is the weight of the edges inside c, counted in both directions, tot(c) is the sum of the weighted
+ * degrees of the vertices in c, and 2m is the sum of all weighted degrees.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: BSL-1.0
+ *
+ * @authors
+ */
+
+#include "graph/graph.hpp"
+#include "graph/algorithm/common_shortest_paths.hpp"
+#include "graph/container/compressed_graph.hpp"
+#include "graph/detail/parallel.hpp"
+
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <format>
+
+#ifndef GRAPH_LOUVAIN_HPP
+#  define GRAPH_LOUVAIN_HPP
+
+namespace graph {
+
+/**
+ * @brief What was done at one level of louvain(), and how long it took.
+*/
+struct louvain_level {
+  size_t num_vertices    = 0; // vertices in the graph of the level
+  size_t num_edges       = 0; // edges in the graph of the level, including both directions and self loops
+  size_t num_communities = 0; // communities found by the local moving
+  size_t iterations      = 0; // passes over the vertices by the local moving
+  size_t moves           = 0; // vertices moved to another community, over all the passes
+  double modularity      = 0; // modularity of the partition of the original graph after the level
+  double move_seconds    = 0; // time taken by the local moving
+  double coarsen_seconds = 0; // time taken to build the graph of the next level, or 0 for the last level
+};
+
+/**
+ * @brief A hash map from community ids to the weight of the edges to them, for the neighbors of one vertex at a
+ * time. It uses open addressing with linear probing, and keeps the slots used so clear() only touches those.
+*/
+template <class Key>
+class _community_weights {
+public:
+  void add(const Key key, const double weight) {
+    if (2 * (used_.size() + 1) > keys_.size()) {
+      grow();
+    }
+    const size_t slot = find(key);
+    if (keys_[slot] == empty_key) {
+      keys_[slot]    = key;
+      weights_[slot] = weight;
+      used_.push_back(slot);
+    } else {
+      weights_[slot] += weight;
+    }
+  }
+
+  // The weight to key, or 0 if there are no edges to it
+  double operator[](const Key key) const noexcept {
+    if (keys_.empty()) {
+      return 0.0;
+    }
+    const size_t slot = find(key);
+    return keys_[slot] == key ? weights_[slot] : 0.0;
+  }
+
+  // Calls f(key, weight) for each key, in the order they were added
+  template <class F>
+  void for_each(F&& f) const {
+    for (size_t slot : used_) {
+      f(keys_[slot], weights_[slot]);
+    }
+  }
+
+  size_t size() const noexcept { return used_.size(); }
+
+  void clear() noexcept {
+    for (size_t slot : used_) {
+      keys_[slot] = empty_key;
+    }
+    used_.clear();
+  }
+
+private:
+  static constexpr Key empty_key = std::numeric_limits<Key>::max();
+
+  size_t find(const Key key) const noexcept {
+    size_t slot = (static_cast<uint64_t>(key) * uint64_t{0x9E3779B97F4A7C15}) >> shift_;
+    while (keys_[slot] != empty_key && keys_[slot] != key) {
+      slot = (slot + 1) & (keys_.size() - 1);
+    }
+    return slot;
+  }
+
+  void grow() {
+    std::vector<Key>    keys(std::max(keys_.size() * 2, size_t(16)), empty_key);
+    std::vector<double> weights(keys.size());
+    std::vector<size_t> used;
+    used.reserve(keys.size() / 2);
+    keys_.swap(keys);
+    weights_.swap(weights);
+    used_.swap(used);
+    shift_ = 64 - static_cast<unsigned>(std::countr_zero(keys_.size()));
+    for (size_t slot : used) {
+      add(keys[slot], weights[slot]);
+    }
+  }
+
+  std::vector<Key>    keys_;
+  std::vector<double> weights_;
+  std::vector<size_t> used_;
+  unsigned            shift_ = 64;
+};
+
+/**
+ * @brief The modularity of the communities of g given by label, with the sum of the weighted degrees in each
+ * community in tot.
+*/
+template <index_adjacency_list G, class WF, class Label>
+double _louvain_modularity(G&&                        g,
+                           WF&                        weight,
+                           const std::vector<Label>&  label,
+                           const std::vector<double>& tot,
+                           const double               two_m,
+                           const double               resolution,
+                           const size_t               num_threads) {
+  using id_type = vertex_id_t<G>;
+  struct alignas(64) thread_sum {
+    double inside = 0, squares = 0;
+  };
+  std::vector<thread_sum> sums(num_threads);
+  parallel_for(num_vertices(g), num_threads, 1024, [&](size_t first, size_t last, size_t tid) {
+    double inside = 0, squares = 0;
+    for (size_t uid = first; uid < last; ++uid) {
+      for (auto&& uv : edges(g, static_cast<id_type>(uid))) {
+        if (label[static_cast<size_t>(target_id(g, uv))] == label[uid]) {
+          inside += static_cast<double>(weight(uv));
+        }
+      }
+      squares += tot[uid] * tot[uid];
+    }
+    sums[tid].inside += inside;
+    sums[tid].squares += squares;
+  });
+
+  double inside = 0, squares = 0;
+  for (auto& s : sums) {
+    inside += s.inside;
+    squares += s.squares;
+  }
+  return inside / two_m - resolution * squares / (two_m * two_m);
+}
+
+/**
+ * @brief The local moving phase of a level of louvain(). Each vertex starts in its own community, and the vertices
+ * are moved to the neighboring community with the largest modularity gain, on multiple threads, until a pass over
+ * the vertices improves the modularity by less than threshold. The communities are then numbered from 0.
+ *
+ * A thread gathers the weight of the edges from a vertex to each neighboring community in its own hash map. The
+ * community totals are updated with atomic adds, and the labels of the neighbors are read as they are, so a move
+ * is evaluated with the latest labels the thread sees. To keep two vertices alone in their communities from
+ * swapping communities with each other forever, a vertex alone in its community only moves to a community with a
+ * single vertex if that community has a lower id.
+ *
+ * @return The modularity before the moves. info has the modularity after them.
+*/
+template <index_adjacency_list G, class WF, class Label>
+double _louvain_move(G&&                 g,
+                     WF&                 weight,
+                     std::vector<Label>& label,
+                     const double        resolution,
+                     const double        threshold,
+                     const size_t        num_threads,
+                     louvain_level&      info) {
+  using id_type = vertex_id_t<G>;
+  static_assert(std::is_same_v<id_type, Label>);
+  constexpr size_t max_iterations = 100;
+
+  const size_t N = num_vertices(g);
+  info.num_vertices = N;
+  label.resize(N);
+  std::iota(label.begin(), label.end(), id_type(0));
+
+  // k[uid] is the weighted degree of uid, and tot[c] the sum of the weighted degrees of the vertices in c
+  std::vector<double> k(N), tot(N);
+  std::vector<size_t> members(N, 1);
+  struct alignas(64) thread_sum {
+    double weight = 0;
+    size_t edges  = 0;
+  };
+  std::vector<thread_sum> sums(num_threads);
+  parallel_for(N, num_threads, 1024, [&](size_t first, size_t last, size_t tid) {
+    for (size_t uid = first; uid < last; ++uid) {
+      double degree = 0;
+      for (auto&& uv : edges(g, static_cast<id_type>(uid))) {
+        const double w = static_cast<double>(weight(uv));
+        if (!(w >= 0)) {
+          throw std::out_of_range(std::format("louvain: the weight {} of an edge of {} is negative", w, uid));
+        }
+        degree += w;
+        ++sums[tid].edges;
+      }
+      k[uid] = tot[uid] = degree;
+      sums[tid].weight += degree;
+    }
+  });
+  double two_m = 0;
+  for (auto& s : sums) {
+    two_m += s.weight;
+    info.num_edges += s.edges;
+  }
+  if (two_m == 0) {
+    info.num_communities = N;
+    return 0;
+  }
+
+  std::vector<_community_weights<id_type>> neighbors(num_threads);
+  std::atomic<size_t>                      total_moves = 0;
+
+  const double initial = _louvain_modularity(g, weight, label, tot, two_m, resolution, num_threads);
+  info.modularity      = initial;
+  while (info.iterations < max_iterations) {
+    std::atomic<size_t> moves = 0;
+    parallel_for(N, num_threads, 256, [&](size_t first, size_t last, size_t tid) {
+      _community_weights<id_type>& to_community = neighbors[tid];
+      size_t                       thread_moves = 0;
+      for (size_t uid = first; uid < last; ++uid) {
+        if (k[uid] == 0) {
+          continue;
+        }
+        const id_type from = std::atomic_ref<id_type>(label[uid]).load(std::memory_order_relaxed);
+        to_community.clear();
+        for (auto&& uv : edges(g, static_cast<id_type>(uid))) {
+          const size_t vid = static_cast<size_t>(target_id(g, uv));
+          if (vid != uid) {
+            to_community.add(std::atomic_ref<id_type>(label[vid]).load(std::memory_order_relaxed),
+                             static_cast<double>(weight(uv)));
+          }
+        }
+
+        // The gain of moving uid to c, less a term that is the same for every c, is the weight to c less the
+        // weight expected to c
+        auto total = [&tot](id_type c) {
+          return std::atomic_ref<double>(tot[static_cast<size_t>(c)]).load(std::memory_order_relaxed);
+        };
+        const double scale = resolution * k[uid] / two_m;
+        id_type      to    = from;
+        double       best  = to_community[from] - scale * (total(from) - k[uid]);
+        to_community.for_each([&](id_type c, double w) {
+          const double gain = w - scale * total(c);
+          if (c != from && (gain > best || (gain == best && to != from && c < to))) {
+            best = gain;
+            to   = c;
+          }
+        });
+        if (to == from) {
+          continue;
+        }
+        const size_t a = static_cast<size_t>(from), b = static_cast<size_t>(to);
+        if (std::atomic_ref<size_t>(members[a]).load(std::memory_order_relaxed) == 1 &&
+            std::atomic_ref<size_t>(members[b]).load(std::memory_order_relaxed) == 1 && to > from) {
+          continue;
+        }
+
+        std::atomic_ref<double>(tot[a]).fetch_sub(k[uid], std::memory_order_relaxed);
+        std::atomic_ref<double>(tot[b]).fetch_add(k[uid], std::memory_order_relaxed);
+        std::atomic_ref<size_t>(members[a]).fetch_sub(1, std::memory_order_relaxed);
+        std::atomic_ref<size_t>(members[b]).fetch_add(1, std::memory_order_relaxed);
+        std::atomic_ref<id_type>(label[uid]).store(to, std::memory_order_relaxed);
+        ++thread_moves;
+      }
+      moves.fetch_add(thread_moves, std::memory_order_relaxed);
+    });
+    ++info.iterations;
+    total_moves += moves.load();
+
+    const double previous = info.modularity;
+    info.modularity       = _louvain_modularity(g, weight, label, tot, two_m, resolution, num_threads);
+    if (moves.load() == 0 || info.modularity - previous < threshold) {
+      break;
+    }
+  }
+  info.moves = total_moves.load();
+
+  // Number the communities that aren't empty from 0
+  std::vector<id_type> renumber(N);
+  size_t               num_communities = 0;
+  for (size_t c = 0; c < N; ++c) {
+    if (members[c] > 0) {
+      renumber[c] = static_cast<id_type>(num_communities++);
+    }
+  }
+  parallel_for(N, num_threads, 4096, [&](size_t first, size_t last, size_t) {
+    for (size_t uid = first; uid < last; ++uid) {
+      label[uid] = renumber[static_cast<size_t>(label[uid])];
+    }
+  });
+  info.num_communities = num_communities;
+  return initial;
+}
+
+/**
+ * @brief Builds the graph of the next level of louvain(), with a vertex for each community of g and an edge for
+ * each pair of neighboring communities, weighted by the sum of the weights of the edges between them. The edges
+ * inside a community become a self loop. The edges of each community are gathered in a per-thread hash map, and
+ * the rows are copied into the edge list in order of community at offsets given by a prefix sum of their sizes.
+*/
+template <index_adjacency_list G, class WF, class Label>
+container::compressed_graph<double, void, void, Label, Label> _louvain_coarsen(G&&                       g,
+                                                                               WF&                       weight,
+                                                                               const std::vector<Label>& label,
+                                                                               const size_t num_communities,
+                                                                               const size_t num_threads) {
+  using id_type   = vertex_id_t<G>;
+  using edge_type = copyable_edge_t<Label, double>;
+  const size_t N  = num_vertices(g);
+  const size_t C  = num_communities;
+
+  // The vertices of community c are members[first[c], first[c + 1])
+  std::vector<size_t> first(C + 1, 0);
+  for (size_t uid = 0; uid < N; ++uid) {
+    ++first[static_cast<size_t>(label[uid]) + 1];
+  }
+  std::inclusive_scan(first.begin(), first.end(), first.begin());
+  std::vector<id_type> members(N);
+  {
+    std::vector<size_t> next(first.begin(), first.end() - 1);
+    for (size_t uid = 0; uid < N; ++uid) {
+      members[next[static_cast<size_t>(label[uid])]++] = static_cast<id_type>(uid);
+    }
+  }
+
+  // The row of community c is local[owner[c]][row[c], row[c] + count[c])
+  std::vector<std::vector<edge_type>>   local(num_threads);
+  std::vector<_community_weights<Label>> neighbors(num_threads);
+  std::vector<size_t>                   owner(C), row(C), offsets(C + 1, 0);
+  parallel_for(C, num_threads, 64, [&](size_t c_first, size_t c_last, size_t tid) {
+    _community_weights<Label>& to_community = neighbors[tid];
+    std::vector<edge_type>&    rows         = local[tid];
+    for (size_t c = c_first; c < c_last; ++c) {
+      to_community.clear();
+      for (size_t i = first[c]; i < first[c + 1]; ++i) {
+        for (auto&& uv : edges(g, members[i])) {
+          to_community.add(label[static_cast<size_t>(target_id(g, uv))], static_cast<double>(weight(uv)));
+        }
+      }
+      owner[c]       = tid;
+      row[c]         = rows.size();
+      offsets[c + 1] = to_community.size();
+      to_community.for_each(
+            [&](Label d, double w) { rows.push_back(edge_type{static_cast<Label>(c), d, w}); });
+      std::ranges::sort(rows.begin() + static_cast<std::ptrdiff_t>(row[c]), rows.end(), {}, &edge_type::target_id);
+    }
+  });
+  std::inclusive_scan(offsets.begin(), offsets.end(), offsets.begin());
+
+  std::vector<edge_type> edge_list(offsets[C]);
+  parallel_for(C, num_threads, 1024, [&](size_t c_first, size_t c_last, size_t) {
+    for (size_t c = c_first; c < c_last; ++c) {
+      auto row_first = local[owner[c]].begin() + static_cast<std::ptrdiff_t>(row[c]);
+      std::copy(row_first, row_first + static_cast<std::ptrdiff_t>(offsets[c + 1] - offsets[c]),
+                edge_list.begin() + static_cast<std::ptrdiff_t>(offsets[c]));
+    }
+  });
+  local.clear();
+
+  container::compressed_graph<double, void, void, Label, Label> coarse;
+  coarse.load_edges(edge_list, identity(), C, edge_list.size());
+  return coarse;
+}
+
+/**
+ * @ingroup graph_algorithms
+ * @brief Louvain community detection, with parallel local moving and coarsening.
+ *
+ * Each level starts with every vertex in its own community and moves the vertices between neighboring communities
+ * on multiple threads while the modularity improves by at least threshold in a pass over the vertices. The graph of
+ * the next level then has a vertex for each community, with edges weighted by the sum of the weights between them,
+ * and is built as a compressed_graph. The levels stop when a level doesn't merge any vertices or improves the
+ * modularity by less than threshold.
+ *
+ * A thread gathers the weight of the edges from a vertex to each neighboring community in its own hash map. The
+ * moves of a pass use the community labels as they are updated by the other threads, so the communities found can
+ * depend on the number of threads. With one thread it is the sequential Louvain algorithm.
+ *
+ * The graph must be undirected, with each edge stored in both directions with the same weight. A self loop is
+ * stored once, and its weight counts once in the degree of its vertex.
+ *
+ * Complexity: O(V + E) per pass over the vertices, with the graph getting smaller at each level
+ *
+ * Throws:
+ *  - out_of_range if community is smaller than the number of vertices, or if the weight of an edge is negative.
+ *
+ * @tparam G         The graph type.
+ * @tparam Community The random access range of community ids.
+ * @tparam WF        The edge weight function type.
+ *
+ * @param g           The graph.
+ * @param community   [out] The community of each vertex, accessible through community[uid]. The communities are
+ *                    numbered from 0.
+ * @param levels      [out] The number of vertices, edges, communities and passes, the modularity, and the time
+ *                    taken to move the vertices and to coarsen the graph, for each level.
+ * @param weight      The edge weight function, which must return non-negative weights (default returns 1.)
+ * @param resolution  The resolution. Values above 1 give smaller communities, and values below 1 larger ones.
+ * @param threshold   The smallest improvement in the modularity for another pass or level.
+ * @param num_threads The number of threads to use, including the calling thread.
+ *
+ * @return The modularity of the communities.
+ */
+template <index_adjacency_list G, random_access_range Community, class WF = unit_edge_weight<double>>
+requires integral<range_value_t<Community>> && sized_range<Community> &&
+         is_arithmetic_v<remove_cvref_t<invoke_result_t<WF, edge_reference_t<G>>>>
+double louvain(G&&                         g,
+               Community&                  community,
+               std::vector<louvain_level>& levels,
+               WF&&                        weight      = unit_edge_weight<double>(),
+               const double                resolution  = 1.0,
+               const double                threshold   = 1e-6,
+               size_t                      num_threads = hardware_thread_count()) {
+  using id_type      = vertex_id_t<G>;
+  using coarse_graph = container::compressed_graph<double, void, void, id_type, id_type>;
+  using clock        = std::chrono::steady_clock;
+
+  const size_t N = num_vertices(g);
+  if (size(community) < N) {
+    throw std::out_of_range(
+          std::format("louvain: size of community of {} is less than the number of vertices {}", size(community), N));
+  }
+  levels.clear();
+  if (N == 0) {
+    return 0;
+  }
+  num_threads = std::max(std::min(num_threads, (N + 1023) / 1024), size_t(1));
+
+  // assignment[uid] is the vertex of uid in the graph of the current level
+  std::vector<id_type> assignment(N), label;
+  std::iota(assignment.begin(), assignment.end(), id_type(0));
+  coarse_graph coarse;
+  auto         coarse_weight = [&coarse](auto&& uv) { return edge_value(coarse, uv); };
+
+  // Runs a level on lg, and builds the graph of the next level if there is one
+  auto run_level = [&](auto&& lg, auto& lweight) {
+    louvain_level info;
+    auto          start   = clock::now();
+    const double  initial = _louvain_move(lg, lweight, label, resolution, threshold, num_threads, info);
+    parallel_for(N, num_threads, 4096, [&](size_t first, size_t last, size_t) {
+      for (size_t uid = first; uid < last; ++uid) {
+        assignment[uid] = label[static_cast<size_t>(assignment[uid])];
+      }
+    });
+    info.move_seconds = std::chrono::duration<double>(clock::now() - start).count();
+
+    const bool more = info.num_communities < info.num_vertices && info.modularity - initial >= threshold;
+    if (more) {
+      start                = clock::now();
+      coarse               = _louvain_coarsen(lg, lweight, label, info.num_communities, num_threads);
+      info.coarsen_seconds = std::chrono::duration<double>(clock::now() - start).count();
+    }
+    levels.push_back(info);
+    return more;
+  };
+
+  bool more = run_level(g, weight);
+  while (more) {
+    more = run_level(coarse, coarse_weight);
+  }
+
+  for (size_t uid = 0; uid < N; ++uid) {
+    community[uid] = static_cast<range_value_t<Community>>(assignment[uid]);
+  }
+  return levels.back().modularity;
+}
+
+/**
+ * @ingroup graph_algorithms
+ * @brief Louvain community detection, with parallel local moving and coarsening, without the level details.
+ *
+ * @return The modularity of the communities.
+ */
+template <index_adjacency_list G, random_access_range Community, class WF = unit_edge_weight<double>>
+requires integral<range_value_t<Community>> && sized_range<Community> &&
+         is_arithmetic_v<remove_cvref_t<invoke_result_t<WF, edge_reference_t<G>>>>
+double louvain(G&&          g,
+               Community&   community,
+               WF&&         weight      = unit_edge_weight<double>(),
+               const double resolution  = 1.0,
+               const double threshold   = 1e-6,
+               size_t       num_threads = hardware_thread_count()) {
+  std::vector<louvain_level> levels;
+  return louvain(g, community, levels, weight, resolution, threshold, num_threads);
+}
+
+} // namespace graph
+
+#endif // GRAPH_LOUVAIN_HPP
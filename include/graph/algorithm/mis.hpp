@@ -15,6 +15,12 @@
 
 #include "graph/graph.hpp"
 #include "graph/views/incidence.hpp"
+#include "graph/views/vertexlist.hpp"
+#include "graph/detail/parallel.hpp"
+#include <vector>
+#include <atomic>
+#include <barrier>
+#include <cstdint>
 
 #ifndef GRAPH_MIS_HPP
 #  define GRAPH_MIS_HPP
@@ -61,6 +67,154 @@ void maximal_independent_set(G&&            g,       // graph
   }
 }
 
+/**
+ * @brief The priority of a vertex for parallel_maximal_independent_set(), a splitmix64 hash of the seed and id.
+*/
+inline uint64_t _mis_priority(const uint64_t seed, const uint64_t uid) noexcept {
+  uint64_t z = seed + (uid + 1) * 0x9e3779b97f4a7c15;
+  z          = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+  z          = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+  return z ^ (z >> 31);
+}
+
+/**
+ * @ingroup graph_algorithms
+ * @brief Find a maximal independent set of vertices using multiple threads.
+ * 
+ * Each vertex is given a random priority from its id and random_seed. In each round, an undecided vertex
+ * joins the set when no neighbor has joined and no undecided neighbor has a higher priority; then the
+ * neighbors of the vertices that joined are removed. This is the deterministic-reservation form of
+ * Luby's algorithm (Blelloch, Fineman and Shun), so the set is the one the greedy algorithm finds
+ * when it visits the vertices by decreasing priority. It depends on random_seed but not on the number
+ * of threads, and takes O(log^2 V) rounds with high probability.
+ * 
+ * The graph must be undirected, with each edge stored in both directions, for the vertices to be
+ * independent. Self loops are ignored.
+ * The vertices are written to mis in increasing order.
+ * 
+ * Complexity: O(|V| + |E|) expected work
+ * 
+ * @tparam G           The graph type.
+ * @tparam Iter        The output iterator type.
+ * 
+ * @param g            The graph.
+ * @param mis          The output iterator.
+ * @param random_seed  The seed for the vertex priorities.
+ * @param num_threads  The number of threads to use, including the calling thread.
+ */
+template <adjacency_list G, class Iter>
+requires random_access_range<vertex_range_t<G>> && integral<vertex_id_t<G>> && output_iterator<Iter, vertex_id_t<G>>
+void parallel_maximal_independent_set(G&&            g,                                    // graph
+                                      Iter           mis,                                  // out: independent set
+                                      const uint64_t random_seed = 0,                      // vertex priorities
+                                      const size_t   num_threads = hardware_thread_count() // threads
+) {
+  using id_type = vertex_id_t<G>;
+  enum : char { undecided = 0, in_set = 1, removed = 2 };
+  const size_t N(size(vertices(g)));
+
+  std::vector<char>    status(N, undecided);
+  std::vector<id_type> active(N);
+  parallel_for(N, num_threads, 4096, [&](size_t first, size_t last, size_t) {
+    for (size_t uid = first; uid < last; ++uid)
+      active[uid] = static_cast<id_type>(uid);
+  });
+
+  auto load = [&status](size_t uid) { return std::atomic_ref<char>(status[uid]).load(std::memory_order_relaxed); };
+  // Does vid come before uid in the greedy order? The priorities are hashed rather than stored, which
+  // is cheaper than a cache miss on a large graph.
+  auto precedes = [random_seed](size_t vid, size_t uid, uint64_t uid_priority) {
+    const uint64_t vid_priority = _mis_priority(random_seed, vid);
+    return vid_priority > uid_priority || (vid_priority == uid_priority && vid < uid);
+  };
+
+  const size_t                      T = std::max(std::min(num_threads, N / 1024 + 1), size_t(1));
+  std::vector<std::vector<id_type>> local(T);
+  std::vector<id_type>              joined;
+  dynamic_chunks                    chunks(N, 1024);
+  bool                              done = (N == 0);
+
+  // Concatenate the per-thread vertices into out, then hand out chunks of next
+  auto gather = [&local](std::vector<id_type>& out) {
+    out.clear();
+    for (auto& l : local) {
+      out.insert(out.end(), l.begin(), l.end());
+      l.clear();
+    }
+  };
+  auto after_select = [&]() noexcept {
+    gather(joined);
+    chunks.reset(joined.size(), 256);
+  };
+  auto after_remove = [&]() noexcept { chunks.reset(active.size(), 1024); };
+  auto after_filter = [&]() noexcept {
+    gather(active);
+    done = active.empty();
+    chunks.reset(active.size(), 1024);
+  };
+  std::barrier select_done(static_cast<ptrdiff_t>(T), after_select);
+  std::barrier remove_done(static_cast<ptrdiff_t>(T), after_remove);
+  std::barrier filter_done(static_cast<ptrdiff_t>(T), after_filter);
+
+  parallel_invoke(T, [&](size_t tid) {
+    while (!done) {
+      // Select the undecided vertices that precede all of their undecided neighbors. A neighbor that
+      // joins concurrently is seen as undecided or in the set, and keeps the vertex out either way.
+      chunks.for_each([&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+          const size_t   uid          = static_cast<size_t>(active[i]);
+          const uint64_t uid_priority = _mis_priority(random_seed, uid);
+          bool           ready        = true;
+          for (auto&& uv : edges(g, active[i])) {
+            const size_t vid = static_cast<size_t>(target_id(g, uv));
+            if (vid == uid)
+              continue;
+            const char s = load(vid);
+            if (s == in_set) { // it would be removed by vid next
+              std::atomic_ref<char>(status[uid]).store(removed, std::memory_order_relaxed);
+              ready = false;
+              break;
+            }
+            if (s == undecided && precedes(vid, uid, uid_priority)) {
+              ready = false;
+              break;
+            }
+          }
+          if (ready) {
+            std::atomic_ref<char>(status[uid]).store(in_set, std::memory_order_relaxed);
+            local[tid].push_back(active[i]);
+          }
+        }
+      });
+      select_done.arrive_and_wait();
+
+      // Remove the neighbors of the vertices that joined
+      chunks.for_each([&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+          for (auto&& uv : edges(g, joined[i])) {
+            const size_t vid = static_cast<size_t>(target_id(g, uv));
+            if (load(vid) == undecided)
+              std::atomic_ref<char>(status[vid]).store(removed, std::memory_order_relaxed);
+          }
+        }
+      });
+      remove_done.arrive_and_wait();
+
+      // Keep the vertices that are still undecided for the next round
+      chunks.for_each([&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i)
+          if (status[static_cast<size_t>(active[i])] == undecided)
+            local[tid].push_back(active[i]);
+      });
+      filter_done.arrive_and_wait();
+    }
+  });
+
+  for (size_t uid = 0; uid < N; ++uid)
+    if (status[uid] == in_set)
+      *mis++ = static_cast<id_type>(uid);
+}
+
 } // namespace graph
 
 #endif //GRAPH_MIS_HPP
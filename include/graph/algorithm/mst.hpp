@@ -1,7 +1,7 @@
 /**
  * @file mst.hpp
  * 
- * @brief Minimum spanning tree using Kruskal's and Prim's algorithms.
+ * @brief Minimum spanning tree using Kruskal's, Prim's and Boruvka's algorithms.
  * 
  * @copyright Copyright (c) 2022
  * 
@@ -14,9 +14,18 @@
  */
 
 #include "graph/graph.hpp"
+#include "graph/graph_utility.hpp"
 #include "graph/edgelist.hpp"
+#include "graph/views/incidence.hpp"
 #include "graph/views/edgelist.hpp"
+#include "graph/detail/parallel.hpp"
+#include "graph/detail/concurrent_union_find.hpp"
 #include <queue>
+#include <vector>
+#include <atomic>
+#include <functional>
+#include <array>
+#include <numeric>
 
 #ifndef GRAPH_MST_HPP
 #  define GRAPH_MST_HPP
@@ -187,7 +196,7 @@ void kruskal(IELR&&    e,      // graph
   std::ranges::sort(e_copy, outer_compare);
 
   disjoint_vector<VId> subsets(N + 1);
-  for (VId uid = 0; uid < N; ++uid) {
+  for (VId uid = 0; uid <= N; ++uid) {
     subsets[uid].id    = uid;
     subsets[uid].count = 0;
   }
@@ -257,7 +266,7 @@ void inplace_kruskal(IELR&&    e,      // graph
   std::ranges::sort(e, outer_compare);
 
   disjoint_vector<VId> subsets(N + 1);
-  for (VId uid = 0; uid < N; ++uid) {
+  for (VId uid = 0; uid <= N; ++uid) {
     subsets[uid].id    = uid;
     subsets[uid].count = 0;
   }
@@ -273,6 +282,134 @@ void inplace_kruskal(IELR&&    e,      // graph
   }
 }
 
+template <class VId, class EV, class CompareOp>
+void _filter_kruskal(std::vector<tuple<VId, VId, EV>>& e,
+                     const size_t                      first,
+                     const size_t                      last,
+                     std::vector<VId>&                 parent,
+                     std::vector<tuple<VId, VId, EV>>& tree,
+                     CompareOp&                        compare,
+                     const size_t                      base_size,
+                     const size_t                      num_threads) {
+  const auto e_first  = e.begin();
+  auto       pos      = [e_first](size_t i) { return e_first + static_cast<ptrdiff_t>(i); };
+  auto       scan     = [&](size_t from, size_t to) {
+    for (size_t i = from; i < to; ++i)
+      if (concurrent_union_find(parent, get<0>(e[i]), get<1>(e[i])))
+        tree.push_back(e[i]);
+  };
+  auto       crossing = [&parent](auto&& ed) {
+    return concurrent_find(parent, get<0>(ed)) != concurrent_find(parent, get<1>(ed));
+  };
+
+  if (last - first <= base_size) {
+    parallel_sort(
+          pos(first), pos(last), [&compare](auto&& i, auto&& j) { return compare(get<2>(i), get<2>(j)); },
+          num_threads);
+    scan(first, last);
+    return;
+  }
+
+  // The pivot is the median of evenly spaced samples
+  std::array<EV, 9> samples;
+  for (size_t i = 0; i < samples.size(); ++i)
+    samples[i] = get<2>(e[first + (last - first - 1) * i / (samples.size() - 1)]);
+  std::ranges::nth_element(samples, samples.begin() + 4, compare);
+  const EV pivot = samples[4];
+
+  // Edges lighter than the pivot first, then drop the heavier edges that no longer join two components
+  const size_t light = static_cast<size_t>(
+        parallel_partition(pos(first), pos(last), [&](auto&& ed) { return compare(get<2>(ed), pivot); }, num_threads) -
+        e_first);
+  _filter_kruskal(e, first, light, parent, tree, compare, base_size, num_threads);
+  const size_t kept = static_cast<size_t>(parallel_partition(pos(light), pos(last), crossing, num_threads) - e_first);
+
+  // Edges equal to the pivot need no sorting. The pivot edge is either among them or was dropped, so each
+  // call works on fewer edges than its caller.
+  const size_t equal = static_cast<size_t>(
+        parallel_partition(pos(light), pos(kept), [&](auto&& ed) { return !compare(pivot, get<2>(ed)); }, num_threads) -
+        e_first);
+  scan(light, equal);
+  const size_t heavy = static_cast<size_t>(parallel_partition(pos(equal), pos(kept), crossing, num_threads) - e_first);
+  _filter_kruskal(e, equal, heavy, parent, tree, compare, base_size, num_threads);
+}
+
+/**
+ * @ingroup graph_algorithms
+ * @brief Find the minimum weight spanning tree using the Filter-Kruskal algorithm on multiple threads.
+ * 
+ * Complexity: O(|E| + |V|log|V|log(|E|/|V|)) expected
+ * 
+ * @tparam IELR       The input egelist type.
+ * @tparam OELR       The output edgelist type.
+ * 
+ * @param e           The input edgelist.
+ * @param t           The output edgelist containing the tree.
+ */
+template <x_index_edgelist_range IELR, x_index_edgelist_range OELR>
+void filter_kruskal(IELR&& e, OELR&& t) {
+  filter_kruskal(e, t, [](auto&& i, auto&& j) { return i < j; });
+}
+
+/**
+ * @ingroup graph_algorithms
+ * @brief Find the minimum weight spanning tree using the Filter-Kruskal algorithm on multiple threads.
+ * 
+ * Instead of sorting all the edges like kruskal(), the edges are partitioned around a pivot value and the
+ * lighter ones are processed first. The heavier edges whose vertices are then in the same component are
+ * dropped before they are processed, so only a fraction of the edges of a dense graph are ever sorted.
+ * The partitions, the filters and the sorts of small ranges of edges run on multiple threads, with a
+ * concurrent union-find. The tree edges are output in the order of the comparison, like kruskal().
+ * 
+ * Complexity: O(|E| + |V|log|V|log(|E|/|V|)) expected
+ * 
+ * @tparam IELR       The input egelist type.
+ * @tparam OELR       The output edgelist type.
+ * @tparam CompareOp  The comparison operation type.
+ * 
+ * @param e           The input edgelist.
+ * @param t           The output edgelist containing the tree.
+ * @param compare     The comparison operator.
+ * @param num_threads The number of threads to use, including the calling thread.
+ */
+template <x_index_edgelist_range IELR, x_index_edgelist_range OELR, class CompareOp>
+void filter_kruskal(IELR&&       e,                                    // graph
+                    OELR&&       t,                                    // tree
+                    CompareOp    compare,                              // edge value comparitor
+                    const size_t num_threads = hardware_thread_count() // threads
+) {
+  using edge_info = range_value_t<IELR>;
+  using VId       = remove_const_t<typename edge_info::source_id_type>;
+  using EV        = edge_info::value_type;
+
+  std::vector<tuple<VId, VId, EV>> e_copy;
+  std::ranges::transform(e, back_inserter(e_copy),
+                         [](auto&& ed) { return std::make_tuple(ed.source_id, ed.target_id, ed.value); });
+  if (e_copy.empty())
+    return;
+
+  std::vector<VId> max_id(std::max(num_threads, size_t(1)), VId());
+  parallel_for(e_copy.size(), num_threads, 1 << 14, [&](size_t first, size_t last, size_t tid) {
+    for (size_t i = first; i < last; ++i)
+      max_id[tid] = std::max({max_id[tid], get<0>(e_copy[i]), get<1>(e_copy[i])});
+  });
+  const size_t N = static_cast<size_t>(*std::ranges::max_element(max_id)) + 1;
+
+  std::vector<VId> parent(N);
+  std::iota(parent.begin(), parent.end(), VId());
+  std::vector<tuple<VId, VId, EV>> tree;
+  tree.reserve(N);
+  _filter_kruskal(e_copy, 0, e_copy.size(), parent, tree, compare, std::max(N, size_t(4096)), num_threads);
+
+  t.reserve(t.size() + tree.size());
+  for (auto&& [uid, vid, val] : tree) {
+    t.push_back(range_value_t<OELR>());
+    t.back().source_id = uid;
+    t.back().target_id = vid;
+    t.back().value     = val;
+  }
+}
+
 /**
  * @ingroup graph_algorithms
  * @brief Find the minimum weight spanning tree from a single seed vertex using Prim's algorithm.
@@ -357,6 +494,170 @@ void prim(G&&                   g,           // graph
     }
   }
 }
+
+/**
+ * @ingroup graph_algorithms
+ * @brief Find the minimum weight spanning forest using Boruvka's algorithm on multiple threads.
+ * 
+ * In each round, every vertex finds its lightest edge to another component, each component keeps the
+ * lightest edge of its vertices, and the components are joined along those edges with a concurrent
+ * union-find. The number of components at least halves each round. Ties are broken by the ids of the
+ * edge's vertices, so the chosen edges never form a cycle. Vertices with no edge leaving their component
+ * are dropped, because their edges stay inside it.
+ * 
+ * The graph must be undirected, with each edge stored in both directions with the same weight. The
+ * tree edges are appended to t in no particular order; there is one for each vertex that isn't the
+ * lowest id in its connected component.
+ * 
+ * Complexity: O((|V| + |E|) log|V|) work
+ * 
+ * @tparam G          The graph type.
+ * @tparam OELR       The output edgelist type.
+ * @tparam WF         The edge weight function type.
+ * @tparam CompareOp  The comparison operation type.
+ * 
+ * @param g           The graph.
+ * @param t           The output edgelist containing the tree.
+ * @param weight      The edge weight function, called as weight(uv).
+ * @param compare     The comparison operator.
+ * @param num_threads The number of threads to use, including the calling thread.
+ */
+template <adjacency_list G, x_index_edgelist_range OELR, class WF, class CompareOp = std::less<>>
+requires random_access_range<vertex_range_t<G>> && integral<vertex_id_t<G>> &&
+         std::invocable<WF&, edge_reference_t<G>>
+void parallel_boruvka(G&&          g,                                    // graph
+                      OELR&&       t,                                    // tree
+                      WF&&         weight,                               // edge weight function
+                      CompareOp    compare     = CompareOp(),            // edge value comparitor
+                      const size_t num_threads = hardware_thread_count() // threads
+) {
+  using VId = vertex_id_t<G>;
+  using EV  = std::decay_t<std::invoke_result_t<WF&, edge_reference_t<G>>>;
+  const size_t N(size(vertices(g)));
+  const VId    none = static_cast<VId>(N); // no edge / no vertex
+
+  struct lightest_edge {
+    EV  value     = EV();
+    VId target    = VId();
+    VId component = VId(); // of the source, before this round's unions
+  };
+  // Edge (u, v, w) comes before (x, y, z); the lower id is compared first so both directions are equal
+  auto precedes = [&compare](const EV& w, VId u, VId v, const EV& z, VId x, VId y) {
+    if (compare(w, z))
+      return true;
+    if (compare(z, w))
+      return false;
+    return std::pair(std::min(u, v), std::max(u, v)) < std::pair(std::min(x, y), std::max(x, y));
+  };
+
+  std::vector<VId>           component(N); // the union-find parents, flattened to roots between rounds
+  std::vector<lightest_edge> lightest(N);
+  std::vector<VId>           best(N, none); // the vertex with the lightest edge of each component
+  std::vector<VId>           active(N);
+  parallel_for(N, num_threads, 4096, [&](size_t first, size_t last, size_t) {
+    for (size_t i = first; i < last; ++i)
+      component[i] = active[i] = static_cast<VId>(i);
+  });
+
+  using tree_edge = std::tuple<VId, VId, EV>;
+  std::vector<std::vector<tree_edge>> local(std::max(num_threads, size_t(1)));
+  std::vector<std::vector<VId>>       next(local.size());
+  for (bool joined = true; joined && !active.empty();) {
+    // The lightest edge of each active vertex to another component, and of each component
+    parallel_for(active.size(), num_threads, 256, [&](size_t first, size_t last, size_t tid) {
+      for (size_t i = first; i < last; ++i) {
+        const VId uid  = active[i];
+        const VId cu   = component[static_cast<size_t>(uid)];
+        VId       vbest = none;
+        EV        wbest = EV();
+        for (auto&& uv : edges(g, uid)) {
+          const VId vid = static_cast<VId>(target_id(g, uv));
+          if (component[static_cast<size_t>(vid)] == cu)
+            continue;
+          EV w = weight(uv);
+          if (vbest == none || precedes(w, uid, vid, wbest, uid, vbest)) {
+            vbest = vid;
+            wbest = std::move(w);
+          }
+        }
+        if (vbest == none)
+          continue; // all its edges are inside its component, now and later
+        lightest[static_cast<size_t>(uid)] = {wbest, vbest, cu};
+        next[tid].push_back(uid);
+
+        std::atomic_ref<VId> cbest(best[static_cast<size_t>(cu)]);
+        for (VId current = cbest.load(std::memory_order_acquire);;) {
+          if (current != none) {
+            const lightest_edge& other = lightest[static_cast<size_t>(current)];
+            if (!precedes(wbest, uid, vbest, other.value, current, other.target))
+              break;
+          }
+          if (cbest.compare_exchange_weak(current, uid, std::memory_order_acq_rel))
+            break;
+        }
+      }
+    });
+    active.clear();
+    for (auto& n : next) {
+      active.insert(active.end(), n.begin(), n.end());
+      n.clear();
+    }
+
+    // Join each component to the one at the end of its lightest edge. When two components chose the
+    // same edge, only the first union adds it.
+    std::atomic<bool> any_joined = false;
+    parallel_for(active.size(), num_threads, 1024, [&](size_t first, size_t last, size_t tid) {
+      for (size_t i = first; i < last; ++i) {
+        const VId            uid = active[i];
+        const lightest_edge& uv  = lightest[static_cast<size_t>(uid)];
+        if (best[static_cast<size_t>(uv.component)] != uid)
+          continue;
+        if (concurrent_union_find(component, uid, uv.target)) {
+          local[tid].emplace_back(uid, uv.target, uv.value);
+          any_joined.store(true, std::memory_order_relaxed);
+        }
+      }
+    });
+    joined = any_joined.load();
+
+    // Point every vertex to its root for the next round
+    parallel_for(N, num_threads, 4096, [&](size_t first, size_t last, size_t) {
+      for (size_t i = first; i < last; ++i) {
+        std::atomic_ref<VId>(component[i]).store(concurrent_find(component, static_cast<VId>(i)),
+                                                 std::memory_order_relaxed);
+        best[i]      = none;
+      }
+    });
+  }
+
+  for (auto& edges_found : local) {
+    for (auto&& [uid, vid, val] : edges_found) {
+      t.push_back(range_value_t<OELR>());
+      t.back().source_id = uid;
+      t.back().target_id = vid;
+      t.back().value     = val;
+    }
+  }
+}
+
+/**
+ * @ingroup graph_algorithms
+ * @brief Find the minimum weight spanning forest using Boruvka's algorithm on multiple threads, with
+ * the edge values as weights.
+ * 
+ * @tparam G          The graph type.
+ * @tparam OELR       The output edgelist type.
+ * 
+ * @param g           The graph.
+ * @param t           The output edgelist containing the tree.
+ * @param num_threads The number of threads to use, including the calling thread.
+ */
+template <adjacency_list G, x_index_edgelist_range OELR>
+requires random_access_range<vertex_range_t<G>> && integral<vertex_id_t<G>>
+void parallel_boruvka(G&& g, OELR&& t, const size_t num_threads = hardware_thread_count()) {
+  parallel_boruvka(
+        g, t, [&g](edge_reference_t<G> uv) { return edge_value(g, uv); }, std::less<>(), num_threads);
+}
 } // namespace graph
 
 #endif //GRAPH_MST_HPP
@@ -0,0 +1,506 @@
+/**
+ * @file pagerank.hpp
+ *
+ * @brief PageRank (PR) ranking algorithm.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * SPDX-License-Identifier: BSL-1.0
+ *
+ * @authors
+ *   Muhammad Osama
+ */
+
+#ifndef GRAPH_PAGERANK_HPP
+#define GRAPH_PAGERANK_HPP
+
+#include "graph/graph.hpp"
+#include "graph/detail/parallel.hpp"
+
+#include <algorithm>
+#include <barrier>
+#include <cmath>
+#include <deque>
+#include <format>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+/**
+ * @brief The weight of every edge for pagerank(), when no weight function is given.
+*/
+struct pagerank_unit_weight {
+  template <class E>
+  constexpr double operator()(E&&) const noexcept {
+    return 1.0;
+  }
+};
+
+/**
+ * @brief PageRank (PR) algorithm, pulling the rank of each vertex from its in-edges on multiple threads.
+ *
+ * Each iteration first computes the contribution of every vertex, damping_factor * rank / out-weight,
+ * using the inverse out-weights computed once before the first iteration. Each vertex then sums the
+ * contributions of its in-edges in the transpose, so every rank is written by one thread only and no
+ * atomics are needed; for an unweighted graph the inner loop is a plain gather and add. The rank of
+ * vertices with no out-edges (dangling vertices) is spread over all vertices.
+ *
+ * The iterations stop when the L1 norm of the change in the ranks, the sum of |rank - previous rank|
+ * over all vertices, is less than threshold, or after max_iterations.
+ *
+ * Complexity: O(|V| + |E|) per iteration
+ *
+ * @tparam G        The graph type.
+ * @tparam GT       The graph transpose type.
+ * @tparam PageRank The ranks range type.
+ * @tparam WF       The edge weight function type.
+ *
+ * @param g              The graph.
+ * @param g_t            The transpose of the graph, with the in-edges of each vertex.
+ * @param scores         [out] The page rank of each vertex in the graph, accessible through scores[uid], where
+ *                       uid is the vertex_id. The caller must assure size(scores) >= size(vertices(g)).
+ * @param damping_factor The alpha/damping factor (default = 0.85.)
+ * @param threshold      The L1 error threshold for convergence (default = 1e-6.)
+ * @param max_iterations Maximum number of iterations (default = 100.)
+ * @param weight_fn      The edge weight function, called as weight_fn(uv) for the edges of both g and g_t, which
+ *                       must return the same weight for an edge and its transpose (default returns 1.)
+ * @param num_threads    The number of threads to use, including the calling thread.
+ *
+ * @return The number of iterations.
+ */
+template <adjacency_list      G,
+          adjacency_list      GT,
+          random_access_range PageRank,
+          class WF = pagerank_unit_weight>
+requires random_access_range<vertex_range_t<G>> && integral<vertex_id_t<G>> &&
+         random_access_range<vertex_range_t<GT>> && std::floating_point<range_value_t<PageRank>> &&
+         std::invocable<WF&, edge_reference_t<G>> && std::invocable<WF&, edge_reference_t<GT>>
+size_t pagerank(G&&          g,      // graph
+                GT&&         g_t,    // graph transpose
+                PageRank&    scores, // out: page rank scores
+                const double damping_factor = 0.85,
+                const double threshold      = 1e-6,
+                const size_t max_iterations = 100,
+                WF&&         weight_fn      = WF(),
+                const size_t num_threads    = hardware_thread_count()) {
+  using weight_type           = range_value_t<PageRank>;
+  constexpr bool   unweighted = std::is_same_v<std::remove_cvref_t<WF>, pagerank_unit_weight>;
+  constexpr size_t chunk      = 1024;
+  const size_t     N(size(vertices(g)));
+  if (N == 0)
+    return 0;
+  if (size(vertices(g_t)) != N)
+    throw std::out_of_range(
+          std::format("pagerank: the transpose has {} vertices instead of {}", size(vertices(g_t)), N));
+
+  // damping_factor / (sum of outgoing weights), or 0 for a dangling vertex
+  std::vector<weight_type> inverse_out(N);
+  parallel_for(N, num_threads, chunk, [&](size_t first, size_t last, size_t) {
+    for (size_t uid = first; uid < last; ++uid) {
+      weight_type out = 0;
+      if constexpr (unweighted) {
+        out = static_cast<weight_type>(std::ranges::distance(edges(g, static_cast<vertex_id_t<G>>(uid))));
+      } else {
+        for (auto&& uv : edges(g, static_cast<vertex_id_t<G>>(uid)))
+          out += static_cast<weight_type>(weight_fn(uv));
+      }
+      inverse_out[uid] = (out != 0) ? static_cast<weight_type>(damping_factor) / out : 0;
+    }
+  });
+
+  std::vector<weight_type> rank(N, weight_type(1) / static_cast<weight_type>(N));
+  std::vector<weight_type> contribution(N);
+
+  // Per-thread sums, on separate cache lines
+  struct alignas(64) partial_sum {
+    double value = 0;
+  };
+  const size_t             T = std::max(std::min(num_threads, (N + chunk - 1) / chunk), size_t(1));
+  std::vector<partial_sum> dangling(T), error(T);
+
+  dynamic_chunks chunks(N, chunk);
+  weight_type    base       = 0; // the rank every vertex gets from teleporting and the dangling vertices
+  size_t         iterations = 0;
+  bool           done       = (max_iterations == 0);
+
+  auto sum = [](std::vector<partial_sum>& partials) {
+    double total = 0;
+    for (auto& p : partials) {
+      total += p.value;
+      p.value = 0;
+    }
+    return total;
+  };
+  auto after_contribution = [&]() noexcept {
+    base = static_cast<weight_type>((1 - damping_factor + damping_factor * sum(dangling)) / static_cast<double>(N));
+    chunks.reset(N, chunk);
+  };
+  auto after_gather = [&]() noexcept {
+    ++iterations;
+    done = sum(error) < threshold || iterations >= max_iterations;
+    chunks.reset(N, chunk);
+  };
+  std::barrier contribution_done(static_cast<ptrdiff_t>(T), after_contribution);
+  std::barrier gather_done(static_cast<ptrdiff_t>(T), after_gather);
+
+  parallel_invoke(T, [&](size_t tid) {
+    while (!done) {
+      chunks.for_each([&](size_t first, size_t last) {
+        double local = 0;
+        for (size_t uid = first; uid < last; ++uid) {
+          contribution[uid] = rank[uid] * inverse_out[uid];
+          if (inverse_out[uid] == 0)
+            local += rank[uid];
+        }
+        dangling[tid].value += local;
+      });
+      contribution_done.arrive_and_wait();
+
+      chunks.for_each([&](size_t first, size_t last) {
+        double local = 0;
+        for (size_t vid = first; vid < last; ++vid) {
+          weight_type in = 0;
+          for (auto&& vu : edges(g_t, static_cast<vertex_id_t<GT>>(vid))) {
+            if constexpr (unweighted)
+              in += contribution[static_cast<size_t>(target_id(g_t, vu))];
+            else
+              in += contribution[static_cast<size_t>(target_id(g_t, vu))] * static_cast<weight_type>(weight_fn(vu));
+          }
+          const weight_type next = base + in;
+          local += std::abs(static_cast<double>(next - rank[vid]));
+          rank[vid] = next;
+        }
+        error[tid].value += local;
+      });
+      gather_done.arrive_and_wait();
+    }
+  });
+
+  std::ranges::copy(rank, scores.begin());
+  return iterations;
+}
+
+/**
+ * @brief Updates PageRank scores after edges have been inserted into or deleted from a graph, by pushing only the
+ * change in the ranks instead of recomputing them from 1/N.
+ *
+ * The scores must be the ranks of the graph before the update, converged with a small threshold (e.g. from
+ * pagerank() with unit weights), and g must be the graph after the update. The update changes the contributions of
+ * the sources of the inserted and deleted edges only, so the initial residuals, the difference between the two sides
+ * of the PageRank equation, are non-zero only for their old and new targets. Residuals are then pushed in the
+ * Gauss-Southwell manner: a vertex whose residual is above threshold / N adds it to its rank and passes
+ * damping_factor / out-degree of it to each of its targets, until no residual is above threshold / N. Vertices are
+ * pushed in first-in first-out order, which avoids the cost of always finding the largest residual.
+ *
+ * The rank pushed from a dangling vertex goes to every vertex. It's kept as a single uniform residual, and since
+ * PageRank is linear in the teleport vector, which is uniform too, it's applied at the end by scaling the scores.
+ *
+ * The work is proportional to the number of pushes times the out-degree of the pushed vertices, which is a small
+ * part of a full recomputation when few edges change. Edges have unit weights. The number of vertices must not change.
+ *
+ * Complexity: O(|V| + |updates| + sum of the out-degrees of the pushed vertices)
+ *
+ * @tparam G        The graph type.
+ * @tparam PageRank The ranks range type.
+ * @tparam Inserted The range type of the inserted edges.
+ * @tparam Deleted  The range type of the deleted edges.
+ *
+ * @param g              The graph, after the update.
+ * @param scores         [inout] The page rank of each vertex before the update, replaced with the page rank after it.
+ * @param inserted       The inserted edges, with source_id and target_id members (e.g. edge_info).
+ * @param deleted        The deleted edges, with source_id and target_id members (e.g. edge_info).
+ * @param damping_factor The alpha/damping factor (default = 0.85), which must be less than 1.
+ * @param threshold      The limit for the L1 norm of the residuals (default = 1e-6.)
+ *
+ * @return The number of pushes.
+ */
+template <adjacency_list G, random_access_range PageRank, forward_range Inserted, forward_range Deleted>
+requires random_access_range<vertex_range_t<G>> && integral<vertex_id_t<G>> &&
+         std::floating_point<range_value_t<PageRank>> && requires(range_value_t<Inserted> e, range_value_t<Deleted> f) {
+           { e.source_id } -> std::convertible_to<vertex_id_t<G>>;
+           { e.target_id } -> std::convertible_to<vertex_id_t<G>>;
+           { f.source_id } -> std::convertible_to<vertex_id_t<G>>;
+           { f.target_id } -> std::convertible_to<vertex_id_t<G>>;
+         }
+size_t incremental_pagerank(G&&             g,        // graph after the update
+                            PageRank&       scores,   // in/out: page rank scores
+                            const Inserted& inserted, // inserted edges
+                            const Deleted&  deleted,  // deleted edges
+                            const double    damping_factor = 0.85,
+                            const double    threshold      = 1e-6) {
+  using id_type     = vertex_id_t<G>;
+  using weight_type = range_value_t<PageRank>;
+  const size_t N(size(vertices(g)));
+  if (size(scores) < N)
+    throw std::out_of_range(std::format("incremental_pagerank: {} scores for {} vertices", size(scores), N));
+
+  auto check = [N](auto&& e) {
+    if (std::cmp_less(e.source_id, 0) || std::cmp_greater_equal(e.source_id, N) || std::cmp_less(e.target_id, 0) ||
+        std::cmp_greater_equal(e.target_id, N))
+      throw std::out_of_range(std::format("incremental_pagerank: edge ({},{}) isn't in a graph of {} vertices",
+                                          e.source_id, e.target_id, N));
+    return static_cast<size_t>(e.source_id);
+  };
+  auto out_degree = [&g](size_t uid) {
+    return static_cast<ptrdiff_t>(std::ranges::distance(edges(g, static_cast<id_type>(uid))));
+  };
+
+  // The change in the out-degree of each source
+  std::vector<ptrdiff_t> degree_change(N, 0);
+  std::vector<size_t>    sources;
+  std::vector<char>      is_source(N, false);
+  auto                   add_source = [&](size_t uid, ptrdiff_t change) {
+    degree_change[uid] += change;
+    if (!is_source[uid]) {
+      is_source[uid] = true;
+      sources.push_back(uid);
+    }
+  };
+  for (auto&& e : inserted)
+    add_source(check(e), 1);
+  for (auto&& e : deleted)
+    add_source(check(e), -1);
+
+  const weight_type d = static_cast<weight_type>(damping_factor);
+  const weight_type n = static_cast<weight_type>(N);
+  auto              share = [](weight_type x, ptrdiff_t out) {
+    return out > 0 ? x / static_cast<weight_type>(out) : weight_type(0);
+  };
+  auto old_degree = [&](size_t uid) {
+    const ptrdiff_t out = out_degree(uid) - degree_change[uid];
+    if (out < 0)
+      throw std::out_of_range(std::format("incremental_pagerank: more edges inserted from {} than it has", uid));
+    return out;
+  };
+
+  // Residual = damping_factor * (new transition - old transition) * old scores. Each new edge gets the new share
+  // less the old share, the inserted edges get the old share back as they weren't old edges, and the deleted edges
+  // lose the old share.
+  std::vector<weight_type> residual(N, 0);
+  weight_type              uniform = 0; // residual of every vertex, from the dangling vertices
+  for (size_t uid : sources) {
+    const ptrdiff_t   old_out = old_degree(uid), new_out = out_degree(uid);
+    const weight_type x    = d * static_cast<weight_type>(scores[uid]);
+    const weight_type diff = share(x, new_out) - share(x, old_out);
+    if (diff != 0)
+      for (auto&& uv : edges(g, static_cast<id_type>(uid)))
+        residual[static_cast<size_t>(target_id(g, uv))] += diff;
+    if (old_out == 0 && new_out > 0)
+      uniform -= x / n;
+    else if (old_out > 0 && new_out == 0)
+      uniform += x / n;
+  }
+  for (auto&& e : inserted) {
+    const size_t uid = check(e);
+    residual[static_cast<size_t>(e.target_id)] += share(d * static_cast<weight_type>(scores[uid]), old_degree(uid));
+  }
+  for (auto&& e : deleted) {
+    const size_t uid = check(e);
+    residual[static_cast<size_t>(e.target_id)] -= share(d * static_cast<weight_type>(scores[uid]), old_degree(uid));
+  }
+
+  const weight_type   limit = static_cast<weight_type>(threshold) / n;
+  std::deque<size_t>  queue;
+  std::vector<char>   queued(N, false);
+  for (size_t uid = 0; uid < N; ++uid) {
+    if (std::abs(residual[uid]) > limit) {
+      queue.push_back(uid);
+      queued[uid] = true;
+    }
+  }
+
+  size_t pushes = 0;
+  while (!queue.empty()) {
+    const size_t uid = queue.front();
+    queue.pop_front();
+    queued[uid]         = false;
+    const weight_type r = residual[uid];
+    residual[uid]       = 0;
+    scores[uid] += r;
+    ++pushes;
+
+    const ptrdiff_t out = out_degree(uid);
+    if (out == 0) {
+      uniform += d * r / n;
+      continue;
+    }
+    const weight_type pushed = share(d * r, out);
+    for (auto&& uv : edges(g, static_cast<id_type>(uid))) {
+      const size_t vid = static_cast<size_t>(target_id(g, uv));
+      residual[vid] += pushed;
+      if (!queued[vid] && std::abs(residual[vid]) > limit) {
+        queue.push_back(vid);
+        queued[vid] = true;
+      }
+    }
+  }
+
+  // The uniform residual was never added to the scores, so they solve the PageRank equation with
+  // (1 - damping_factor) / N - uniform as the teleport term: they're the ranks scaled by
+  // 1 - uniform * N / (1 - damping_factor)
+  if (uniform != 0) {
+    const weight_type scale = 1 - uniform * n / (1 - d);
+    for (size_t uid = 0; uid < N; ++uid)
+      scores[uid] /= scale;
+  }
+  return pushes;
+}
+
+/**
+ * @brief Approximate personalized PageRank (PPR) from a set of seed vertices, with the Andersen-Chung-Lang forward
+ * push algorithm.
+ *
+ * The personalized PageRank of a vertex is the probability of ending there in a random walk that starts at a seed
+ * chosen uniformly at random, and at each step stops with probability 1 - damping_factor or otherwise follows a
+ * random out-edge. Walks that reach a dangling vertex return to the seeds.
+ *
+ * Each seed starts with a residual of 1 / size(seeds). Pushing a vertex adds (1 - damping_factor) of its residual
+ * to its rank and spreads the rest evenly over its out-edges. Only vertices whose residual is at least epsilon times
+ * their out-degree are pushed, so the work and the memory are proportional to the vertices touched and independent
+ * of the size of the graph: the ranks and residuals are kept in hash maps instead of arrays of size(vertices(g)).
+ * When it returns, the residual left at each vertex is less than epsilon times its out-degree (or epsilon for a
+ * dangling vertex), and every rank is a lower bound of the exact rank.
+ *
+ * Complexity: O(1 / ((1 - damping_factor) * epsilon)) pushes and edges examined
+ *
+ * @tparam G     The graph type.
+ * @tparam Seeds The seed range type.
+ * @tparam PPR   The ranks map type, e.g. std::unordered_map<vertex_id_t<G>, double>.
+ *
+ * @param g              The graph.
+ * @param seeds          The seed vertex ids. A seed that appears more than once gets a larger share.
+ * @param ppr            [out] The rank of each vertex with a non-zero rank, accessible through ppr[uid]. It's
+ *                       cleared first.
+ * @param damping_factor The alpha/damping factor (default = 0.85.)
+ * @param epsilon        The residual threshold per out-edge (default = 1e-6.)
+ *
+ * @return The number of pushes.
+ */
+template <adjacency_list G, forward_range Seeds, class PPR>
+requires random_access_range<vertex_range_t<G>> && integral<vertex_id_t<G>> &&
+         std::convertible_to<range_value_t<Seeds>, vertex_id_t<G>> && requires(PPR& ppr, vertex_id_t<G> uid) {
+           ppr.clear();
+           ppr[uid] += 1.0;
+         }
+size_t personalized_pagerank(G&&          g,     // graph
+                             const Seeds& seeds, // seed vertex ids
+                             PPR&         ppr,   // out: sparse ranks
+                             const double damping_factor = 0.85,
+                             const double epsilon        = 1e-6) {
+  using id_type = vertex_id_t<G>;
+  struct residual_state {
+    double value  = 0;
+    bool   queued = false;
+  };
+  const size_t N(size(vertices(g)));
+  ppr.clear();
+
+  std::vector<id_type> seed_ids;
+  for (auto&& seed : seeds) {
+    const id_type uid = static_cast<id_type>(seed);
+    if (std::cmp_less(uid, 0) || std::cmp_greater_equal(uid, N))
+      throw std::out_of_range(
+            std::format("personalized_pagerank: seed id {} is not in a graph of {} vertices", uid, N));
+    seed_ids.push_back(uid);
+  }
+  if (seed_ids.empty())
+    return 0;
+
+  std::unordered_map<id_type, residual_state> residual;
+  std::deque<id_type>                         queue;
+  auto                                        out_degree = [&g](id_type uid) {
+    return static_cast<size_t>(std::ranges::distance(edges(g, uid)));
+  };
+  // Adds to the residual of a vertex, queueing it if it reaches its threshold
+  auto add = [&](id_type uid, double value) {
+    residual_state& r = residual[uid];
+    r.value += value;
+    if (!r.queued && r.value >= epsilon * static_cast<double>(std::max(out_degree(uid), size_t(1)))) {
+      r.queued = true;
+      queue.push_back(uid);
+    }
+  };
+
+  const double seed_share = 1.0 / static_cast<double>(seed_ids.size());
+  for (id_type uid : seed_ids)
+    add(uid, seed_share);
+
+  size_t pushes = 0;
+  while (!queue.empty()) {
+    const id_type uid = queue.front();
+    queue.pop_front();
+    residual_state& r     = residual[uid];
+    const double    value = r.value;
+    r                     = residual_state();
+    ppr[uid] += (1 - damping_factor) * value;
+    ++pushes;
+
+    const size_t out = out_degree(uid);
+    if (out == 0) {
+      for (id_type sid : seed_ids)
+        add(sid, damping_factor * value * seed_share);
+      continue;
+    }
+    const double pushed = damping_factor * value / static_cast<double>(out);
+    for (auto&& uv : edges(g, uid))
+      add(static_cast<id_type>(target_id(g, uv)), pushed);
+  }
+  return pushes;
+}
+
+/**
+ * @brief Approximate personalized PageRank for a batch of seed sets, with personalized_pagerank() run for several
+ * seed sets at once on num_threads threads.
+ *
+ * Each thread takes the next seed set when it finishes one, so sets that touch many vertices don't hold up the
+ * others.
+ *
+ * @tparam G        The graph type.
+ * @tparam SeedSets The range type of the seed sets.
+ * @tparam PPRs     The range type of the ranks maps.
+ *
+ * @param g              The graph.
+ * @param seed_sets      The seed sets, each a range of vertex ids.
+ * @param pprs           [out] The sparse ranks for each seed set, accessible through pprs[i][uid]. The caller must
+ *                       assure size(pprs) >= size(seed_sets).
+ * @param damping_factor The alpha/damping factor (default = 0.85.)
+ * @param epsilon        The residual threshold per out-edge (default = 1e-6.)
+ * @param num_threads    The number of threads to use, including the calling thread.
+ *
+ * @return The total number of pushes.
+ */
+template <adjacency_list G, random_access_range SeedSets, random_access_range PPRs>
+requires random_access_range<vertex_range_t<G>> && integral<vertex_id_t<G>> && forward_range<range_value_t<SeedSets>>
+size_t personalized_pagerank(G&&             g,         // graph
+                             const SeedSets& seed_sets, // seed vertex ids of each query
+                             PPRs&           pprs,      // out: sparse ranks of each query
+                             const double    damping_factor = 0.85,
+                             const double    epsilon        = 1e-6,
+                             const size_t    num_threads = hardware_thread_count()) {
+  const size_t Q = size(seed_sets);
+  if (size(pprs) < Q)
+    throw std::out_of_range(std::format("personalized_pagerank: {} results for {} seed sets", size(pprs), Q));
+
+  struct alignas(64) pushes_count {
+    size_t value = 0;
+  };
+  std::vector<pushes_count> pushes(std::max(num_threads, size_t(1)));
+  parallel_for(Q, num_threads, 1, [&](size_t first, size_t last, size_t tid) {
+    for (size_t q = first; q < last; ++q)
+      pushes[tid].value += personalized_pagerank(g, seed_sets[q], pprs[q], damping_factor, epsilon);
+  });
+
+  size_t total = 0;
+  for (auto& p : pushes)
+    total += p.value;
+  return total;
+}
+
+} // namespace graph
+
+#endif // GRAPH_PAGERANK_HPP
@@ -0,0 +1,474 @@
+/**
+ * @file random_walk.hpp
+ *
+ * @brief Weighted neighbor sampling with alias tables, and random walks for graph embeddings: first-order
+ * (DeepWalk) walks and second-order node2vec walks.
+ *
+ * An alias_table holds, for every edge of every vertex, the probability and alias of Walker's alias method, laid
+ * out in the same order as the edges. A weighted pick from the edges of a vertex then takes one random number and
+ * two reads, whatever the degree of the vertex. The walks and neighbor samples are generated on multiple threads
+ * into a flat output range.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: BSL-1.0
+ *
+ * @authors
+ */
+
+#include "graph/graph.hpp"
+#include "graph/algorithm/common_shortest_paths.hpp"
+#include "graph/detail/parallel.hpp"
+
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <random>
+#include <cstdint>
+#include <stdexcept>
+#include <format>
+
+#ifndef GRAPH_RANDOM_WALK_HPP
+#  define GRAPH_RANDOM_WALK_HPP
+
+namespace graph {
+
+/**
+ * @ingroup graph_algorithms
+ * @brief Alias tables for picking an edge of any vertex with a probability proportional to its weight, in O(1).
+ *
+ * The table of a vertex has an entry for each of its edges, in the order of edges(g,uid), and the tables of all
+ * vertices are stored one after the other, so the entries of uid are at [first(uid), first(uid) + degree). For a
+ * compressed_graph, first(uid) is the edge index of the first edge of uid. Entry k has the probability of keeping
+ * edge k and the edge to use otherwise (the alias). A pick chooses an entry uniformly and keeps it or takes its
+ * alias, with a single random number.
+ *
+ * A table takes 8 bytes per edge and 16 bytes per vertex. It is built in parallel with Vose's algorithm, and can be
+ * shared by any number of threads. It must be used with the graph it was built for, and rebuilt if the graph
+ * changes.
+ */
+class alias_table {
+public:
+  alias_table() = default;
+
+  /**
+   * @brief Builds the alias tables of all the vertices of a graph.
+   *
+   * Throws:
+   *  - out_of_range if the weight of an edge is negative, or if a vertex has 2^32 edges or more.
+   *
+   * @param g           The graph.
+   * @param weight      The edge weight function, which must return non-negative weights (default returns 1.)
+   * @param num_threads The number of threads to use, including the calling thread.
+  */
+  template <index_adjacency_list G, class WF = unit_edge_weight<double>>
+  requires random_access_range<vertex_edge_range_t<G>> &&
+           is_arithmetic_v<remove_cvref_t<invoke_result_t<WF, edge_reference_t<G>>>>
+  explicit alias_table(G&& g, WF&& weight = unit_edge_weight<double>(), size_t num_threads = hardware_thread_count()) {
+    using id_type  = vertex_id_t<G>;
+    const size_t N(size(vertices(g)));
+    num_threads    = std::max(std::min(num_threads, (N + 1023) / 1024), size_t(1));
+
+    first_.resize(N + 1);
+    total_.resize(N);
+    first_[0] = 0;
+    for (size_t uid = 0; uid < N; ++uid) {
+      first_[uid + 1] = first_[uid] + static_cast<size_t>(degree(g, static_cast<id_type>(uid)));
+    }
+    prob_.resize(first_[N]);
+    alias_.resize(first_[N]);
+
+    struct alignas(64) thread_state {
+      std::vector<double>   scaled;
+      std::vector<uint32_t> small, large;
+      bool                  sorted = true;
+    };
+    std::vector<thread_state> state(num_threads);
+    parallel_for(N, num_threads, 256, [&](size_t v_first, size_t v_last, size_t tid) {
+      thread_state& s = state[tid];
+      for (size_t uid = v_first; uid < v_last; ++uid) {
+        const size_t n = first_[uid + 1] - first_[uid];
+        if (n > std::numeric_limits<uint32_t>::max()) {
+          throw std::out_of_range(std::format("alias_table: vertex {} has too many edges ({})", uid, n));
+        }
+        s.scaled.clear();
+        double  total = 0;
+        id_type last  = 0;
+        for (auto&& uv : edges(g, static_cast<id_type>(uid))) {
+          const double w = static_cast<double>(weight(uv));
+          if (!(w >= 0)) {
+            throw std::out_of_range(std::format("alias_table: the weight {} of an edge of {} is negative", w, uid));
+          }
+          const id_type vid = target_id(g, uv);
+          s.sorted          = s.sorted && (s.scaled.empty() || last <= vid);
+          last              = vid;
+          s.scaled.push_back(w);
+          total += w;
+        }
+        total_[uid] = total;
+        if (total > 0) {
+          _build(s.scaled, total, first_[uid], s.small, s.large);
+        }
+      }
+    });
+    sorted_ = std::ranges::all_of(state, [](const thread_state& s) { return s.sorted; });
+  }
+
+  constexpr size_t num_vertices() const noexcept { return total_.size(); }
+  constexpr size_t num_edges() const noexcept { return prob_.size(); }
+
+  /**
+   * @brief The position of the table of uid, which is the index of its first edge in a compressed_graph.
+  */
+  size_t first(size_t uid) const noexcept { return first_[uid]; }
+
+  /**
+   * @brief The sum of the weights of the edges of uid.
+  */
+  double total_weight(size_t uid) const noexcept { return total_[uid]; }
+
+  /**
+   * @brief Can an edge of uid be picked? A vertex with no edges, or with edges of weight 0 only, is a dead end.
+  */
+  bool can_sample(size_t uid) const noexcept { return total_[uid] > 0; }
+
+  /**
+   * @brief Are the edges of every vertex ordered by target id? This lets a walk look for an edge with a binary
+   * search.
+  */
+  bool sorted() const noexcept { return sorted_; }
+
+  /**
+   * @brief Picks an edge of uid with a probability proportional to its weight. can_sample(uid) must be true.
+   *
+   * @return The position of the edge in edges(g,uid).
+  */
+  template <class URBG>
+  size_t sample(size_t uid, URBG& gen) const {
+    const size_t first = first_[uid], n = first_[uid + 1] - first;
+    const double x     = std::uniform_real_distribution<double>(0.0, static_cast<double>(n))(gen);
+    const size_t k     = std::min(static_cast<size_t>(x), n - 1);
+    return (x - static_cast<double>(k) < static_cast<double>(prob_[first + k])) ? k : alias_[first + k];
+  }
+
+private:
+  // Vose's alias method for the weights in scaled, summing to total, into the entries starting at first
+  void _build(std::vector<double>&   scaled,
+              const double           total,
+              const size_t           first,
+              std::vector<uint32_t>& small,
+              std::vector<uint32_t>& large) {
+    const size_t n = scaled.size();
+    small.clear();
+    large.clear();
+    for (size_t k = 0; k < n; ++k) {
+      scaled[k] *= static_cast<double>(n) / total;
+      (scaled[k] < 1.0 ? small : large).push_back(static_cast<uint32_t>(k));
+    }
+    while (!small.empty() && !large.empty()) {
+      const uint32_t s = small.back(), l = large.back();
+      small.pop_back();
+      prob_[first + s]  = static_cast<float>(scaled[s]);
+      alias_[first + s] = l;
+      scaled[l] -= 1.0 - scaled[s];
+      if (scaled[l] < 1.0) {
+        large.pop_back();
+        small.push_back(l);
+      }
+    }
+    // What's left has a probability of 1, apart from rounding
+    for (uint32_t k : large) {
+      prob_[first + k]  = 1.0f;
+      alias_[first + k] = k;
+    }
+    for (uint32_t k : small) {
+      prob_[first + k]  = 1.0f;
+      alias_[first + k] = k;
+    }
+  }
+
+  std::vector<size_t>   first_; // the table of uid is [first_[uid], first_[uid + 1])
+  std::vector<double>   total_;
+  std::vector<float>    prob_;
+  std::vector<uint32_t> alias_; // the position of the alias in the edges of the vertex
+  bool                  sorted_ = true;
+};
+
+/**
+ * @brief Is there an edge from uid to vid? Uses a binary search when the edges are ordered by target id.
+*/
+template <index_adjacency_list G>
+requires random_access_range<vertex_edge_range_t<G>>
+bool _has_edge(G&& g, const vertex_id_t<G> uid, const vertex_id_t<G> vid, const bool sorted) {
+  auto&& uv_range = edges(g, uid);
+  auto   target   = [&g](auto&& uv) { return target_id(g, uv); };
+  if (sorted) {
+    auto it = std::ranges::lower_bound(uv_range, vid, {}, target);
+    return it != std::ranges::end(uv_range) && target(*it) == vid;
+  }
+  return std::ranges::find(uv_range, vid, target) != std::ranges::end(uv_range);
+}
+
+/**
+ * @ingroup graph_algorithms
+ * @brief Second-order biased random walks of node2vec, from each start vertex, on multiple threads.
+ *
+ * A walk from t to v picks its next vertex x with a probability proportional to the weight of the edge to x
+ * times a bias of 1/p if x is t, 1 if x is a neighbor of t, and 1/q otherwise. A low p keeps the walk close to
+ * where it has been, like a breadth-first search, and a low q sends it outwards, like a depth-first search. The
+ * first step of a walk, and every step when p == q == 1, is a weighted pick with the alias table.
+ *
+ * The bias is applied by rejection sampling: x is picked with the alias table of v and kept with a probability of
+ * its bias over the largest bias, otherwise another x is picked. This needs no table per pair of vertices, and the
+ * only extra work is to look for the edge from t to x, with a binary search when table.sorted().
+ *
+ * The walk from starts[i] is written to walks[i * walk_length, (i + 1) * walk_length), starting with starts[i].
+ * A walk that reaches a vertex it can't leave stops there, and the rest of its entries are set to the largest
+ * value of the range's element type. Each thread has its own random number generator, which is seeded again
+ * for each chunk of walks from seed and the chunk's position, so the walks depend only on the seed and not on the
+ * number of threads.
+ *
+ * The graph is usually undirected, with each edge stored in both directions, but directed graphs can be used.
+ *
+ * Complexity: O(walks * walk_length) picks, each with an expected number of tries of at most
+ * max(1/p, 1, 1/q) / min(1/p, 1, 1/q), and O(log(degree)) for each try when p or q isn't 1 and the edges are sorted
+ *
+ * Throws:
+ *  - out_of_range if table wasn't built for a graph with the same number of vertices, if a start vertex is out of
+ *    range, if walks is smaller than size(starts) * walk_length, or if p or q isn't positive.
+ *
+ * @tparam G      The graph type.
+ * @tparam Starts The random access range of start vertex ids.
+ * @tparam Walks  The random access range of vertex ids for the walks.
+ *
+ * @param g           The graph.
+ * @param table       The alias tables of g.
+ * @param starts      The start vertex of each walk.
+ * @param walk_length The number of vertices in each walk, including the start vertex.
+ * @param walks       [out] The walks, one after the other.
+ * @param p           The return parameter.
+ * @param q           The in-out parameter.
+ * @param seed        The seed for the random number generators.
+ * @param num_threads The number of threads to use, including the calling thread.
+ *
+ * @return The number of vertices written for all the walks, not counting the entries after a dead end.
+ */
+template <index_adjacency_list G, random_access_range Starts, random_access_range Walks>
+requires random_access_range<vertex_edge_range_t<G>> && convertible_to<range_value_t<Starts>, vertex_id_t<G>> &&
+         integral<range_value_t<Walks>> && sized_range<Starts> && sized_range<Walks>
+size_t node2vec_walks(G&&                g,
+                      const alias_table& table,
+                      const Starts&      starts,
+                      const size_t       walk_length,
+                      Walks&             walks,
+                      const double       p           = 1.0,
+                      const double       q           = 1.0,
+                      const uint64_t     seed        = 0,
+                      size_t             num_threads = hardware_thread_count()) {
+  using id_type              = vertex_id_t<G>;
+  using walk_type            = range_value_t<Walks>;
+  constexpr size_t chunk     = 256;
+  const size_t     N         = num_vertices(g);
+  const size_t     num_walks = size(starts);
+
+  if (table.num_vertices() != N) {
+    throw std::out_of_range(
+          std::format("node2vec_walks: the alias table has {} vertices instead of {}", table.num_vertices(), N));
+  }
+  if (size(walks) < num_walks * walk_length) {
+    throw std::out_of_range(std::format("node2vec_walks: size of walks of {} is less than {} walks of length {}",
+                                        size(walks), num_walks, walk_length));
+  }
+  if (!(p > 0) || !(q > 0)) {
+    throw std::out_of_range(std::format("node2vec_walks: p {} and q {} must be positive", p, q));
+  }
+  for (auto&& start : starts) {
+    if (static_cast<size_t>(start) >= N) {
+      throw std::out_of_range(std::format("node2vec_walks: start vertex id '{}' is out of range", start));
+    }
+  }
+  if (walk_length == 0) {
+    return 0;
+  }
+  num_threads = std::max(std::min(num_threads, (num_walks + chunk - 1) / chunk), size_t(1));
+
+  // The bias of x over the largest bias, for a walk from t to v
+  const bool   biased     = (p != 1.0 || q != 1.0);
+  const double max_bias   = std::max({1.0 / p, 1.0, 1.0 / q});
+  const double return_to  = (1.0 / p) / max_bias;
+  const double stay_close = 1.0 / max_bias;
+  const double move_away  = (1.0 / q) / max_bias;
+
+  struct alignas(64) thread_state {
+    std::mt19937_64 gen;
+    size_t          steps = 0;
+  };
+  std::vector<thread_state> state(num_threads);
+  parallel_for(num_walks, num_threads, chunk, [&](size_t w_first, size_t w_last, size_t tid) {
+    std::mt19937_64&                       gen = state[tid].gen;
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    for (size_t i = w_first; i < w_last; ++i) {
+      if (i % chunk == 0) { // a single thread is given all the walks at once
+        gen.seed(seed + (i / chunk) * 0x9E3779B97F4A7C15ull);
+      }
+      auto    out  = std::ranges::begin(walks) + static_cast<std::ptrdiff_t>(i * walk_length);
+      id_type prev = 0, cur = static_cast<id_type>(starts[i]);
+      size_t  len  = 1;
+      out[0]       = static_cast<walk_type>(cur);
+      for (; len < walk_length && table.can_sample(static_cast<size_t>(cur)); ++len) {
+        auto&& uv_range = edges(g, cur);
+        using edge_diff = std::ranges::range_difference_t<decltype(uv_range)>;
+        auto sample_edge = [&]() -> decltype(auto) {
+          return *std::ranges::next(std::ranges::begin(uv_range),
+                                    static_cast<edge_diff>(table.sample(static_cast<size_t>(cur), gen)));
+        };
+        id_type next = target_id(g, sample_edge());
+        if (biased && len > 1) {
+          for (;;) {
+            const double accept = (next == prev)                             ? return_to
+                                  : _has_edge(g, prev, next, table.sorted()) ? stay_close
+                                                                             : move_away;
+            if (accept >= 1.0 || coin(gen) < accept) {
+              break;
+            }
+            next = target_id(g, sample_edge());
+          }
+        }
+        out[static_cast<std::ptrdiff_t>(len)] = static_cast<walk_type>(next);
+        prev                                  = cur;
+        cur                                   = next;
+      }
+      state[tid].steps += len;
+      std::fill(out + static_cast<std::ptrdiff_t>(len), out + static_cast<std::ptrdiff_t>(walk_length),
+                std::numeric_limits<walk_type>::max());
+    }
+  });
+
+  size_t steps = 0;
+  for (auto& s : state) {
+    steps += s.steps;
+  }
+  return steps;
+}
+
+/**
+ * @ingroup graph_algorithms
+ * @brief First-order random walks of DeepWalk, from each start vertex, on multiple threads. Each step picks an
+ * edge of the current vertex with a probability proportional to its weight, with the alias table.
+ *
+ * This is node2vec_walks() with p == q == 1. See it for the layout of walks and the exceptions thrown.
+ *
+ * @return The number of vertices written for all the walks, not counting the entries after a dead end.
+ */
+template <index_adjacency_list G, random_access_range Starts, random_access_range Walks>
+requires random_access_range<vertex_edge_range_t<G>> && convertible_to<range_value_t<Starts>, vertex_id_t<G>> &&
+         integral<range_value_t<Walks>> && sized_range<Starts> && sized_range<Walks>
+size_t random_walks(G&&                g,
+                    const alias_table& table,
+                    const Starts&      starts,
+                    const size_t       walk_length,
+                    Walks&             walks,
+                    const uint64_t     seed        = 0,
+                    size_t             num_threads = hardware_thread_count()) {
+  return node2vec_walks(g, table, starts, walk_length, walks, 1.0, 1.0, seed, num_threads);
+}
+
+/**
+ * @ingroup graph_algorithms
+ * @brief Samples fanout neighbors of each seed vertex, with replacement and with probabilities proportional to the
+ * edge weights, on multiple threads, as for a minibatch of a graph neural network.
+ *
+ * The neighbors of seeds[i] are written to samples[i * fanout, (i + 1) * fanout). The entries of a seed that can't
+ * be sampled are set to the largest value of the range's element type. The samples depend only on the seed of the
+ * random number generators, and not on the number of threads.
+ *
+ * Complexity: O(size(seeds) * fanout)
+ *
+ * Throws:
+ *  - out_of_range if table wasn't built for a graph with the same number of vertices, if a seed vertex is out of
+ *    range, or if samples is smaller than size(seeds) * fanout.
+ *
+ * @tparam G       The graph type.
+ * @tparam Seeds   The random access range of seed vertex ids.
+ * @tparam Samples The random access range of sampled vertex ids.
+ *
+ * @param g           The graph.
+ * @param table       The alias tables of g.
+ * @param seeds       The vertices to sample the neighbors of.
+ * @param fanout      The number of neighbors to sample for each seed vertex.
+ * @param samples     [out] The sampled neighbors of each seed vertex, one seed after the other.
+ * @param seed        The seed for the random number generators.
+ * @param num_threads The number of threads to use, including the calling thread.
+ *
+ * @return The number of neighbors sampled.
+ */
+template <index_adjacency_list G, random_access_range Seeds, random_access_range Samples>
+requires random_access_range<vertex_edge_range_t<G>> && convertible_to<range_value_t<Seeds>, vertex_id_t<G>> &&
+         integral<range_value_t<Samples>> && sized_range<Seeds> && sized_range<Samples>
+size_t sample_neighbors(G&&                g,
+                        const alias_table& table,
+                        const Seeds&       seeds,
+                        const size_t       fanout,
+                        Samples&           samples,
+                        const uint64_t     seed        = 0,
+                        size_t             num_threads = hardware_thread_count()) {
+  using id_type              = vertex_id_t<G>;
+  using sample_type          = range_value_t<Samples>;
+  constexpr size_t chunk     = 1024;
+  const size_t     N         = num_vertices(g);
+  const size_t     num_seeds = size(seeds);
+
+  if (table.num_vertices() != N) {
+    throw std::out_of_range(
+          std::format("sample_neighbors: the alias table has {} vertices instead of {}", table.num_vertices(), N));
+  }
+  if (size(samples) < num_seeds * fanout) {
+    throw std::out_of_range(std::format("sample_neighbors: size of samples of {} is less than {} seeds of fanout {}",
+                                        size(samples), num_seeds, fanout));
+  }
+  for (auto&& uid : seeds) {
+    if (static_cast<size_t>(uid) >= N) {
+      throw std::out_of_range(std::format("sample_neighbors: seed vertex id '{}' is out of range", uid));
+    }
+  }
+  num_threads = std::max(std::min(num_threads, (num_seeds + chunk - 1) / chunk), size_t(1));
+
+  struct alignas(64) thread_state {
+    std::mt19937_64 gen;
+    size_t          sampled = 0;
+  };
+  std::vector<thread_state> state(num_threads);
+  parallel_for(num_seeds, num_threads, chunk, [&](size_t s_first, size_t s_last, size_t tid) {
+    std::mt19937_64& gen = state[tid].gen;
+    for (size_t i = s_first; i < s_last; ++i) {
+      if (i % chunk == 0) {
+        gen.seed(seed + (i / chunk) * 0x9E3779B97F4A7C15ull);
+      }
+      auto          out = std::ranges::begin(samples) + static_cast<std::ptrdiff_t>(i * fanout);
+      const id_type uid = static_cast<id_type>(seeds[i]);
+      if (!table.can_sample(static_cast<size_t>(uid))) {
+        std::fill(out, out + static_cast<std::ptrdiff_t>(fanout), std::numeric_limits<sample_type>::max());
+        continue;
+      }
+      auto&& uv_range = edges(g, uid);
+      using edge_diff = std::ranges::range_difference_t<decltype(uv_range)>;
+      for (size_t j = 0; j < fanout; ++j) {
+        auto&& uv = *std::ranges::next(std::ranges::begin(uv_range),
+                                       static_cast<edge_diff>(table.sample(static_cast<size_t>(uid), gen)));
+        out[static_cast<std::ptrdiff_t>(j)] = static_cast<sample_type>(target_id(g, uv));
+      }
+      state[tid].sampled += fanout;
+    }
+  });
+
+  size_t sampled = 0;
+  for (auto& s : state) {
+    sampled += s.sampled;
+  }
+  return sampled;
+}
+
+} // namespace graph
+
+#endif // GRAPH_RANDOM_WALK_HPP
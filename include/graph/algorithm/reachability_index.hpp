@@ -0,0 +1,308 @@
+/**
+ * @file reachability_index.hpp
+ *
+ * @brief An index to answer "can u reach v" queries without the memory of a full transitive closure.
+ *
+ * The graph is condensed into its strongly connected components with tarjan_scc(), and each component
+ * gets k GRAIL interval labels: the post-order rank of the component in a randomized depth-first traversal
+ * of the condensation, and the lowest rank of anything it reaches. If u reaches v, every interval of v is
+ * contained in the matching interval of u, so most unreachable pairs are rejected by comparing labels.
+ * The remaining queries do a depth-first search of the condensation that is pruned with the same test.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: BSL-1.0
+ *
+ * @authors
+ */
+
+#include "graph/graph.hpp"
+#include "graph/algorithm/transitive_closure.hpp"
+#include "graph/detail/parallel.hpp"
+
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <format>
+#include <utility>
+#include <limits>
+
+#ifndef GRAPH_REACHABILITY_INDEX_HPP
+#  define GRAPH_REACHABILITY_INDEX_HPP
+
+namespace graph {
+
+/**
+ * @ingroup graph_algorithms
+ * @brief A reachability index for a directed graph.
+ *
+ * Vertex u reaches v when u == v or there is a path from u to v. Queries are thread-safe. A query
+ * for vertices in the same component, for a component that comes later in topological order, or for
+ * a pair rejected by the interval labels is answered in O(k). Other queries search the condensation,
+ * skipping components whose labels show they can't reach v.
+ *
+ * Construction is O(V + E + k * (C + E_c)) for C components with E_c edges between them. The
+ * condensation and the k labels are built in parallel.
+ *
+ * @tparam VId The vertex id type. Component ids and ranks use the same type to keep the index compact.
+ */
+template <integral VId>
+class reachability_index {
+public:
+  using vertex_id_type = VId;
+
+  reachability_index() = default;
+
+  /**
+   * @brief Builds the index for a graph.
+   *
+   * @param g           The graph.
+   * @param num_labels  The number of interval labels for each component. More labels reject more
+   *                    unreachable pairs without a search, at the cost of memory and construction time.
+   * @param num_threads The number of threads to use, including the calling thread.
+   * @param seed        The seed for the randomized traversals.
+  */
+  template <adjacency_list G>
+  requires random_access_range<vertex_range_t<G>> && integral<vertex_id_t<G>>
+  explicit reachability_index(G&&          g,
+                              const size_t num_labels  = 3,
+                              const size_t num_threads = hardware_thread_count(),
+                              const uint64_t seed      = 0x9e3779b97f4a7c15)
+        : num_labels_(std::max(num_labels, size_t(1))) {
+    const size_t N(size(vertices(g)));
+    component_.resize(N);
+    const size_t C         = tarjan_scc(g, component_);
+    auto         condensed = _condense<VId>(g, component_, C, num_threads);
+    first_.assign(condensed.first.begin(), condensed.first.end());
+    targets_ = std::move(condensed.targets);
+    labels_.resize(2 * num_labels_ * C);
+
+    // Components with no predecessors start the traversals
+    std::vector<char> has_predecessor(C, false);
+    for (VId d : targets_)
+      has_predecessor[static_cast<size_t>(d)] = true;
+    std::vector<VId> roots;
+    for (size_t c = C; c-- > 0;) // topological order
+      if (!has_predecessor[c])
+        roots.push_back(static_cast<VId>(c));
+
+    parallel_for(num_labels_, num_threads, 1, [&](size_t first, size_t last, size_t) {
+      for (size_t label = first; label < last; ++label)
+        _assign_labels(label, roots, seed);
+    });
+  }
+
+  constexpr size_t num_vertices() const noexcept { return component_.size(); }
+  constexpr size_t num_components() const noexcept { return first_.empty() ? 0 : first_.size() - 1; }
+  constexpr size_t num_labels() const noexcept { return num_labels_; }
+
+  /**
+   * @brief The strongly connected component of a vertex. Components are numbered in reverse topological
+   * order.
+  */
+  VId component(VId uid) const noexcept { return component_[static_cast<size_t>(uid)]; }
+
+  /**
+   * @brief Does u reach v? Both ids must be less than num_vertices().
+  */
+  bool reaches(VId uid, VId vid) const {
+    const size_t cu = static_cast<size_t>(component_[static_cast<size_t>(uid)]);
+    const size_t cv = static_cast<size_t>(component_[static_cast<size_t>(vid)]);
+    if (cu == cv)
+      return true;
+    if (cu < cv || !_contains(cu, cv)) // components only reach lower numbered components
+      return false;
+    return _search(cu, cv);
+  }
+
+  /**
+   * @brief Writes the index in a compact binary form that can be read with load(). Integers are
+   * written in the native byte order, so the index should be loaded on a machine with the same
+   * byte order.
+  */
+  void save(std::ostream& os) const {
+    const uint32_t header[4] = {magic, version, static_cast<uint32_t>(sizeof(VId)),
+                                static_cast<uint32_t>(num_labels_)};
+    const uint64_t sizes[3]  = {component_.size(), first_.size(), targets_.size()};
+    os.write(reinterpret_cast<const char*>(header), sizeof(header));
+    os.write(reinterpret_cast<const char*>(sizes), sizeof(sizes));
+    _write(os, component_);
+    _write(os, first_);
+    _write(os, targets_);
+    _write(os, labels_);
+    if (!os)
+      throw std::runtime_error("reachability_index::save: write failed");
+  }
+
+  /**
+   * @brief Reads an index written by save(). Throws std::runtime_error if the data isn't a valid index
+   * for the vertex id type.
+  */
+  static reachability_index load(std::istream& is) {
+    uint32_t header[4] = {};
+    uint64_t sizes[3]  = {};
+    is.read(reinterpret_cast<char*>(header), sizeof(header));
+    is.read(reinterpret_cast<char*>(sizes), sizeof(sizes));
+    if (!is || header[0] != magic || header[1] != version)
+      throw std::runtime_error("reachability_index::load: not a reachability index");
+    if (header[2] != sizeof(VId))
+      throw std::runtime_error(std::format(
+            "reachability_index::load: vertex id size {} doesn't match {}", header[2], sizeof(VId)));
+    if (header[3] == 0 || sizes[1] == 0)
+      throw std::runtime_error("reachability_index::load: invalid sizes");
+
+    reachability_index index;
+    index.num_labels_ = header[3];
+    _read(is, index.component_, sizes[0]);
+    _read(is, index.first_, sizes[1]);
+    _read(is, index.targets_, sizes[2]);
+    _read(is, index.labels_, 2 * index.num_labels_ * (sizes[1] - 1));
+
+    // Check everything used as an index so a corrupt file can't cause out of bounds reads
+    const size_t C     = index.num_components();
+    auto         valid = [C](VId c) { return std::cmp_greater_equal(c, 0) && std::cmp_less(c, C); };
+    if (index.first_.front() != 0 || index.first_.back() != index.targets_.size() ||
+        !std::ranges::is_sorted(index.first_) || !std::ranges::all_of(index.component_, valid) ||
+        !std::ranges::all_of(index.targets_, valid))
+      throw std::runtime_error("reachability_index::load: invalid index");
+    return index;
+  }
+
+  bool operator==(const reachability_index&) const = default;
+
+private:
+  static constexpr uint32_t magic   = 0x49524752; // "GRRI"
+  static constexpr uint32_t version = 1;
+
+  // labels_[2 * (k * c + i)] is the lowest rank reached by component c in traversal i, and the next
+  // element is the rank of c
+  bool _contains(size_t cu, size_t cv) const noexcept {
+    const VId* lu = labels_.data() + 2 * num_labels_ * cu;
+    const VId* lv = labels_.data() + 2 * num_labels_ * cv;
+    for (size_t i = 0; i < 2 * num_labels_; i += 2)
+      if (lv[i] < lu[i] || lv[i + 1] > lu[i + 1])
+        return false;
+    return true;
+  }
+
+  // Depth-first search from cu for cv, with cu > cv and the labels of cu containing those of cv
+  bool _search(size_t cu, size_t cv) const {
+    // Components are marked with the number of the query, so the marks don't need to be cleared
+    static thread_local std::vector<uint32_t> visited;
+    static thread_local uint32_t              query = 0;
+    static thread_local std::vector<size_t>   stack;
+    const size_t                              C = num_components();
+    if (visited.size() < C)
+      visited.resize(C, 0);
+    if (++query == 0) {
+      std::ranges::fill(visited, 0);
+      query = 1;
+    }
+
+    stack.clear();
+    stack.push_back(cu);
+    visited[cu] = query;
+    while (!stack.empty()) {
+      const size_t c = stack.back();
+      stack.pop_back();
+      for (size_t i = first_[c]; i < first_[c + 1]; ++i) {
+        const size_t d = static_cast<size_t>(targets_[i]);
+        if (d == cv)
+          return true;
+        if (d < cv)
+          break; // successors are in decreasing order, and the rest can't reach cv
+        if (visited[d] != query && _contains(d, cv)) {
+          visited[d] = query;
+          stack.push_back(d);
+        }
+      }
+    }
+    return false;
+  }
+
+  // Post-order ranks of a depth-first traversal of the condensation, with the roots and the successors
+  // of each component visited in a different order for each label
+  void _assign_labels(const size_t label, std::vector<VId> roots, const uint64_t seed) {
+    const size_t C = num_components();
+    auto low  = [&](size_t c) -> VId& { return labels_[2 * (num_labels_ * c + label)]; };
+    auto rank = [&](size_t c) -> VId& { return labels_[2 * (num_labels_ * c + label) + 1]; };
+
+    std::mt19937_64 gen(seed + label);
+    if (label > 0)
+      std::ranges::shuffle(roots, gen);
+    const uint64_t rotation = gen();
+
+    struct frame {
+      size_t c;
+      size_t next; // successors examined
+      VId    low;
+    };
+    std::vector<char>  visited(C, false);
+    std::vector<frame> stack;
+    size_t             next_rank = 0;
+    for (VId root : roots) {
+      stack.push_back({static_cast<size_t>(root), 0, std::numeric_limits<VId>::max()});
+      visited[static_cast<size_t>(root)] = true;
+      while (!stack.empty()) {
+        frame&       f      = stack.back();
+        const size_t degree = first_[f.c + 1] - first_[f.c];
+        if (f.next < degree) {
+          // Start at a different successor for each label; label 0 keeps topological order
+          const size_t offset =
+                label == 0 ? 0 : static_cast<size_t>((rotation ^ (f.c * 0x9e3779b97f4a7c15)) % degree);
+          const size_t d      = static_cast<size_t>(targets_[first_[f.c] + (f.next++ + offset) % degree]);
+          if (visited[d]) {
+            f.low = std::min(f.low, low(d)); // a DAG has no back edges, so d is finished
+          } else {
+            visited[d] = true;
+            stack.push_back({d, 0, std::numeric_limits<VId>::max()});
+          }
+          continue;
+        }
+        rank(f.c) = static_cast<VId>(next_rank++);
+        low(f.c)  = std::min(f.low, rank(f.c));
+        const VId done_low = low(f.c);
+        stack.pop_back();
+        if (!stack.empty())
+          stack.back().low = std::min(stack.back().low, done_low);
+      }
+    }
+  }
+
+  template <class T>
+  static void _write(std::ostream& os, const std::vector<T>& v) {
+    os.write(reinterpret_cast<const char*>(v.data()), static_cast<std::streamsize>(v.size() * sizeof(T)));
+  }
+  template <class T>
+  static void _read(std::istream& is, std::vector<T>& v, uint64_t n) {
+    v.clear();
+    // Read in blocks so a corrupt size fails at the end of the data instead of allocating it all
+    constexpr uint64_t block = 1 << 20;
+    for (uint64_t done = 0; done < n;) {
+      const uint64_t count = std::min(block, n - done);
+      v.resize(done + count);
+      is.read(reinterpret_cast<char*>(v.data() + done), static_cast<std::streamsize>(count * sizeof(T)));
+      if (!is)
+        throw std::runtime_error("reachability_index::load: unexpected end of data");
+      done += count;
+    }
+  }
+
+  std::vector<VId>      component_; // component of each vertex
+  std::vector<uint64_t> first_;     // C+1 offsets into targets_
+  std::vector<VId>      targets_;   // successor components, in decreasing order
+  std::vector<VId>      labels_;    // 2 * num_labels_ * C
+  size_t                num_labels_ = 0;
+};
+
+template <adjacency_list G, class... Args>
+reachability_index(G&&, Args...) -> reachability_index<vertex_id_t<G>>;
+
+} // namespace graph
+
+#endif // GRAPH_REACHABILITY_INDEX_HPP
@@ -1,7 +1,8 @@
 /**
  * @file tc.hpp
  * 
- * @brief Triangle counting.
+ * @brief Triangle counting, per-vertex and per-edge triangle support, local clustering coefficients and
+ * k-truss decomposition.
  * 
  * @copyright Copyright (c) 2022
  * 
@@ -15,6 +16,17 @@
 
 #include "graph/graph.hpp"
 #include "graph/views/incidence.hpp"
+#include "graph/detail/parallel.hpp"
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <atomic>
+#include <bit>
+#include <stdexcept>
+#include <format>
+#if defined(__SSE2__)
+#  include <emmintrin.h>
+#endif
 
 #ifndef GRAPH_TC_HPP
 #  define GRAPH_TC_HPP
@@ -66,6 +78,592 @@ size_t triangle_count(G&& g) {
   }
   return triangles;
 }
+
+/**
+ * @brief A graph with each undirected edge {u,v} stored once, directed from the lower to the higher ranked
+ * vertex, where vertices are ranked by (degree, id). The targets of each vertex are sorted by id.
+ *
+ * Orienting the edges this way bounds the number of targets of every vertex by O(sqrt(E)), so the set
+ * intersections for triangles are short even for the highest degree vertices.
+*/
+template <class VId>
+struct _degree_oriented_graph {
+  std::vector<size_t> first; // targets of uid are [targets[first[uid]], targets[last[uid]])
+  std::vector<size_t> last;
+  std::vector<VId>    targets;
+
+  size_t     size() const noexcept { return last.size(); }
+  const VId* begin(size_t uid) const noexcept { return targets.data() + first[uid]; }
+  const VId* end(size_t uid) const noexcept { return targets.data() + last[uid]; }
+  size_t     degree(size_t uid) const noexcept { return last[uid] - first[uid]; }
+};
+
+/**
+ * @brief Builds the degree-oriented graph of g, treated as an undirected graph. Edges can be in either or
+ * both directions in g. Self loops and duplicate edges are removed.
+*/
+template <adjacency_list G>
+requires random_access_range<vertex_range_t<G>> && integral<vertex_id_t<G>>
+_degree_oriented_graph<vertex_id_t<G>> _orient_by_degree(G&& g, const size_t num_threads) {
+  using id_type = vertex_id_t<G>;
+  const size_t N(size(vertices(g)));
+
+  std::vector<size_t> degree(N);
+  parallel_for(N, num_threads, 1024, [&](size_t first, size_t last, size_t) {
+    for (size_t uid = first; uid < last; ++uid) {
+      for (auto&& uv : edges(g, static_cast<id_type>(uid))) {
+        const size_t vid = static_cast<size_t>(target_id(g, uv));
+        if (vid != uid) {
+          std::atomic_ref<size_t>(degree[uid]).fetch_add(1, std::memory_order_relaxed);
+          std::atomic_ref<size_t>(degree[vid]).fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+    }
+  });
+  auto lower_rank = [&degree](size_t uid, size_t vid) {
+    return degree[uid] < degree[vid] || (degree[uid] == degree[vid] && uid < vid);
+  };
+
+  // Each edge goes to the lower ranked vertex
+  _degree_oriented_graph<id_type> og;
+  og.first.assign(N + 1, 0);
+  parallel_for(N, num_threads, 1024, [&](size_t first, size_t last, size_t) {
+    for (size_t uid = first; uid < last; ++uid) {
+      for (auto&& uv : edges(g, static_cast<id_type>(uid))) {
+        const size_t vid = static_cast<size_t>(target_id(g, uv));
+        if (vid != uid) {
+          const size_t from = lower_rank(uid, vid) ? uid : vid;
+          std::atomic_ref<size_t>(og.first[from]).fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+    }
+  });
+  std::exclusive_scan(og.first.begin(), og.first.end(), og.first.begin(), size_t(0));
+  og.targets.resize(og.first[N]);
+  og.last.assign(og.first.begin(), og.first.end() - 1); // used as the insert position for each vertex
+  parallel_for(N, num_threads, 1024, [&](size_t first, size_t last, size_t) {
+    for (size_t uid = first; uid < last; ++uid) {
+      for (auto&& uv : edges(g, static_cast<id_type>(uid))) {
+        const size_t vid = static_cast<size_t>(target_id(g, uv));
+        if (vid != uid) {
+          const bool   forward = lower_rank(uid, vid);
+          const size_t from    = forward ? uid : vid;
+          const size_t pos     = std::atomic_ref<size_t>(og.last[from]).fetch_add(1, std::memory_order_relaxed);
+          og.targets[pos]      = static_cast<id_type>(forward ? vid : uid);
+        }
+      }
+    }
+  });
+  parallel_for(N, num_threads, 256, [&](size_t first, size_t last, size_t) {
+    for (size_t uid = first; uid < last; ++uid) {
+      id_type* b = og.targets.data() + og.first[uid];
+      id_type* e = og.targets.data() + og.last[uid];
+      std::sort(b, e);
+      og.last[uid] = static_cast<size_t>(std::unique(b, e) - og.targets.data());
+    }
+  });
+  return og;
+}
+
+/**
+ * @brief Calls f(ps, pl) for each value in both of the sorted ranges of distinct values [s, s_end) and
+ * [l, l_end), where l is much longer than s, finding each value of s in l by galloping (exponential
+ * search).
+*/
+template <class T, class F>
+void _gallop_intersect_for_each(const T* s, const T* s_end, const T* l, const T* l_end, F&& f) {
+  for (; s != s_end && l != l_end; ++s) {
+    std::ptrdiff_t step = 1;
+    while (step < (l_end - l) && l[step] < *s) {
+      step *= 2;
+    }
+    l = std::lower_bound(l + step / 2, l + std::min(step + 1, l_end - l), *s);
+    if (l != l_end && *l == *s) {
+      f(s, l);
+      ++l;
+    }
+  }
+}
+
+/**
+ * @brief Calls f(pa, pb) for each value in both of the sorted ranges of distinct values [a, a_end) and
+ * [b, b_end), where pa and pb point to the value in each range. When one range is much longer than the
+ * other, the values of the short range are found in the long one by galloping instead of merging.
+*/
+template <class T, class F>
+void _intersect_for_each(const T* a, const T* a_end, const T* b, const T* b_end, F&& f) {
+  if ((b_end - b) > 32 * (a_end - a)) {
+    _gallop_intersect_for_each(a, a_end, b, b_end, f);
+    return;
+  }
+  if ((a_end - a) > 32 * (b_end - b)) {
+    _gallop_intersect_for_each(b, b_end, a, a_end, [&f](const T* pb, const T* pa) { f(pa, pb); });
+    return;
+  }
+  while (a != a_end && b != b_end) {
+    if (*a < *b) {
+      ++a;
+    } else if (*b < *a) {
+      ++b;
+    } else {
+      f(a, b);
+      ++a;
+      ++b;
+    }
+  }
+}
+
+/**
+ * @brief The number of values in both of the sorted ranges of distinct values [a, a_end) and [b, b_end).
+ *
+ * For 32-bit values on SSE2 targets, blocks of 4 values from each range are compared all-against-all at
+ * once, advancing the block with the smaller maximum. Galloping is used for ranges of very different
+ * lengths.
+*/
+template <class T>
+size_t _intersect_count(const T* a, const T* a_end, const T* b, const T* b_end) {
+  size_t count = 0;
+#if defined(__SSE2__)
+  if constexpr (sizeof(T) == 4 && integral<T>) {
+    const std::ptrdiff_t na = a_end - a, nb = b_end - b;
+    if (std::max(na, nb) <= 32 * std::min(na, nb)) {
+      while (a_end - a >= 4 && b_end - b >= 4) {
+        const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+        const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+        __m128i       eq = _mm_cmpeq_epi32(va, vb);
+        eq = _mm_or_si128(eq, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1))));
+        eq = _mm_or_si128(eq, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))));
+        eq = _mm_or_si128(eq, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3))));
+        count += static_cast<size_t>(std::popcount(static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(eq)))));
+        const T a_max = a[3], b_max = b[3];
+        if (a_max <= b_max)
+          a += 4;
+        if (b_max <= a_max)
+          b += 4;
+      }
+    }
+  }
+#endif
+  _intersect_for_each(a, a_end, b, b_end, [&count](const T*, const T*) { ++count; });
+  return count;
+}
+
+/**
+ * @ingroup graph_algorithms
+ * @brief Find the number of triangles in an undirected graph using multiple threads.
+ *
+ * Unlike triangle_count(), the edges of g can be in either or both directions and the edges of a vertex
+ * don't need to be ordered. Self loops and duplicate edges are ignored.
+ *
+ * The edges are first oriented from the lower to the higher ranked vertex, ranking vertices by degree,
+ * so each triangle is found exactly once and high-degree vertices have short edge lists. For each
+ * oriented edge (u,v) the triangles are the common targets of u and v, found by a sorted-set
+ * intersection. The vertices are divided among the threads in small chunks that are taken dynamically,
+ * which balances the uneven work per vertex of skewed graphs.
+ *
+ * Complexity: O(E^1.5 / num_threads)
+ *
+ * @tparam G          The graph type.
+ *
+ * @param g           The graph.
+ * @param num_threads The number of threads to use, including the calling thread.
+ *
+ * @return The number of triangles.
+ */
+template <adjacency_list G>
+requires random_access_range<vertex_range_t<G>> && integral<vertex_id_t<G>>
+size_t parallel_triangle_count(G&& g, const size_t num_threads = hardware_thread_count()) {
+  const auto og = _orient_by_degree(g, num_threads);
+
+  std::vector<size_t> thread_triangles(std::max(num_threads, size_t(1)));
+  parallel_for(og.size(), num_threads, 64, [&](size_t first, size_t last, size_t tid) {
+    size_t triangles = 0;
+    for (size_t uid = first; uid < last; ++uid) {
+      for (auto vit = og.begin(uid); vit != og.end(uid); ++vit) {
+        const size_t vid = static_cast<size_t>(*vit); // triangles (uid, vid, wid) have wid ranked above vid
+        triangles += _intersect_count(og.begin(uid), og.end(uid), og.begin(vid), og.end(vid));
+      }
+    }
+    thread_triangles[tid] += triangles;
+  });
+  return std::accumulate(thread_triangles.begin(), thread_triangles.end(), size_t(0));
+}
+
+/**
+ * @brief Calls f(uid, vid, wid, uv, uw, vw) for each triangle (u,v,w), with u < v < w in rank, where uv, uw
+ * and vw are the positions of the triangle's edges in og.targets. f is called from multiple threads.
+*/
+template <class VId, class F>
+void _for_each_triangle(const _degree_oriented_graph<VId>& og, const size_t num_threads, F&& f) {
+  const VId* targets = og.targets.data();
+  parallel_for(og.size(), num_threads, 64, [&](size_t first, size_t last, size_t) {
+    for (size_t uid = first; uid < last; ++uid) {
+      for (auto vit = og.begin(uid); vit != og.end(uid); ++vit) {
+        const size_t vid = static_cast<size_t>(*vit);
+        _intersect_for_each(og.begin(uid), og.end(uid), og.begin(vid), og.end(vid), [&](const VId* pu, const VId* pv) {
+          f(uid, vid, static_cast<size_t>(*pu), static_cast<size_t>(vit - targets), static_cast<size_t>(pu - targets),
+            static_cast<size_t>(pv - targets));
+        });
+      }
+    }
+  });
+}
+
+/**
+ * @brief Calls f(e, slot) for each edge e of g, where e is the index of the edge when the edges of all
+ * vertices are numbered consecutively in vertex order (the edge index of a compressed_graph), and slot
+ * is the position of the undirected edge in og.targets, or og.targets.size() for a self loop.
+*/
+template <adjacency_list G, class VId, class F>
+void _for_each_oriented_edge(G&& g, const _degree_oriented_graph<VId>& og, const size_t num_threads, F&& f) {
+  using id_type = vertex_id_t<G>;
+  const size_t        N(size(vertices(g)));
+  std::vector<size_t> first_edge(N + 1, 0);
+  for (size_t uid = 0; uid < N; ++uid) {
+    first_edge[uid + 1] =
+          first_edge[uid] + static_cast<size_t>(std::ranges::distance(edges(g, static_cast<id_type>(uid))));
+  }
+  auto find_slot = [&og](size_t uid, size_t vid) -> size_t {
+    const VId* it = std::lower_bound(og.begin(uid), og.end(uid), static_cast<VId>(vid));
+    if (it != og.end(uid) && static_cast<size_t>(*it) == vid)
+      return static_cast<size_t>(it - og.targets.data());
+    return og.targets.size();
+  };
+
+  parallel_for(N, num_threads, 256, [&](size_t first, size_t last, size_t) {
+    for (size_t uid = first; uid < last; ++uid) {
+      size_t e = first_edge[uid];
+      for (auto&& uv : edges(g, static_cast<id_type>(uid))) {
+        const size_t vid  = static_cast<size_t>(target_id(g, uv));
+        size_t       slot = og.targets.size();
+        if (vid != uid) {
+          slot = find_slot(uid, vid);
+          if (slot == og.targets.size())
+            slot = find_slot(vid, uid);
+        }
+        f(e++, slot);
+      }
+    }
+  });
+}
+
+/**
+ * @brief The total number of edges of g, and an out_of_range exception if a range aligned with them is
+ * too small.
+*/
+template <adjacency_list G>
+size_t _check_edge_range_size(G&& g, const size_t range_size, const char* fn_name, const char* range_name) {
+  size_t num_edges = 0;
+  for (auto&& u : vertices(g)) {
+    num_edges += static_cast<size_t>(std::ranges::distance(edges(g, u)));
+  }
+  if (range_size < num_edges) {
+    throw std::out_of_range(std::format("{}: size of {} of {} is less than the number of edges {}", fn_name,
+                                        range_name, range_size, num_edges));
+  }
+  return num_edges;
+}
+
+/**
+ * @ingroup graph_algorithms
+ * @brief Find the number of triangles that each edge of an undirected graph is in (its support), using
+ * multiple threads.
+ *
+ * The edges of g can be in either or both directions. Each stored copy of an edge gets the support of the
+ * undirected edge. Self loops have a support of 0.
+ *
+ * The support is aligned with the edge index of a compressed_graph: the edges of all vertices are
+ * numbered consecutively in vertex order, the order they're stored in a compressed_graph.
+ *
+ * Complexity: O(E^1.5 / num_threads)
+ *
+ * Throws:
+ *  - out_of_range if support is smaller than the number of edges.
+ *
+ * @tparam G          The graph type.
+ * @tparam Support    The random access range of the support of each edge.
+ *
+ * @param g           The graph.
+ * @param support     [out] The number of triangles with each edge.
+ * @param num_threads The number of threads to use, including the calling thread.
+ */
+template <adjacency_list G, random_access_range Support>
+requires random_access_range<vertex_range_t<G>> && integral<vertex_id_t<G>> && integral<range_value_t<Support>>
+void edge_triangle_support(G&& g, Support& support, const size_t num_threads = hardware_thread_count()) {
+  _check_edge_range_size(g, static_cast<size_t>(size(support)), "edge_triangle_support", "support");
+  const auto og = _orient_by_degree(g, num_threads);
+
+  std::vector<size_t> slot_support(og.targets.size() + 1); // +1 for self loops
+  _for_each_triangle(og, num_threads, [&slot_support](size_t, size_t, size_t, size_t uv, size_t uw, size_t vw) {
+    std::atomic_ref<size_t>(slot_support[uv]).fetch_add(1, std::memory_order_relaxed);
+    std::atomic_ref<size_t>(slot_support[uw]).fetch_add(1, std::memory_order_relaxed);
+    std::atomic_ref<size_t>(slot_support[vw]).fetch_add(1, std::memory_order_relaxed);
+  });
+  _for_each_oriented_edge(g, og, num_threads, [&](size_t e, size_t slot) {
+    support[e] = static_cast<range_value_t<Support>>(slot_support[slot]);
+  });
+}
+
+/**
+ * @ingroup graph_algorithms
+ * @brief Find the number of triangles that each vertex of an undirected graph is in, using multiple
+ * threads.
+ *
+ * The edges of g can be in either or both directions. Self loops and duplicate edges are ignored.
+ *
+ * Complexity: O(E^1.5 / num_threads)
+ *
+ * @tparam G          The graph type.
+ * @tparam Triangles  The random access range of the number of triangles of each vertex.
+ *
+ * @param g           The graph.
+ * @param triangles   [out] The number of triangles with each vertex.
+ * @param num_threads The number of threads to use, including the calling thread.
+ */
+template <adjacency_list G, random_access_range Triangles>
+requires random_access_range<vertex_range_t<G>> && integral<vertex_id_t<G>> && integral<range_value_t<Triangles>>
+void vertex_triangle_count(G&& g, Triangles& triangles, const size_t num_threads = hardware_thread_count()) {
+  if (size(triangles) < size(vertices(g))) {
+    throw std::out_of_range(
+          std::format("vertex_triangle_count: size of triangles of {} is less than the number of vertices {}",
+                      size(triangles), size(vertices(g))));
+  }
+  const auto          og = _orient_by_degree(g, num_threads);
+  std::vector<size_t> counts(og.size());
+  _for_each_triangle(og, num_threads, [&counts](size_t uid, size_t vid, size_t wid, size_t, size_t, size_t) {
+    std::atomic_ref<size_t>(counts[uid]).fetch_add(1, std::memory_order_relaxed);
+    std::atomic_ref<size_t>(counts[vid]).fetch_add(1, std::memory_order_relaxed);
+    std::atomic_ref<size_t>(counts[wid]).fetch_add(1, std::memory_order_relaxed);
+  });
+  for (size_t uid = 0; uid < counts.size(); ++uid) {
+    triangles[uid] = static_cast<range_value_t<Triangles>>(counts[uid]);
+  }
+}
+
+/**
+ * @ingroup graph_algorithms
+ * @brief Find the local clustering coefficient of each vertex of an undirected graph, using multiple
+ * threads.
+ *
+ * The coefficient of a vertex with d distinct neighbors in t triangles is 2t / (d(d-1)), the fraction of
+ * pairs of its neighbors that are adjacent. It's 0 when d < 2. The edges of g can be in either or both
+ * directions. Self loops and duplicate edges are ignored.
+ *
+ * Complexity: O(E^1.5 / num_threads)
+ *
+ * @tparam G            The graph type.
+ * @tparam Coefficients The random access range of the coefficient of each vertex.
+ *
+ * @param g            The graph.
+ * @param coefficients [out] The local clustering coefficient of each vertex.
+ * @param num_threads  The number of threads to use, including the calling thread.
+ */
+template <adjacency_list G, random_access_range Coefficients>
+requires random_access_range<vertex_range_t<G>> && integral<vertex_id_t<G>> &&
+         std::floating_point<range_value_t<Coefficients>>
+void local_clustering_coefficient(G&&           g,
+                                  Coefficients& coefficients,
+                                  const size_t  num_threads = hardware_thread_count()) {
+  using coefficient_type = range_value_t<Coefficients>;
+  if (size(coefficients) < size(vertices(g))) {
+    throw std::out_of_range(
+          std::format("local_clustering_coefficient: size of coefficients of {} is less than the number of vertices {}",
+                      size(coefficients), size(vertices(g))));
+  }
+  const auto          og = _orient_by_degree(g, num_threads);
+  std::vector<size_t> counts(og.size()), degree(og.size());
+  parallel_for(og.size(), num_threads, 1024, [&](size_t first, size_t last, size_t) {
+    for (size_t uid = first; uid < last; ++uid) {
+      std::atomic_ref<size_t>(degree[uid]).fetch_add(og.degree(uid), std::memory_order_relaxed);
+      for (auto vit = og.begin(uid); vit != og.end(uid); ++vit)
+        std::atomic_ref<size_t>(degree[static_cast<size_t>(*vit)]).fetch_add(1, std::memory_order_relaxed);
+    }
+  });
+  _for_each_triangle(og, num_threads, [&counts](size_t uid, size_t vid, size_t wid, size_t, size_t, size_t) {
+    std::atomic_ref<size_t>(counts[uid]).fetch_add(1, std::memory_order_relaxed);
+    std::atomic_ref<size_t>(counts[vid]).fetch_add(1, std::memory_order_relaxed);
+    std::atomic_ref<size_t>(counts[wid]).fetch_add(1, std::memory_order_relaxed);
+  });
+  for (size_t uid = 0; uid < og.size(); ++uid) {
+    const size_t d     = degree[uid];
+    coefficients[uid] = d < 2 ? coefficient_type(0)
+                              : static_cast<coefficient_type>(2 * counts[uid]) /
+                                      (static_cast<coefficient_type>(d) * static_cast<coefficient_type>(d - 1));
+  }
+}
+
+/**
+ * @ingroup graph_algorithms
+ * @brief Find the truss number of each edge of an undirected graph (k-truss decomposition), using multiple
+ * threads.
+ *
+ * The k-truss of a graph is its largest subgraph in which every edge is in at least k-2 triangles. The
+ * truss number of an edge is the largest k for which it's in the k-truss, so filtering the edges with a
+ * truss number >= k gives the k-truss. Every edge is in the 2-truss.
+ *
+ * The edges are peeled in order of their support. For each level k-2 = 0, 1, ..., the edges whose support
+ * is at most the level are removed in parallel rounds, lowering the support of the other edges of their
+ * triangles, until none are left at the level. When two edges of a triangle are removed in the same
+ * round, only the one with the lower index lowers the support of the third edge.
+ *
+ * The edges of g can be in either or both directions, and the truss numbers are aligned with the edge
+ * index of a compressed_graph like edge_triangle_support(). Self loops have a truss number of 0.
+ *
+ * Complexity: O(E^1.5 + E * K) work for a maximum truss number of K
+ *
+ * Throws:
+ *  - out_of_range if truss is smaller than the number of edges.
+ *
+ * @tparam G          The graph type.
+ * @tparam Truss      The random access range of the truss number of each edge.
+ *
+ * @param g           The graph.
+ * @param truss       [out] The truss number of each edge.
+ * @param num_threads The number of threads to use, including the calling thread.
+ *
+ * @return The largest truss number, or 0 if there are no edges.
+ */
+template <adjacency_list G, random_access_range Truss>
+requires random_access_range<vertex_range_t<G>> && integral<vertex_id_t<G>> && integral<range_value_t<Truss>>
+size_t k_truss(G&& g, Truss& truss, const size_t num_threads = hardware_thread_count()) {
+  using id_type = vertex_id_t<G>;
+  _check_edge_range_size(g, static_cast<size_t>(size(truss)), "k_truss", "truss");
+  const auto   og = _orient_by_degree(g, num_threads);
+  const size_t N  = og.size();
+  const size_t M  = og.targets.size(); // edge slots, including unused ones after duplicates were removed
+
+  std::vector<size_t> support(M);
+  _for_each_triangle(og, num_threads, [&support](size_t, size_t, size_t, size_t uv, size_t uw, size_t vw) {
+    std::atomic_ref<size_t>(support[uv]).fetch_add(1, std::memory_order_relaxed);
+    std::atomic_ref<size_t>(support[uw]).fetch_add(1, std::memory_order_relaxed);
+    std::atomic_ref<size_t>(support[vw]).fetch_add(1, std::memory_order_relaxed);
+  });
+
+  // Undirected adjacency, sorted by neighbor, with the slot of each edge, to find the triangles of an edge
+  std::vector<size_t>  adj_first(N + 1, 0);
+  std::vector<id_type> source(M); // the lower ranked vertex of each slot
+  for (size_t uid = 0; uid < N; ++uid) {
+    adj_first[uid + 1] += og.degree(uid);
+    for (auto vit = og.begin(uid); vit != og.end(uid); ++vit) {
+      adj_first[static_cast<size_t>(*vit) + 1] += 1;
+      source[static_cast<size_t>(vit - og.targets.data())] = static_cast<id_type>(uid);
+    }
+  }
+  std::inclusive_scan(adj_first.begin(), adj_first.end(), adj_first.begin());
+  std::vector<std::pair<id_type, size_t>> adj(adj_first[N]);
+  {
+    std::vector<size_t> pos(adj_first.begin(), adj_first.end() - 1);
+    for (size_t uid = 0; uid < N; ++uid) {
+      for (auto vit = og.begin(uid); vit != og.end(uid); ++vit) {
+        const size_t slot                   = static_cast<size_t>(vit - og.targets.data());
+        adj[pos[uid]++]                     = {*vit, slot};
+        adj[pos[static_cast<size_t>(*vit)]++] = {static_cast<id_type>(uid), slot};
+      }
+    }
+  }
+  std::vector<id_type> adj_nbr(adj.size());
+  std::vector<size_t>  adj_slot(adj.size());
+  parallel_for(N, num_threads, 256, [&](size_t first, size_t last, size_t) {
+    for (size_t uid = first; uid < last; ++uid) {
+      std::sort(adj.begin() + static_cast<std::ptrdiff_t>(adj_first[uid]),
+                adj.begin() + static_cast<std::ptrdiff_t>(adj_first[uid + 1]));
+      for (size_t i = adj_first[uid]; i < adj_first[uid + 1]; ++i) {
+        adj_nbr[i]  = adj[i].first;
+        adj_slot[i] = adj[i].second;
+      }
+    }
+  });
+  adj = {};
+
+  // Peel the edges in order of support
+  enum : char { alive, peeling, removed };
+  std::vector<char> state(M, removed);
+  size_t            remaining = 0;
+  for (size_t uid = 0; uid < N; ++uid) {
+    std::fill(state.begin() + static_cast<std::ptrdiff_t>(og.first[uid]),
+              state.begin() + static_cast<std::ptrdiff_t>(og.last[uid]), alive);
+    remaining += og.degree(uid);
+  }
+  std::vector<size_t>              slot_truss(M + 1, 0); // +1 for self loops
+  std::vector<size_t>              frontier;
+  std::vector<std::vector<size_t>> local(std::max(num_threads, size_t(1)));
+  auto                             gather = [&]() {
+    frontier.clear();
+    for (auto& next : local) {
+      frontier.insert(frontier.end(), next.begin(), next.end());
+      next.clear();
+    }
+    for (size_t e : frontier)
+      state[e] = peeling;
+  };
+
+  size_t max_truss = 0;
+  for (size_t level = 0; remaining > 0; ++level) {
+    parallel_for(M, num_threads, 4096, [&](size_t first, size_t last, size_t tid) {
+      for (size_t e = first; e < last; ++e) {
+        if (state[e] == alive && support[e] <= level)
+          local[tid].push_back(e);
+      }
+    });
+    gather();
+
+    while (!frontier.empty()) {
+      parallel_for(frontier.size(), num_threads, 16, [&](size_t first, size_t last, size_t tid) {
+        // Lower the support of edge f, if it's above the level, and peel it in the next round at the level
+        auto lower_support = [&](size_t f) {
+          std::atomic_ref<size_t> sup(support[f]);
+          size_t                  cur = sup.load(std::memory_order_relaxed);
+          while (cur > level) {
+            if (sup.compare_exchange_weak(cur, cur - 1, std::memory_order_relaxed)) {
+              if (cur - 1 == level)
+                local[tid].push_back(f);
+              break;
+            }
+          }
+        };
+        const id_type* nbr = adj_nbr.data();
+        for (size_t i = first; i < last; ++i) {
+          const size_t e   = frontier[i];
+          const size_t uid = static_cast<size_t>(source[e]);
+          const size_t vid = static_cast<size_t>(og.targets[e]);
+          auto         on_triangle = [&](const id_type* pu, const id_type* pv) {
+            const size_t uw = adj_slot[static_cast<size_t>(pu - nbr)];
+            const size_t vw = adj_slot[static_cast<size_t>(pv - nbr)];
+            if (state[uw] == removed || state[vw] == removed || (state[uw] == peeling && state[vw] == peeling)) {
+              return;
+            }
+            if (state[uw] == peeling) {
+              if (e < uw)
+                lower_support(vw);
+            } else if (state[vw] == peeling) {
+              if (e < vw)
+                lower_support(uw);
+            } else {
+              lower_support(uw);
+              lower_support(vw);
+            }
+          };
+          _intersect_for_each(nbr + adj_first[uid], nbr + adj_first[uid + 1], nbr + adj_first[vid],
+                              nbr + adj_first[vid + 1], on_triangle);
+        }
+      });
+
+      for (size_t e : frontier) {
+        state[e]      = removed;
+        slot_truss[e] = level + 2;
+      }
+      remaining -= frontier.size();
+      max_truss = level + 2;
+      gather();
+    }
+  }
+
+  _for_each_oriented_edge(g, og, num_threads, [&](size_t e, size_t slot) {
+    truss[e] = static_cast<range_value_t<Truss>>(slot_truss[slot]);
+  });
+  return max_truss;
+}
+
 } // namespace graph
 
 #endif //GRAPH_TC_HPP
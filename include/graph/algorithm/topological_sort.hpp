@@ -1,7 +1,7 @@
 /**
  * @file topological_sort.hpp
  * 
- * @brief Single-Source & multi-source topological sort search.
+ * @brief Topological sort of a directed acyclic graph, with the level of each vertex and cycle detection.
  * 
  * @copyright Copyright (c) 2024
  * 
@@ -11,102 +11,177 @@
  */
 
 #include "graph/graph.hpp"
-#include "graph/views/incidence.hpp"
+#include "graph/algorithm/common_shortest_paths.hpp"
+#include "graph/detail/parallel.hpp"
 
 #include <vector>
-#include <queue>
 #include <ranges>
-#include <limits>
+#include <atomic>
+#include <barrier>
+#include <stdexcept>
+#include <format>
 
 #ifndef GRAPH_TOPO_SORT_ALGO_HPP
 #  define GRAPH_TOPO_SORT_ALGO_HPP
 
 namespace graph {
 
-using vertex_id_type = int;
-using Graph          = std::vector<std::vector<vertex_id_type>>;
-using Predecessors   = std::vector<vertex_id_type>;
-using Source         = vertex_id_type;
-using Sources        = std::vector<Source>;
-using Distance       = int;
-using Distances      = std::vector<Distance>;
-
-class topological_sort_visitor_base {
-  // Types
-public:
-  // Visitor Functions
-public:
-  // vertex visitor functions
-  void on_initialize_vertex(const vertex_id_type& uid) {}
-  void on_discover_vertex(const vertex_id_type& uid) {}
-  void on_examine_vertex(const vertex_id_type& uid) {}
-  void on_finish_vertex(const vertex_id_type& uid) {}
-
-  // edge visitor functions
-  void on_examine_edge(const vertex_id_type& uid) {}
-};
-
-/**
- * @ingroup graph_algorithms
- * @brief Returns the largest value used to represent an infinite distance.
- * 
- * @return The largest possible distance value.
-*/
-inline Distance topological_sort_infinite_distance() { return std::numeric_limits<Distance>::max(); }
-
-/**
- * @ingroup graph_algorithms
- * @brief Returns a distance value of zero.
- * 
- * @return A value of zero distance.
-*/
-inline Distance topological_sort_zero() { return 0; }
-
 /**
  * @ingroup graph_algorithms
- * @brief Intializes the distance values to the infinite value.
- * 
- * @param distances The range of distance values to initialize.
-*/
-inline void init_topological_sort(Distances& distances) {
-  for (size_t i = 0; i < distances.size(); ++i) {
-    distances[i] = topological_sort_infinite_distance();
+ * @brief Topological sort with Kahn's algorithm, processing a level of vertices at a time on multiple threads.
+ *
+ * The in-degree of every vertex is counted in parallel with atomic increments. The vertices with no in-edges are
+ * level 0. Each level is then expanded by num_threads threads: every edge out of the level atomically decrements
+ * the in-degree of its target, and the thread whose decrement reaches zero adds the target to its local buffer.
+ * The buffers are copied into order at offsets given by a prefix sum of their sizes, and become the next level.
+ *
+ * The vertices in order are grouped by level, and the level of a vertex is the number of edges in the longest
+ * path to it from a vertex with no in-edges. The vertices of a level don't depend on each other, so they can be
+ * scheduled at the same time once the previous levels are done. The order of the vertices within a level depends
+ * on the threads.
+ *
+ * When the graph has a cycle, the vertices on a cycle, and those reachable from one, are never added. order then
+ * contains the vertices that could be sorted, with the rest of it unchanged, and false is returned.
+ *
+ * Complexity: O(V + E) work, with a barrier per level
+ *
+ * Throws:
+ *  - out_of_range if order or levels is smaller than the number of vertices.
+ *
+ * @tparam G      The graph type.
+ * @tparam Order  The random access range of vertex ids in topological order.
+ * @tparam Levels The random access range of levels.
+ *
+ * @param g           The graph.
+ * @param order       [out] The vertex ids in topological order. The caller must assure
+ *                    size(order) >= size(vertices(g)).
+ * @param levels      [out] The level of each vertex sorted, accessible through levels[uid]. The levels of the
+ *                    vertices that couldn't be sorted are unchanged.
+ * @param num_threads The number of threads to use, including the calling thread.
+ *
+ * @return true if all vertices were sorted, false if the graph has a cycle.
+ */
+template <index_adjacency_list G, random_access_range Order, random_access_range Levels>
+requires convertible_to<vertex_id_t<G>, range_value_t<Order>> && //
+         convertible_to<range_value_t<Order>, vertex_id_t<G>> && //
+         is_arithmetic_v<range_value_t<Levels>> &&               //
+         sized_range<Order> && sized_range<Levels>
+bool topological_sort(G&& g, Order& order, Levels& levels, size_t num_threads = hardware_thread_count()) {
+  using id_type    = vertex_id_t<G>;
+  using level_type = range_value_t<Levels>;
+
+  const size_t N = num_vertices(g);
+  if (size(order) < N) {
+    throw std::out_of_range(
+          std::format("topological_sort: size of order of {} is less than the number of vertices {}", size(order), N));
   }
-}
-
-/**
- * @ingroup graph_algorithms
- * @brief Intializes the distance and predecessor values for topological sort.
- * 
- * @param distances The range of distance values to initialize. Each value will be assigned the infinite distance.
- * @param predecessors The range of predecessors to initialize. Each value will be assigned the vertex id.
-*/
-inline void init_topological_sort(Distances& distances, Predecessors& predecessors) {
-  init_topological_sort(distances);
-  for (size_t i = 0; i < predecessors.size(); ++i) {
-    predecessors[i] = static_cast<range_value_t<Predecessors>>(i);
+  if constexpr (!is_same_v<Levels, _null_range_type>) {
+    if (size(levels) < N) {
+      throw std::out_of_range(std::format(
+            "topological_sort: size of levels of {} is less than the number of vertices {}", size(levels), N));
+    }
   }
+  num_threads = std::max(std::min(num_threads, (N + 1023) / 1024), size_t(1));
+
+  std::vector<size_t>               in_degree(N, 0);
+  std::vector<std::vector<id_type>> local(num_threads);
+  std::vector<size_t>               thread_offsets(num_threads + 1, 0); // where local[tid] goes in order
+  dynamic_chunks                    work(N, 1024);
+  size_t                            head = 0, tail = 0; // the current level is order[head, tail)
+  level_type                        level = 0;
+  bool                              done  = false;
+
+  // The serial work between the phases is done by the barrier's completion function
+  int  phase      = 0;
+  auto completion = [&]() noexcept {
+    if (phase == 0) { // in-degrees are complete: look for the vertices with none
+      work.reset(N, 1024);
+      phase = 1;
+    } else if (phase == 1) { // local buffers are complete: evaluate where they go in order
+      for (size_t tid = 0; tid < num_threads; ++tid) {
+        thread_offsets[tid + 1] = thread_offsets[tid] + local[tid].size();
+      }
+      head = tail;
+      tail = head + thread_offsets[num_threads];
+      phase = 2;
+    } else { // the next level is in order: expand it
+      done = (head == tail);
+      work.reset(tail - head, 256);
+      ++level;
+      phase = 1;
+    }
+  };
+  std::barrier sync(static_cast<std::ptrdiff_t>(num_threads), completion);
+
+  parallel_invoke(num_threads, [&](size_t tid) {
+    std::vector<id_type>& found = local[tid];
+    work.for_each([&](size_t first, size_t last) {
+      for (size_t uid = first; uid < last; ++uid) {
+        for (auto&& uv : edges(g, static_cast<id_type>(uid))) {
+          std::atomic_ref<size_t>(in_degree[static_cast<size_t>(target_id(g, uv))])
+                .fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+    });
+    sync.arrive_and_wait();
+
+    work.for_each([&](size_t first, size_t last) {
+      for (size_t uid = first; uid < last; ++uid) {
+        if (in_degree[uid] == 0) {
+          found.push_back(static_cast<id_type>(uid));
+        }
+      }
+    });
+    sync.arrive_and_wait();
+
+    for (;;) {
+      // Copy the vertices found into the next level
+      size_t i = head + thread_offsets[tid];
+      for (id_type uid : found) {
+        order[i++] = static_cast<range_value_t<Order>>(uid);
+        if constexpr (!is_same_v<Levels, _null_range_type>) {
+          levels[static_cast<size_t>(uid)] = level;
+        }
+      }
+      found.clear();
+      sync.arrive_and_wait();
+      if (done) {
+        break;
+      }
+
+      // Expand the level, finding the vertices whose last in-edge is from it
+      work.for_each([&](size_t first, size_t last) {
+        for (size_t j = head + first; j < head + last; ++j) {
+          for (auto&& uv : edges(g, static_cast<id_type>(order[j]))) {
+            const id_type vid = target_id(g, uv);
+            if (std::atomic_ref<size_t>(in_degree[static_cast<size_t>(vid)])
+                      .fetch_sub(1, std::memory_order_relaxed) == 1) {
+              found.push_back(vid);
+            }
+          }
+        }
+      });
+      sync.arrive_and_wait();
+    }
+  });
+
+  return tail == N;
 }
 
 /**
- * @brief Single-source topological sort.
- * 
- * @param g            The graph.
- * @param source	   The source vertex.
- * @param predecessors The predecessor vertex for g[uid].
+ * @ingroup graph_algorithms
+ * @brief Topological sort with Kahn's algorithm on multiple threads, without the levels.
+ *
+ * @return true if all vertices were sorted, false if the graph has a cycle.
  */
-
-// C++
-inline void topological_sort(const Graph& g, const Source& source, Distances& distances, Predecessors& predecessors) {}
-
-// C
-inline void topological_sort(const Graph*  g,
-                             const Source  source,
-                             const size_t  distances_len,
-                             Distances*    distances,
-                             const size_t  predecessors_len,
-                             Predecessors* predecessors) {}
-
+template <index_adjacency_list G, random_access_range Order>
+requires convertible_to<vertex_id_t<G>, range_value_t<Order>> && //
+         convertible_to<range_value_t<Order>, vertex_id_t<G>> && //
+         sized_range<Order>
+bool topological_sort(G&& g, Order& order, size_t num_threads = hardware_thread_count()) {
+  _null_range_type levels;
+  return topological_sort(g, order, levels, num_threads);
+}
 
 } // namespace graph
 
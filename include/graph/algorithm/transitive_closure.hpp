@@ -3,7 +3,15 @@
 #include "graph/graph.hpp"
 #include "graph/views/vertexlist.hpp"
 #include "graph/views/incidence.hpp"
+#include "graph/algorithm/connected_components.hpp"
+#include "graph/detail/parallel.hpp"
 #include <vector>
+#include <span>
+#include <bit>
+#include <cstdint>
+#include <algorithm>
+#include <numeric>
+#include <limits>
 
 namespace graph {
 
@@ -43,8 +51,9 @@ constexpr void warshall_transitive_closure(G& g, OutIter result_iter, Alloc allo
   // evaluate transitive closure
   for (auto&& [kid, k] : vertexlist(g))
     for (auto&& [uid, u] : vertexlist(g))
-      for (auto&& [vid, v] : vertexlist(g))
-        reach[uid * V] = reach[uid * V + vid] || (reach[uid * V + kid] && reach[kid * V + vid]);
+      if (reach[uid * V + kid])
+        for (auto&& [vid, v] : vertexlist(g))
+          reach[uid * V + vid] = reach[uid * V + vid] || reach[kid * V + vid];
 
   // output results
   for (auto&& [uid, u] : vertexlist(g))
@@ -53,4 +62,268 @@ constexpr void warshall_transitive_closure(G& g, OutIter result_iter, Alloc allo
         *result_iter = {uid, vid};
 }
 
+/**
+ * @brief A dense matrix of bits, with each row stored in 64-bit words so rows can be combined a word at
+ * a time.
+*/
+class bit_matrix {
+public:
+  using word_type                       = uint64_t;
+  static constexpr size_t bits_per_word = std::numeric_limits<word_type>::digits;
+
+  bit_matrix() = default;
+  bit_matrix(size_t rows, size_t cols)
+        : rows_(rows)
+        , cols_(cols)
+        , words_per_row_((cols + bits_per_word - 1) / bits_per_word)
+        , words_(rows * words_per_row_) {}
+
+  constexpr size_t rows() const noexcept { return rows_; }
+  constexpr size_t cols() const noexcept { return cols_; }
+  constexpr size_t words_per_row() const noexcept { return words_per_row_; }
+
+  bool test(size_t r, size_t c) const noexcept {
+    return (words_[r * words_per_row_ + c / bits_per_word] >> (c % bits_per_word)) & 1;
+  }
+  void set(size_t r, size_t c) noexcept {
+    words_[r * words_per_row_ + c / bits_per_word] |= word_type(1) << (c % bits_per_word);
+  }
+
+  std::span<word_type> row(size_t r) noexcept { return {words_.data() + r * words_per_row_, words_per_row_}; }
+  std::span<const word_type> row(size_t r) const noexcept {
+    return {words_.data() + r * words_per_row_, words_per_row_};
+  }
+
+  /**
+   * @brief The number of bits set in row r.
+  */
+  size_t count(size_t r) const noexcept {
+    size_t n = 0;
+    for (word_type w : row(r))
+      n += static_cast<size_t>(std::popcount(w));
+    return n;
+  }
+
+  /**
+   * @brief The number of bits set in the matrix.
+  */
+  size_t count() const noexcept {
+    size_t n = 0;
+    for (word_type w : words_)
+      n += static_cast<size_t>(std::popcount(w));
+    return n;
+  }
+
+  /**
+   * @brief Calls f(c) for each column c with its bit set in row r, in increasing order.
+  */
+  template <class F>
+  void for_each_set(size_t r, F&& f) const {
+    const word_type* words = words_.data() + r * words_per_row_;
+    for (size_t w = 0; w < words_per_row_; ++w) {
+      for (word_type bits = words[w]; bits != 0; bits &= bits - 1) {
+        f(w * bits_per_word + static_cast<size_t>(std::countr_zero(bits)));
+      }
+    }
+  }
+
+  bool operator==(const bit_matrix&) const = default;
+
+private:
+  size_t                 rows_          = 0;
+  size_t                 cols_          = 0;
+  size_t                 words_per_row_ = 0;
+  std::vector<word_type> words_;
+};
+
+/**
+ * @brief The graph of the strongly connected components of a graph (its condensation) in compressed
+ * form. The successors of component c are targets[first[c]..first[c+1]), without duplicates and in
+ * decreasing order, which is topological order when the components are numbered by tarjan_scc().
+*/
+template <class CId>
+struct _condensation {
+  std::vector<size_t> first;   // C+1 offsets into targets
+  std::vector<CId>    targets; // successor components
+  std::vector<char>   cyclic;  // the component has more than one vertex or a vertex with a self loop
+};
+
+template <class CId, adjacency_list G, random_access_range Component>
+requires random_access_range<vertex_range_t<G>> && integral<vertex_id_t<G>>
+_condensation<CId> _condense(G&& g, const Component& component, const size_t C, const size_t num_threads) {
+  using id_type = vertex_id_t<G>;
+  const size_t N(size(vertices(g)));
+
+  // Group the vertices by component
+  std::vector<size_t>  comp_first(C + 1, 0);
+  std::vector<id_type> members(N);
+  for (size_t uid = 0; uid < N; ++uid)
+    ++comp_first[static_cast<size_t>(component[uid]) + 1];
+  std::inclusive_scan(comp_first.begin(), comp_first.end(), comp_first.begin());
+  {
+    std::vector<size_t> pos(comp_first.begin(), comp_first.end() - 1);
+    for (size_t uid = 0; uid < N; ++uid)
+      members[pos[static_cast<size_t>(component[uid])]++] = static_cast<id_type>(uid);
+  }
+
+  _condensation<CId>            result;
+  std::vector<std::vector<CId>> successors(C);
+  result.cyclic.assign(C, false);
+  parallel_for(C, num_threads, 64, [&](size_t first, size_t last, size_t) {
+    for (size_t c = first; c < last; ++c) {
+      result.cyclic[c] = (comp_first[c + 1] - comp_first[c]) > 1;
+      for (size_t i = comp_first[c]; i < comp_first[c + 1]; ++i) {
+        for (auto&& uv : edges(g, members[i])) {
+          const size_t d = static_cast<size_t>(component[static_cast<size_t>(target_id(g, uv))]);
+          if (d != c)
+            successors[c].push_back(static_cast<CId>(d));
+          else if (static_cast<id_type>(target_id(g, uv)) == members[i])
+            result.cyclic[c] = true; // self loop
+        }
+      }
+      std::ranges::sort(successors[c], std::greater<CId>());
+      successors[c].erase(std::unique(successors[c].begin(), successors[c].end()), successors[c].end());
+    }
+  });
+
+  result.first.assign(C + 1, 0);
+  for (size_t c = 0; c < C; ++c)
+    result.first[c + 1] = result.first[c] + successors[c].size();
+  result.targets.resize(result.first[C]);
+  parallel_for(C, num_threads, 256, [&](size_t first, size_t last, size_t) {
+    for (size_t c = first; c < last; ++c)
+      std::ranges::copy(successors[c], result.targets.begin() + static_cast<ptrdiff_t>(result.first[c]));
+  });
+  return result;
+}
+
+/**
+ * @ingroup graph_algorithms
+ * @brief The transitive closure of the graph of the strongly connected components of a directed graph
+ * (its condensation), using multiple threads.
+ *
+ * The components are found with tarjan_scc(), which numbers them in reverse topological order, so
+ * a component only reaches components with a lower number. Each row of the closure is the OR of the
+ * rows of its successors, and only the words for lower numbered components are combined. Successors are
+ * combined in topological order, skipping those already reached through another successor. Components
+ * with the same height in the condensation don't depend on each other, so their rows are evaluated in
+ * parallel, one height at a time.
+ *
+ * A component reaches itself when it has more than one vertex or a vertex with a self loop.
+ *
+ * Complexity: O(V + E + C * E_c / 64) for C components with E_c edges between them
+ *
+ * @tparam G          The graph type.
+ * @tparam Component  The random access range for the component of each vertex.
+ *
+ * @param g           The graph.
+ * @param component   [out] The strongly connected component of each vertex.
+ * @param num_threads The number of threads to use, including the calling thread.
+ *
+ * @return The closure: bit (c, d) is set when component c reaches component d.
+ */
+template <adjacency_list G, random_access_range Component>
+requires random_access_range<vertex_range_t<G>> && integral<vertex_id_t<G>> && integral<range_value_t<Component>>
+bit_matrix condensed_transitive_closure(G&&          g,
+                                        Component&   component,
+                                        const size_t num_threads = hardware_thread_count()) {
+  using word_type        = bit_matrix::word_type;
+  const size_t C         = tarjan_scc(g, component);
+  const auto   condensed = _condense<size_t>(g, component, C, num_threads);
+  const auto&  offsets   = condensed.first;
+  const auto&  targets   = condensed.targets;
+
+  // Components by height in the condensation; successors have lower numbers, so they come first
+  std::vector<size_t> height(C, 0);
+  size_t              max_height = 0;
+  for (size_t c = 0; c < C; ++c) {
+    for (size_t i = offsets[c]; i < offsets[c + 1]; ++i)
+      height[c] = std::max(height[c], height[targets[i]] + 1);
+    max_height = std::max(max_height, height[c]);
+  }
+  std::vector<std::vector<size_t>> by_height(C > 0 ? max_height + 1 : 0);
+  for (size_t c = 0; c < C; ++c)
+    by_height[height[c]].push_back(c);
+
+  bit_matrix closure(C, C);
+  for (auto& level : by_height) {
+    parallel_for(level.size(), num_threads, 16, [&](size_t first, size_t last, size_t) {
+      for (size_t i = first; i < last; ++i) {
+        const size_t c     = level[i];
+        word_type*   row   = closure.row(c).data();
+        const size_t words = c / bit_matrix::bits_per_word + 1; // only components <= c can be reached
+        if (condensed.cyclic[c])
+          closure.set(c, c);
+        for (size_t j = offsets[c]; j < offsets[c + 1]; ++j) {
+          const size_t d = targets[j];
+          if (closure.test(c, d))
+            continue; // already reached through a successor combined earlier
+          closure.set(c, d);
+          const word_type* drow = closure.row(d).data();
+          for (size_t w = 0; w < words; ++w)
+            row[w] |= drow[w];
+        }
+      }
+    });
+  }
+  return closure;
+}
+
+/**
+ * @ingroup graph_algorithms
+ * @brief The transitive closure of a directed graph as a bit matrix, using multiple threads.
+ *
+ * Bit (u, v) is set when there is a path with at least one edge from u to v. The closure is evaluated
+ * for the condensation of the graph with condensed_transitive_closure(), then the row of each component
+ * is expanded to its member vertices in parallel. When only reachability queries are needed, the
+ * condensed closure and component of each vertex can be used directly and take much less memory.
+ *
+ * Complexity: O(V + E + C * E_c / 64 + V^2 / 64) for C components with E_c edges between them
+ *
+ * @tparam G          The graph type.
+ *
+ * @param g           The graph.
+ * @param num_threads The number of threads to use, including the calling thread.
+ *
+ * @return The V x V closure.
+ */
+template <adjacency_list G>
+requires random_access_range<vertex_range_t<G>> && integral<vertex_id_t<G>>
+bit_matrix transitive_closure(G&& g, const size_t num_threads = hardware_thread_count()) {
+  using word_type = bit_matrix::word_type;
+  const size_t        N(size(vertices(g)));
+  std::vector<size_t> component(N);
+  const bit_matrix    condensed = condensed_transitive_closure(g, component, num_threads);
+  const size_t        C         = condensed.rows();
+
+  std::vector<size_t> comp_first(C + 1, 0);
+  std::vector<size_t> members(N);
+  for (size_t uid = 0; uid < N; ++uid)
+    ++comp_first[component[uid] + 1];
+  std::inclusive_scan(comp_first.begin(), comp_first.end(), comp_first.begin());
+  {
+    std::vector<size_t> pos(comp_first.begin(), comp_first.end() - 1);
+    for (size_t uid = 0; uid < N; ++uid)
+      members[pos[component[uid]]++] = uid;
+  }
+
+  bit_matrix closure(N, N);
+  parallel_for(C, num_threads, 16, [&](size_t first, size_t last, size_t) {
+    for (size_t c = first; c < last; ++c) {
+      if (comp_first[c] == comp_first[c + 1])
+        continue;
+      // Expand the row of the component into the row of its first member, then copy it to the others
+      const size_t uid = members[comp_first[c]];
+      condensed.for_each_set(c, [&](size_t d) {
+        for (size_t i = comp_first[d]; i < comp_first[d + 1]; ++i)
+          closure.set(uid, members[i]);
+      });
+      std::span<const word_type> row = closure.row(uid);
+      for (size_t i = comp_first[c] + 1; i < comp_first[c + 1]; ++i)
+        std::ranges::copy(row, closure.row(members[i]).begin());
+    }
+  });
+  return closure;
+}
+
 } // namespace graph
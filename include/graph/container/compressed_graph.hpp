@@ -660,6 +660,7 @@ public: // Operations
 
     // add any rows that haven't been added yet, and (+1) terminating row
     row_index_.resize(vertex_count + 1, vertex_type{static_cast<vertex_id_type>(col_index_.size())});
+    terminate_partitions();
 
     // If load_vertices(vrng,vproj) has been called but it doesn't have enough values for all
     // the vertices then we extend the size to remove possibility of out-of-bounds occuring when
@@ -722,6 +723,7 @@ public: // Operations
 
     // add any rows that haven't been added yet, and (+1) terminating row
     row_index_.resize(vertex_count + 1, vertex_type{static_cast<vertex_id_type>(col_index_.size())});
+    terminate_partitions();
 
     // If load_vertices(vrng,vproj) has been called but it doesn't have enough values for all
     // the vertices then we extend the size to remove possibility of out-of-bounds occuring when
@@ -769,14 +771,20 @@ protected:
     return last_id;
   }
 
+  // The last partition ends at the number of vertices, which is found when needed rather than stored, so it's
+  // correct whether this is called before or after the edges are loaded, and may be called more than once.
   constexpr void terminate_partitions() {
     if (partition_.empty())
       partition_.push_back(0);
     else
       assert(partition_[0] == 0 &&
              is_sorted(partition_.begin(), partition_.end())); // must start with vertex_id 0 and be in increasing order
+  }
 
-    partition_.push_back(static_cast<partition_id_type>(row_index_.size()));
+  constexpr vertex_id_type partition_end(partition_id_type pid) const noexcept {
+    if (static_cast<size_t>(pid) + 1 < partition_.size())
+      return partition_[static_cast<size_t>(pid) + 1];
+    return static_cast<vertex_id_type>(row_index_.empty() ? 0 : row_index_.size() - 1); // excludes terminating row
   }
 
 public: // Operations
@@ -800,7 +808,6 @@ private:                       // Member variables
   row_index_vector row_index_; // starting index into col_index_ and v_; holds +1 extra terminating row
   col_index_vector col_index_; // col_index_[n] holds the column index (aka target)
   partition_vector partition_; // partition_[n] holds the first vertex id for each partition n
-                               // holds +1 extra terminating partition
 
   //v_vector_type    v_;         // v_[n]         holds the edge value for col_index_[n]
   //row_values_type  row_value_; // row_value_[r] holds the value for row_index_[r], for VV!=void
@@ -859,6 +866,12 @@ private: // CPO properties
                             g.col_index_.begin() + g.row_index_[static_cast<size_type>(uid + 1)].index);
   }
 
+  // degree(g,uid) is the difference of the row's index and the next row's index, without forming the edge range
+  friend constexpr auto degree(const compressed_graph_base& g, const vertex_id_type uid) noexcept {
+    assert(static_cast<size_t>(uid + 1) < g.row_index_.size()); // in row_index_ bounds?
+    return static_cast<size_type>(g.row_index_[static_cast<size_type>(uid) + 1].index -
+                                  g.row_index_[static_cast<size_type>(uid)].index);
+  }
 
   // target_id(g,uv), target(g,uv)
   friend constexpr vertex_id_type target_id(const graph_type& g, const edge_type& uv) noexcept { return uv.index; }
@@ -871,7 +884,7 @@ private: // CPO properties
   }
 
   friend constexpr auto num_partitions(const compressed_graph_base& g) {
-    return static_cast<partition_id_type>(g.partition_.size() - 1);
+    return static_cast<partition_id_type>(g.partition_.size());
   }
 
   friend constexpr auto partition_id(const compressed_graph_base& g, vertex_id_type uid) {
@@ -880,13 +893,13 @@ private: // CPO properties
   }
 
   friend constexpr auto num_vertices(const compressed_graph_base& g, partition_id_type pid) {
-    assert(static_cast<size_t>(pid) < g.partition_.size() - 1);
-    return g.partition_[pid + 1] - g.partition_[pid];
+    assert(static_cast<size_t>(pid) < g.partition_.size());
+    return g.partition_end(pid) - g.partition_[pid];
   }
 
   friend constexpr auto vertices(const compressed_graph_base& g, partition_id_type pid) {
-    assert(static_cast<size_t>(pid) < g.partition_.size() - 1);
-    return subrange(g.row_index_.begin() + g.partition_[pid], g.row_index_.begin() + g.partition_[pid + 1]);
+    assert(static_cast<size_t>(pid) < g.partition_.size());
+    return subrange(g.row_index_.begin() + g.partition_[pid], g.row_index_.begin() + g.partition_end(pid));
   }
 
   friend row_values_base;
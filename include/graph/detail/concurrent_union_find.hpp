@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <ranges>
+#include <concepts>
+#include <utility>
+
+// A union-find over a range of parent ids that can be updated by many threads at once, with the root
+// of each set being its lowest id. The algorithm is Jayanti and Tarjan's linking by index with path
+// halving, where every update is a single compare-and-swap: finds never wait for another thread, and a
+// union only retries when another thread has changed one of its roots first. Initialize the range with
+// parent[i] == i.
+//
+// Linking the higher root to the lower one means a root never gets a parent with a higher id, so the
+// parents can be used directly as component ids once every element points to its root. The parallel
+// connected components and Boruvka's minimum spanning tree use the same range for both.
+
+namespace graph {
+
+/**
+ * @brief The root of the set containing x, halving the path to it.
+*/
+template <std::ranges::random_access_range Parent>
+requires std::integral<std::ranges::range_value_t<Parent>>
+std::ranges::range_value_t<Parent> concurrent_find(Parent& parent, std::ranges::range_value_t<Parent> x) noexcept {
+  using T   = std::ranges::range_value_t<Parent>;
+  auto load = [&parent](T i) {
+    return std::atomic_ref<T>(parent[static_cast<size_t>(i)]).load(std::memory_order_relaxed);
+  };
+  for (T p = load(x); p != x; p = load(x)) {
+    const T gp = load(p);
+    if (gp != p) // point x to its grandparent; a failure only means another thread got there first
+      std::atomic_ref<T>(parent[static_cast<size_t>(x)]).compare_exchange_weak(p, gp, std::memory_order_relaxed);
+    x = gp;
+  }
+  return x;
+}
+
+/**
+ * @brief Unites the sets containing x and y.
+ *
+ * @return true if they were different sets and this call linked them, false if they were already the
+ *         same set. When several threads unite the same two sets, exactly one of them returns true.
+*/
+template <std::ranges::random_access_range Parent>
+requires std::integral<std::ranges::range_value_t<Parent>>
+bool concurrent_union_find(Parent&                            parent,
+                           std::ranges::range_value_t<Parent> x,
+                           std::ranges::range_value_t<Parent> y) noexcept {
+  using T = std::ranges::range_value_t<Parent>;
+  for (;;) {
+    T rx = concurrent_find(parent, x);
+    T ry = concurrent_find(parent, y);
+    if (rx == ry)
+      return false;
+    if (rx < ry)
+      std::swap(rx, ry);
+    // Link the higher root to the lower one, only if it is still a root
+    T expected = rx;
+    if (std::atomic_ref<T>(parent[static_cast<size_t>(rx)])
+              .compare_exchange_strong(expected, ry, std::memory_order_relaxed))
+      return true;
+    x = rx;
+    y = ry;
+  }
+}
+
+/**
+ * @brief Are x and y in the same set? The answer is exact when no union of their sets is in progress.
+*/
+template <std::ranges::random_access_range Parent>
+requires std::integral<std::ranges::range_value_t<Parent>>
+bool concurrent_same_set(Parent&                            parent,
+                         std::ranges::range_value_t<Parent> x,
+                         std::ranges::range_value_t<Parent> y) noexcept {
+  using T = std::ranges::range_value_t<Parent>;
+  for (;;) {
+    const T rx = concurrent_find(parent, x);
+    const T ry = concurrent_find(parent, y);
+    if (rx == ry)
+      return true;
+    // rx is still a root, so ry wasn't linked to it between the two finds
+    if (std::atomic_ref<T>(parent[static_cast<size_t>(rx)]).load(std::memory_order_relaxed) == rx)
+      return false;
+    x = rx;
+    y = ry;
+  }
+}
+
+} // namespace graph
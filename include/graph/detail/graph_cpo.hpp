@@ -150,7 +150,8 @@ template <class G>
 concept adjacency_matrix = is_adjacency_matrix_v<G>;
 
 //
-// vertices(g) -> vertex_range_t<G>
+// vertices(g)     -> vertex_range_t<G>
+// vertices(g,pid) -> range of the vertices in partition pid; no default, must be defined by a partitioned graph
 //
 // vertex_range_t<G>     = decltype(vertices(g))
 // vertex_iterator_t<G>  = ranges::iterator_t<vertex_range_t<G>>
@@ -178,6 +179,12 @@ namespace _Vertices {
   template <class _G>
   concept _Can_ref_eval = _HasClassOrEnumType<_G> && random_access_range<_G>;
 
+  template <class _G, class _PId>
+  concept _Has_id_ADL = _HasClassOrEnumType<_G> //
+                        && requires(_G&& __g, const _PId& pid) {
+                             { _Fake_copy_init(vertices(__g, pid)) }; // intentional ADL
+                           };
+
   class _Cpo {
   private:
     enum class _St_ref { _None, _Member, _Non_member, _Auto_eval };
@@ -229,6 +236,27 @@ namespace _Vertices {
         static_assert(_AlwaysFalse<_G>, "vertices(g) is not defined");
       }
     }
+
+    /**
+     * @brief Returns the range of vertices in partition pid of a graph G.
+     * 
+     * Default implementation: n/a.
+     * 
+     * Complexity: O(1)
+     * 
+     * This is a customization point function that is only defined for graph types that have partitions.
+     * 
+     * @tparam G   The graph type
+     * @tparam PId The partition id type
+     * @param g   A graph instance
+     * @param pid The partition id
+    */
+    template <class _G, class _PId>
+    requires _Has_id_ADL<_G&, _PId>
+    [[nodiscard]] constexpr auto operator()(_G&& __g, const _PId& pid) const
+          noexcept(noexcept(_Fake_copy_init(vertices(__g, pid)))) -> decltype(auto) {
+      return vertices(__g, pid); // intentional ADL
+    }
   };
 } // namespace _Vertices
 
@@ -1845,7 +1873,6 @@ namespace _NumVertices {
     [[nodiscard]] constexpr auto operator()(_G&& __g, const partition_id_t<_G>& pid) const
           noexcept(_Choice_id<_G&>._No_throw) {
       constexpr _St_id _Strat_id = _Choice_id<_G&>._Strategy;
-      static_assert(_Strat_id == _St_id::_Auto_eval);
 
       if constexpr (_Strat_id == _St_id::_Non_member) {
         return num_vertices(__g, pid); // intentional ADL
@@ -2404,8 +2431,7 @@ namespace _Num_partitions {
       if constexpr (_Has_ref_member<_G>) {
         return {_St_ref::_Member, noexcept(_Fake_copy_init(declval<_G>().num_partitions()))};
       } else if constexpr (_Has_ref_ADL<_G>) {
-        return {_St_ref::_Non_member, noexcept(_Fake_copy_init(num_partitions(
-                                            declval<_G>(), declval<vertex_reference_t<_G>>())))}; // intentional ADL
+        return {_St_ref::_Non_member, noexcept(_Fake_copy_init(num_partitions(declval<_G>())))}; // intentional ADL
       } else if constexpr (_Can_ref_eval<_G>) {
         return {_St_ref::_Auto_eval, noexcept(_Fake_copy_init(vertex_id_t<_G>(1)))};
       } else {
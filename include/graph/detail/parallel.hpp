@@ -0,0 +1,269 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+// Minimal threading support for the parallel algorithms, using std::thread only so that no
+// additional dependency (e.g. OpenMP or TBB) is required.
+
+namespace graph {
+
+/**
+ * @brief The number of threads used by the parallel algorithms when one isn't given.
+ *
+ * @return std::thread::hardware_concurrency(), or 1 if it can't be determined.
+*/
+inline size_t hardware_thread_count() noexcept {
+  const unsigned n = std::thread::hardware_concurrency();
+  return n > 0 ? static_cast<size_t>(n) : size_t(1);
+}
+
+/**
+ * @brief Calls f(tid) for tid in [0, num_threads), each on its own thread, and waits for them to finish.
+ *
+ * The calling thread is used for tid 0 and no thread is created when num_threads <= 1. If f throws on
+ * any thread, the first exception is rethrown after all threads have finished. Threads that need to
+ * synchronize with each other should use a std::barrier of num_threads participants.
+ *
+ * @tparam F Function type, invocable as f(size_t tid).
+ *
+ * @param num_threads The number of threads, including the calling thread.
+ * @param f           The function to call on each thread.
+*/
+template <class F>
+void parallel_invoke(size_t num_threads, F&& f) {
+  if (num_threads <= 1) {
+    f(size_t(0));
+    return;
+  }
+
+  std::exception_ptr error;
+  std::mutex         error_mutex;
+  auto               run = [&](size_t tid) {
+    try {
+      f(tid);
+    } catch (...) {
+      std::lock_guard lock(error_mutex);
+      if (!error)
+        error = std::current_exception();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads - 1);
+  for (size_t tid = 1; tid < num_threads; ++tid)
+    threads.emplace_back(run, tid);
+  run(0);
+  for (auto& t : threads)
+    t.join();
+
+  if (error)
+    std::rethrow_exception(error);
+}
+
+/**
+ * @brief Hands out chunks of an index range [0, n) to the threads that ask for them.
+ *
+ * Threads that finish their chunks early keep taking the remaining ones, balancing the load when the
+ * cost per index varies (dynamic scheduling). reset() must only be called when no thread is taking chunks,
+ * typically from a barrier's completion function.
+*/
+class dynamic_chunks {
+public:
+  dynamic_chunks() = default;
+  dynamic_chunks(size_t n, size_t chunk_size) : n_(n), chunk_(std::max(chunk_size, size_t(1))) {}
+
+  void reset(size_t n, size_t chunk_size) noexcept {
+    n_     = n;
+    chunk_ = std::max(chunk_size, size_t(1));
+    next_.store(0, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Calls f(first, last) for each chunk taken by the calling thread until none are left.
+  */
+  template <class F>
+  void for_each(F&& f) {
+    for (size_t first = next_.fetch_add(chunk_, std::memory_order_relaxed); first < n_;
+         first        = next_.fetch_add(chunk_, std::memory_order_relaxed)) {
+      f(first, std::min(first + chunk_, n_));
+    }
+  }
+
+private:
+  std::atomic<size_t> next_{0};
+  size_t              n_     = 0;
+  size_t              chunk_ = 1;
+};
+
+/**
+ * @brief Calls f(first, last, tid) for chunks of [0, n) on num_threads threads with dynamic scheduling.
+ *
+ * @tparam F Function type, invocable as f(size_t first, size_t last, size_t tid).
+ *
+ * @param n           The number of indexes.
+ * @param num_threads The number of threads, including the calling thread.
+ * @param chunk_size  The number of indexes in each chunk. A value of 0 is taken as 1.
+ * @param f           The function to call for each chunk.
+*/
+template <class F>
+void parallel_for(size_t n, size_t num_threads, size_t chunk_size, F&& f) {
+  chunk_size = std::max(chunk_size, size_t(1));
+  if (num_threads <= 1 || n <= chunk_size) {
+    if (n > 0)
+      f(size_t(0), n, size_t(0));
+    return;
+  }
+  dynamic_chunks chunks(n, chunk_size);
+  parallel_invoke(std::min(num_threads, (n + chunk_size - 1) / chunk_size), [&](size_t tid) {
+    chunks.for_each([&](size_t first, size_t last) { f(first, last, tid); });
+  });
+}
+
+/**
+ * @brief Atomically replaces obj with value if value is less than obj.
+ *
+ * @return true if obj was replaced by value.
+*/
+template <class T>
+bool atomic_fetch_min(T& obj, const T value) noexcept {
+  std::atomic_ref<T> ref(obj);
+  T                  current = ref.load(std::memory_order_relaxed);
+  while (value < current) {
+    if (ref.compare_exchange_weak(current, value, std::memory_order_relaxed))
+      return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Atomically replaces obj with value if value is greater than obj.
+ *
+ * @return true if obj was replaced by value.
+*/
+template <class T>
+bool atomic_fetch_max(T& obj, const T value) noexcept {
+  std::atomic_ref<T> ref(obj);
+  T                  current = ref.load(std::memory_order_relaxed);
+  while (current < value) {
+    if (ref.compare_exchange_weak(current, value, std::memory_order_relaxed))
+      return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Reorders [first, last) so the elements for which pred is true come first, using num_threads
+ * threads. The relative order of the elements is kept (the partition is stable).
+ *
+ * Each thread flags the elements of a block, then moves them to their place in a buffer, and the buffer
+ * is moved back. pred is called once for each element, and may be called on different threads at once.
+ *
+ * @return An iterator to the first element for which pred is false.
+*/
+template <std::random_access_iterator It, class Pred>
+requires std::default_initializable<std::iter_value_t<It>> && std::movable<std::iter_value_t<It>>
+It parallel_partition(It first, It last, Pred&& pred, size_t num_threads = hardware_thread_count()) {
+  using T        = std::iter_value_t<It>;
+  const size_t n = static_cast<size_t>(last - first);
+  if (num_threads <= 1 || n < 8192)
+    return std::stable_partition(first, last, pred);
+
+  const size_t        blocks = std::min(num_threads * 4, n / 2048);
+  const size_t        block  = (n + blocks - 1) / blocks;
+  std::vector<char>   flags(n);
+  std::vector<size_t> trues(blocks + 1, 0), falses(blocks + 1, 0);
+  parallel_for(blocks, num_threads, 1, [&](size_t b_first, size_t b_last, size_t) {
+    for (size_t b = b_first; b < b_last; ++b) {
+      size_t count = 0;
+      for (size_t i = b * block; i < std::min(n, (b + 1) * block); ++i) {
+        flags[i] = static_cast<char>(pred(first[static_cast<ptrdiff_t>(i)]) ? 1 : 0);
+        count += static_cast<size_t>(flags[i]);
+      }
+      trues[b + 1]  = count;
+      falses[b + 1] = std::min(n, (b + 1) * block) - b * block - count;
+    }
+  });
+  std::inclusive_scan(trues.begin(), trues.end(), trues.begin());
+  std::inclusive_scan(falses.begin(), falses.end(), falses.begin());
+
+  const size_t   num_true = trues[blocks];
+  std::vector<T> buffer(n);
+  parallel_for(blocks, num_threads, 1, [&](size_t b_first, size_t b_last, size_t) {
+    for (size_t b = b_first; b < b_last; ++b) {
+      size_t t = trues[b], f = num_true + falses[b];
+      for (size_t i = b * block; i < std::min(n, (b + 1) * block); ++i)
+        buffer[flags[i] ? t++ : f++] = std::move(first[static_cast<ptrdiff_t>(i)]);
+    }
+  });
+  parallel_for(n, num_threads, 1 << 14, [&](size_t i_first, size_t i_last, size_t) {
+    std::move(buffer.begin() + static_cast<ptrdiff_t>(i_first), buffer.begin() + static_cast<ptrdiff_t>(i_last),
+              first + static_cast<ptrdiff_t>(i_first));
+  });
+  return first + static_cast<ptrdiff_t>(num_true);
+}
+
+/**
+ * @brief Sorts [first, last) with comp using num_threads threads.
+ *
+ * Blocks are sorted with std::sort on separate threads, then merged in pairs until one run is left, with
+ * the merges of each pass running in parallel. The sort isn't stable.
+*/
+template <std::random_access_iterator It, class Compare = std::less<>>
+requires std::default_initializable<std::iter_value_t<It>> && std::movable<std::iter_value_t<It>>
+void parallel_sort(It first, It last, Compare comp = Compare(), size_t num_threads = hardware_thread_count()) {
+  using T        = std::iter_value_t<It>;
+  const size_t n = static_cast<size_t>(last - first);
+  if (num_threads <= 1 || n < 16384) {
+    std::sort(first, last, comp);
+    return;
+  }
+
+  const size_t runs = std::min(std::bit_ceil(num_threads), n / 4096);
+  const size_t run  = (n + runs - 1) / runs;
+  parallel_for(runs, num_threads, 1, [&](size_t r_first, size_t r_last, size_t) {
+    for (size_t r = r_first; r < r_last; ++r)
+      std::sort(first + static_cast<ptrdiff_t>(std::min(n, r * run)),
+                first + static_cast<ptrdiff_t>(std::min(n, (r + 1) * run)), comp);
+  });
+
+  // Merge runs of width into runs of 2 * width, from in to out
+  std::vector<T> buffer(n);
+  auto           merge_pass = [&](auto in, auto out, size_t width) {
+    const size_t pairs = (n + 2 * width - 1) / (2 * width);
+    parallel_for(pairs, num_threads, 1, [&](size_t p_first, size_t p_last, size_t) {
+      for (size_t p = p_first; p < p_last; ++p) {
+        const auto lo  = static_cast<ptrdiff_t>(p * 2 * width);
+        const auto mid = static_cast<ptrdiff_t>(std::min(n, p * 2 * width + width));
+        const auto hi  = static_cast<ptrdiff_t>(std::min(n, (p + 1) * 2 * width));
+        std::merge(std::make_move_iterator(in + lo), std::make_move_iterator(in + mid),
+                   std::make_move_iterator(in + mid), std::make_move_iterator(in + hi), out + lo, comp);
+      }
+    });
+  };
+  bool in_buffer = false;
+  for (size_t width = run; width < n; width *= 2) {
+    if (in_buffer)
+      merge_pass(buffer.begin(), first, width);
+    else
+      merge_pass(first, buffer.begin(), width);
+    in_buffer = !in_buffer;
+  }
+  if (in_buffer) {
+    parallel_for(n, num_threads, 1 << 14, [&](size_t i_first, size_t i_last, size_t) {
+      std::move(buffer.begin() + static_cast<ptrdiff_t>(i_first), buffer.begin() + static_cast<ptrdiff_t>(i_last),
+                first + static_cast<ptrdiff_t>(i_first));
+    });
+  }
+}
+
+} // namespace graph
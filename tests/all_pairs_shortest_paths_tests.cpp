@@ -0,0 +1,199 @@
+#include <catch2/catch_test_macros.hpp>
+#include "graph/algorithm/all_pairs_shortest_paths.hpp"
+#include "graph/algorithm/dijkstra_shortest_paths.hpp"
+#include "graph/algorithm/bellman_ford_shortest_paths.hpp"
+#include "graph/container/compressed_graph.hpp"
+#include "random_graphs.hpp"
+#include <deque>
+#include <random>
+#include <vector>
+
+using std::vector;
+
+using weighted_graph = vector<vector<std::pair<int, double>>>;
+
+// Adds the potential difference p[v] - p[u] to the weight of each edge, which makes some weights negative without
+// making a negative cycle
+static weighted_graph add_potentials(weighted_graph g, const vector<int>& p) {
+  for (size_t uid = 0; uid < g.size(); ++uid)
+    for (auto& [vid, w] : g[uid])
+      w += p[static_cast<size_t>(vid)] - p[uid];
+  return g;
+}
+
+// The all-pairs distances from a single-source search from each vertex
+template <class G, class WF>
+static vector<double> expected_distances(G&& g, WF&& weight, bool negative) {
+  const size_t   n = graph::num_vertices(g);
+  vector<double> expected(n * n), d(n);
+  for (size_t uid = 0; uid < n; ++uid) {
+    graph::init_shortest_paths(d);
+    if (negative)
+      REQUIRE(!graph::bellman_ford_shortest_distances(g, static_cast<graph::vertex_id_t<G>>(uid), d, weight));
+    else
+      graph::dijkstra_shortest_distances(g, static_cast<graph::vertex_id_t<G>>(uid), d, weight);
+    std::ranges::copy(d, expected.begin() + static_cast<std::ptrdiff_t>(uid * n));
+  }
+  return expected;
+}
+
+TEST_CASE("floyd warshall shortest distances", "[apsp][shortest paths][algorithm]") {
+  auto weight = [](const std::pair<int, double>& uv) { return uv.second; };
+
+  SECTION("empty graph") {
+    weighted_graph g;
+    vector<double> d;
+    REQUIRE(graph::floyd_warshall_shortest_distances(g, d, weight));
+  }
+
+  SECTION("non-negative weights") {
+    // 150 vertices aren't a multiple of the block size, with blocks of 64, 64 and 22 rows
+    for (int n : {1, 10, 64, 150}) {
+      const weighted_graph g        = make_random_weighted_digraph(n, 4 * n, 10);
+      const vector<double> expected = expected_distances(g, weight, false);
+      for (size_t num_threads : {size_t(1), size_t(4)}) {
+        vector<double> d(static_cast<size_t>(n * n));
+        REQUIRE(graph::floyd_warshall_shortest_distances(g, d, weight, num_threads));
+        REQUIRE(d == expected);
+      }
+    }
+  }
+
+  SECTION("negative weights") {
+    const int   n = 200;
+    vector<int> p(n);
+    std::mt19937 gen(7);
+    for (auto& pv : p)
+      pv = static_cast<int>(gen() % 50);
+    const weighted_graph g        = add_potentials(make_random_weighted_digraph(n, 3 * n, 10), p);
+    const vector<double> expected = expected_distances(g, weight, true);
+    for (size_t num_threads : {size_t(1), size_t(4)}) {
+      vector<double> d(n * n);
+      REQUIRE(graph::floyd_warshall_shortest_distances(g, d, weight, num_threads));
+      REQUIRE(d == expected);
+    }
+  }
+
+  SECTION("negative cycle") {
+    weighted_graph g = make_random_weighted_digraph(100, 400, 10);
+    g[3].push_back({4, -20.0});
+    g[4].push_back({3, 5.0});
+    vector<double> d(100 * 100);
+    REQUIRE(!graph::floyd_warshall_shortest_distances(g, d, weight, 4));
+
+    weighted_graph loop(2);
+    loop[1].push_back({1, -1.0});
+    d.resize(4);
+    REQUIRE(!graph::floyd_warshall_shortest_distances(loop, d, weight));
+
+    // The integral distances around the cycle saturate rather than overflow
+    vector<vector<std::pair<int, int>>> ring(200);
+    for (int u = 0; u < 200; ++u)
+      ring[static_cast<size_t>(u)].push_back({(u + 1) % 200, -1000000});
+    auto        int_weight = [](const std::pair<int, int>& uv) { return uv.second; };
+    vector<int> di(200 * 200);
+    REQUIRE(!graph::floyd_warshall_shortest_distances(ring, di, int_weight, 4));
+  }
+
+  SECTION("unit weights and integral distances") {
+    // A path 0 -> 1 -> ... -> 99, so vertex u reaches v only when u <= v
+    vector<vector<int>> path(100);
+    for (int u = 0; u < 99; ++u)
+      path[static_cast<size_t>(u)].push_back(u + 1);
+    vector<int> d(100 * 100);
+    REQUIRE(graph::floyd_warshall_shortest_distances(path, d, graph::unit_edge_weight<int>(), 4));
+    for (size_t u = 0; u < 100; ++u)
+      for (size_t v = 0; v < 100; ++v)
+        REQUIRE(d[u * 100 + v] ==
+                (u <= v ? static_cast<int>(v - u) : graph::shortest_path_infinite_distance<int>()));
+  }
+
+  SECTION("non-contiguous distances") {
+    const weighted_graph g        = make_random_weighted_digraph(80, 320, 10);
+    const vector<double> expected = expected_distances(g, weight, false);
+    std::deque<double>   d(80 * 80);
+    REQUIRE(graph::floyd_warshall_shortest_distances(g, d, weight, 2));
+    REQUIRE(std::ranges::equal(d, expected));
+  }
+
+  SECTION("distances too small") {
+    const weighted_graph g = make_random_weighted_digraph(10, 20, 10);
+    vector<double>       d(99);
+    REQUIRE_THROWS_AS(graph::floyd_warshall_shortest_distances(g, d, weight), std::out_of_range);
+  }
+}
+
+TEST_CASE("johnson shortest distances", "[apsp][shortest paths][algorithm]") {
+  auto weight = [](const std::pair<int, double>& uv) { return uv.second; };
+
+  SECTION("empty graph") {
+    weighted_graph g;
+    vector<double> d;
+    REQUIRE(graph::johnson_shortest_distances(g, d, weight));
+  }
+
+  SECTION("non-negative weights") {
+    for (int n : {1, 10, 150}) {
+      const weighted_graph g        = make_random_weighted_digraph(n, 3 * n, 10);
+      const vector<double> expected = expected_distances(g, weight, false);
+      for (size_t num_threads : {size_t(1), size_t(4)}) {
+        vector<double> d(static_cast<size_t>(n * n));
+        REQUIRE(graph::johnson_shortest_distances(g, d, weight, num_threads));
+        REQUIRE(d == expected);
+      }
+    }
+  }
+
+  SECTION("negative weights") {
+    const int    n = 200;
+    vector<int>  p(n);
+    std::mt19937 gen(7);
+    for (auto& pv : p)
+      pv = static_cast<int>(gen() % 50);
+    const weighted_graph g        = add_potentials(make_random_weighted_digraph(n, 3 * n, 10), p);
+    const vector<double> expected = expected_distances(g, weight, true);
+    for (size_t num_threads : {size_t(1), size_t(4)}) {
+      vector<double> d(n * n);
+      REQUIRE(graph::johnson_shortest_distances(g, d, weight, num_threads));
+      REQUIRE(d == expected);
+    }
+  }
+
+  SECTION("negative cycle") {
+    weighted_graph g = make_random_weighted_digraph(100, 400, 10);
+    g[3].push_back({4, -20.0});
+    g[4].push_back({3, 5.0});
+    vector<double> d(100 * 100, 1.0);
+    REQUIRE(!graph::johnson_shortest_distances(g, d, weight, 4));
+    REQUIRE(std::ranges::count(d, 1.0) == 100 * 100);
+  }
+
+  SECTION("compressed graph agrees with floyd warshall") {
+    using G = graph::container::compressed_graph<int, void, void, uint32_t, uint32_t>;
+    vector<graph::copyable_edge_t<uint32_t, int>> edges;
+    std::mt19937                                  gen(11);
+    for (int i = 0; i < 1500; ++i)
+      edges.push_back({static_cast<uint32_t>(gen() % 300), static_cast<uint32_t>(gen() % 300),
+                       static_cast<int>(gen() % 20)});
+    std::ranges::sort(edges, {}, [](auto& e) { return std::pair{e.source_id, e.target_id}; });
+    G g;
+    g.load_edges(edges, std::identity(), 300);
+    auto value = [&g](auto&& uv) { return graph::edge_value(g, uv); };
+
+    vector<int> fw(300 * 300), jn(300 * 300);
+    REQUIRE(graph::floyd_warshall_shortest_distances(g, fw, value, 4));
+    REQUIRE(graph::johnson_shortest_distances(g, jn, value, 4));
+    REQUIRE(fw == jn);
+
+    vector<int> hops(300 * 300);
+    REQUIRE(graph::johnson_shortest_distances(g, hops, graph::unit_edge_weight<int>(), 2));
+    REQUIRE(graph::floyd_warshall_shortest_distances(g, fw, graph::unit_edge_weight<int>(), 2));
+    REQUIRE(fw == hops);
+  }
+
+  SECTION("distances too small") {
+    const weighted_graph g = make_random_weighted_digraph(10, 20, 10);
+    vector<double>       d(99);
+    REQUIRE_THROWS_AS(graph::johnson_shortest_distances(g, d, weight), std::out_of_range);
+  }
+}
@@ -733,3 +733,29 @@ TEST_CASE("Bellman-Ford compiles with a visitor", "[shortest][distances][bellman
 
   (void)graph::bellman_ford_shortest_paths(g, 0, distances, predecessor, one, Visitor{});
 }
+
+TEST_CASE("Bellman-Ford's Unit Weight Shortest Segments", "[csv][vofl][shortest][segments][bellman][unit]") {
+  init_console();
+  using G                     = routes_volf_graph_type;
+  auto&&         g            = load_graph<G>(TEST_DATA_ROOT_DIR "germany_routes.csv");
+  vertex_id_t<G> frankfurt_id = find_frankfurt_id(g);
+
+  // The default weight function uses a breadth-first search; the type-erased function relaxes all edges
+  vector<double>         distance(size(vertices(g)));
+  vector<vertex_id_t<G>> predecessors(size(vertices(g)));
+  init_shortest_paths(distance, predecessors);
+  optional<vertex_id_t<G>> cycle_vertex_id = bellman_ford_shortest_paths(g, frankfurt_id, distance, predecessors);
+  REQUIRE(!cycle_vertex_id.has_value());
+
+  vector<double>                        expected(size(vertices(g)));
+  function<double(edge_reference_t<G>)> one = [](edge_reference_t<G>) { return 1.0; };
+  init_shortest_paths(expected);
+  cycle_vertex_id = bellman_ford_shortest_distances(g, frankfurt_id, expected, one);
+  REQUIRE(!cycle_vertex_id.has_value());
+
+  REQUIRE(expected == distance);
+  for (auto&& [uid, u] : vertexlist(g)) {
+    if (uid != frankfurt_id)
+      REQUIRE(distance[predecessors[uid]] + 1 == distance[uid]);
+  }
+}
@@ -0,0 +1,146 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+#include "graph/algorithm/betweenness_centrality.hpp"
+#include "graph/container/compressed_graph.hpp"
+#include "random_graphs.hpp"
+#include <limits>
+#include <random>
+#include <vector>
+
+using std::vector;
+
+using graph::vertices;
+using graph::edges;
+using graph::target_id;
+
+// Betweenness from the definition: all-pairs distances and path counts from a simple O(V^2) Dijkstra per source
+static vector<double> reference_betweenness(const vector<vector<std::pair<int, double>>>& g) {
+  const size_t           n   = g.size();
+  const double           inf = std::numeric_limits<double>::max();
+  vector<vector<double>> dist(n, vector<double>(n, inf)), sigma(n, vector<double>(n, 0));
+  for (size_t s = 0; s < n; ++s) {
+    vector<char> done(n, false);
+    dist[s][s]  = 0;
+    sigma[s][s] = 1;
+    for (;;) {
+      size_t u = n;
+      for (size_t v = 0; v < n; ++v)
+        if (!done[v] && dist[s][v] < inf && (u == n || dist[s][v] < dist[s][u]))
+          u = v;
+      if (u == n)
+        break;
+      done[u] = true;
+      for (auto [v, w] : g[u]) {
+        const size_t t = static_cast<size_t>(v);
+        if (dist[s][u] + w < dist[s][t]) {
+          dist[s][t]  = dist[s][u] + w;
+          sigma[s][t] = sigma[s][u];
+        } else if (dist[s][u] + w == dist[s][t]) {
+          sigma[s][t] += sigma[s][u];
+        }
+      }
+    }
+  }
+  vector<double> bc(n, 0);
+  for (size_t s = 0; s < n; ++s)
+    for (size_t t = 0; t < n; ++t)
+      for (size_t v = 0; v < n; ++v)
+        if (s != v && v != t && s != t && dist[s][t] < inf && dist[s][v] < inf && dist[v][t] < inf &&
+            dist[s][v] + dist[v][t] == dist[s][t])
+          bc[v] += sigma[s][v] * sigma[v][t] / sigma[s][t];
+  return bc;
+}
+
+TEST_CASE("betweenness centrality", "[betweenness][centrality][algorithm]") {
+  auto weight = [](const std::pair<int, double>& uv) { return uv.second; };
+
+  SECTION("path") {
+    // 0 - 1 - 2 - 3 - 4, with each edge in both directions
+    vector<vector<std::pair<int, double>>> g = {
+          {{1, 1}}, {{0, 1}, {2, 1}}, {{1, 1}, {3, 1}}, {{2, 1}, {4, 1}}, {{3, 1}}};
+    vector<double> bc(g.size());
+    graph::betweenness_centrality(g, bc);
+    REQUIRE(bc == vector<double>{0, 6, 8, 6, 0});
+    graph::betweenness_centrality(g, bc, weight, 2);
+    REQUIRE(bc == vector<double>{0, 6, 8, 6, 0});
+  }
+
+  SECTION("unit weights") {
+    auto g = make_random_weighted_digraph(80, 320, 1);
+    auto expected = reference_betweenness(g);
+    for (size_t num_threads : {size_t(1), size_t(4)}) {
+      vector<double> bc(g.size());
+      graph::betweenness_centrality(g, bc, graph::unit_edge_weight<double>(), num_threads);
+      for (size_t uid = 0; uid < g.size(); ++uid)
+        REQUIRE(bc[uid] == Catch::Approx(expected[uid]).margin(1e-9));
+    }
+  }
+
+  SECTION("weighted") {
+    // Small integer weights give many paths of equal length
+    auto g        = make_random_weighted_digraph(80, 320, 3, 7);
+    auto expected = reference_betweenness(g);
+    for (size_t num_threads : {size_t(1), size_t(3)}) {
+      vector<float> bc(g.size());
+      graph::betweenness_centrality(g, bc, weight, num_threads);
+      for (size_t uid = 0; uid < g.size(); ++uid)
+        REQUIRE(bc[uid] == Catch::Approx(expected[uid]).epsilon(1e-5).margin(1e-4));
+    }
+  }
+
+  SECTION("compressed_graph") {
+    using G  = graph::container::compressed_graph<double, void, void, int, int>;
+    auto adj = make_random_weighted_digraph(60, 240, 4, 11);
+    vector<graph::copyable_edge_t<int, double>> edge_list;
+    for (int uid = 0; uid < static_cast<int>(adj.size()); ++uid)
+      for (auto [vid, w] : adj[static_cast<size_t>(uid)])
+        edge_list.push_back({uid, vid, w});
+    G g;
+    g.load_edges(edge_list, std::identity(), adj.size(), edge_list.size());
+
+    auto           expected = reference_betweenness(adj);
+    vector<double> bc(adj.size());
+    graph::betweenness_centrality(g, bc, [&g](auto&& uv) { return graph::edge_value(g, uv); }, 2);
+    for (size_t uid = 0; uid < adj.size(); ++uid)
+      REQUIRE(bc[uid] == Catch::Approx(expected[uid]).margin(1e-9));
+  }
+
+  SECTION("sampling") {
+    const int      n        = 150;
+    auto           g        = make_random_weighted_digraph(n, 600, 2, 5);
+    auto           expected = reference_betweenness(g);
+    const double   epsilon  = 0.05;
+    const size_t   samples  = graph::betweenness_sample_count(g.size(), epsilon, 0.1);
+    vector<double> bc(g.size()), bc4(g.size());
+    graph::approximate_betweenness_centrality(g, bc, samples, weight, 17, 1);
+    graph::approximate_betweenness_centrality(g, bc4, samples, weight, 17, 4);
+    const double bound = epsilon * n * (n - 2);
+    for (size_t uid = 0; uid < g.size(); ++uid) {
+      REQUIRE(std::abs(bc[uid] - expected[uid]) <= bound);
+      REQUIRE(bc4[uid] == Catch::Approx(bc[uid]).margin(1e-6));
+    }
+
+    // All sources sampled many times approach the exact values
+    graph::approximate_betweenness_centrality(g, bc, 20 * g.size(), weight, 3);
+    double error = 0, total = 0;
+    for (size_t uid = 0; uid < g.size(); ++uid) {
+      error += std::abs(bc[uid] - expected[uid]);
+      total += expected[uid];
+    }
+    REQUIRE(error < 0.1 * total);
+  }
+
+  SECTION("errors") {
+    vector<vector<std::pair<int, double>>> g = {{{1, 1}}, {{0, -1}}};
+    vector<double>                         bc(2), small(1);
+    REQUIRE_THROWS_AS(graph::betweenness_centrality(g, small), std::out_of_range);
+    REQUIRE_THROWS_AS(graph::betweenness_centrality(g, bc, weight), std::out_of_range);
+    REQUIRE_THROWS_AS(graph::betweenness_sample_count(10, 0, 0.1), std::out_of_range);
+
+    vector<vector<std::pair<int, double>>> empty;
+    vector<double>                         none;
+    graph::betweenness_centrality(empty, none);
+    graph::approximate_betweenness_centrality(empty, none, 10);
+  }
+}
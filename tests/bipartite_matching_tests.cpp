@@ -0,0 +1,187 @@
+#include <catch2/catch_test_macros.hpp>
+#include "graph/algorithm/bipartite_matching.hpp"
+#include "graph/container/compressed_graph.hpp"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <tuple>
+#include <vector>
+
+using std::vector;
+
+using G         = graph::container::compressed_graph<void, void, void, uint32_t, uint32_t>;
+using edge_list = vector<graph::copyable_edge_t<uint32_t, void>>;
+
+constexpr auto unmatched = std::numeric_limits<uint32_t>::max();
+
+// Sizes of a random bipartite graph: the number of left and right vertices and the number of edges
+using bipartite_size = std::tuple<uint32_t, uint32_t, size_t>;
+
+// Left vertices [0, nl) and right vertices [nl, nl + nr), with m random edges from left to right
+static edge_list make_random_bipartite(uint32_t nl, uint32_t nr, size_t m, unsigned seed = 42) {
+  edge_list    edges;
+  std::mt19937 gen(seed);
+  for (size_t i = 0; i < m; ++i)
+    edges.push_back({static_cast<uint32_t>(gen() % nl), nl + static_cast<uint32_t>(gen() % nr)});
+  return edges;
+}
+
+// The graph has vertices up to the largest id in the edges, so a right vertex without edges may be left out
+static G make_graph(edge_list edges, uint32_t nl) {
+  std::ranges::sort(edges, {}, [](auto& e) { return std::pair{e.source_id, e.target_id}; });
+  return G(edges, std::identity(), vector<uint32_t>{0, nl});
+}
+
+// Maximum matching size with Kuhn's augmenting path algorithm, from the left vertices [0, nl)
+static size_t expected_matching(const G& g, uint32_t nl) {
+  vector<uint32_t> mate_of(graph::num_vertices(g), unmatched);
+  vector<char>     visited;
+  auto             augment = [&](auto&& self, uint32_t uid) -> bool {
+    for (auto&& uv : graph::edges(g, uid)) {
+      const uint32_t vid = graph::target_id(g, uv);
+      if (vid < nl || visited[vid])
+        continue;
+      visited[vid] = true;
+      if (mate_of[vid] == unmatched || self(self, mate_of[vid])) {
+        mate_of[vid] = uid;
+        return true;
+      }
+    }
+    return false;
+  };
+  size_t matched = 0;
+  for (uint32_t uid = 0; uid < nl; ++uid) {
+    visited.assign(graph::num_vertices(g), false);
+    matched += augment(augment, uid);
+  }
+  return matched;
+}
+
+// Checks that each matched pair is an edge between the two sides and that mate is symmetric
+static void check_matching(const G& g, const vector<uint32_t>& mate, uint32_t nl, size_t num_matched) {
+  size_t matched = 0;
+  for (uint32_t uid = 0; uid < graph::num_vertices(g); ++uid) {
+    if (mate[uid] == unmatched)
+      continue;
+    const uint32_t vid = mate[uid];
+    REQUIRE(mate[vid] == uid);
+    REQUIRE((uid < nl) != (vid < nl));
+    if (uid < nl) {
+      ++matched;
+      REQUIRE(std::ranges::any_of(graph::edges(g, uid), [&](auto&& uv) { return graph::target_id(g, uv) == vid; }));
+    }
+  }
+  REQUIRE(matched == num_matched);
+}
+
+TEST_CASE("hopcroft karp matching", "[matching][algorithm]") {
+  SECTION("random bipartite graphs") {
+    for (auto [nl, nr, m] :
+         {bipartite_size{30, 20, 40}, bipartite_size{300, 250, 600}, bipartite_size{2000, 3000, 5000}}) {
+      const G          g = make_graph(make_random_bipartite(nl, nr, m), nl);
+      vector<uint32_t> mate(graph::num_vertices(g));
+      const size_t     num_matched = graph::hopcroft_karp_matching(g, mate);
+      check_matching(g, mate, nl, num_matched);
+      REQUIRE(num_matched == expected_matching(g, nl));
+    }
+  }
+
+  SECTION("long augmenting paths") {
+    // Left i has edges to right i + 1 and i, so the greedy pass matches each left vertex with the wrong right vertex
+    // and the last one is only matched by an augmenting path through all of them
+    const uint32_t n = 5000;
+    edge_list      edges;
+    for (uint32_t i = 0; i < n; ++i) {
+      if (i + 1 < n)
+        edges.push_back({i, n + i + 1});
+      edges.push_back({i, n + i});
+    }
+    G g(edges, std::identity(), vector<uint32_t>{0, n});
+    vector<uint32_t> mate(2 * n);
+    REQUIRE(graph::hopcroft_karp_matching(g, mate) == n);
+    check_matching(g, mate, n, n);
+  }
+
+  SECTION("edges in both directions and the left side in partition 1") {
+    // Vertices [0, 40) are the right side in partition 0, and [40, 100) the left side in partition 1
+    edge_list    edges;
+    std::mt19937 gen(3);
+    for (int i = 0; i < 150; ++i) {
+      const uint32_t uid = 40 + static_cast<uint32_t>(gen() % 60), vid = static_cast<uint32_t>(gen() % 40);
+      edges.push_back({uid, vid});
+      edges.push_back({vid, uid});
+    }
+    edges.push_back({41, 42}); // within the left side, so ignored
+    std::ranges::sort(edges, {}, [](auto& e) { return std::pair{e.source_id, e.target_id}; });
+    G                g(edges, std::identity(), vector<uint32_t>{0, 40});
+    vector<uint32_t> mate(100);
+    const size_t     num_matched = graph::hopcroft_karp_matching(g, mate, 1u);
+    REQUIRE(num_matched == graph::push_relabel_matching(g, mate, 1u, 4));
+    for (uint32_t uid = 40; uid < 100; ++uid)
+      if (mate[uid] != unmatched)
+        REQUIRE(mate[uid] < 40);
+  }
+
+  SECTION("errors") {
+    const G          g = make_graph(make_random_bipartite(10, 10, 20), 10);
+    vector<uint32_t> mate(graph::num_vertices(g) - 1);
+    REQUIRE_THROWS_AS(graph::hopcroft_karp_matching(g, mate), std::out_of_range);
+    mate.resize(graph::num_vertices(g));
+    REQUIRE_THROWS_AS(graph::hopcroft_karp_matching(g, mate, 2u), std::out_of_range);
+    REQUIRE_THROWS_AS(graph::push_relabel_matching(g, mate, 2u), std::out_of_range);
+  }
+}
+
+TEST_CASE("push relabel matching", "[matching][algorithm]") {
+  SECTION("random bipartite graphs") {
+    // Sparse graphs leave many vertices unmatched, and denser ones are close to a perfect matching
+    for (auto [nl, nr, m] :
+         {bipartite_size{30, 20, 40}, bipartite_size{3000, 2500, 4000}, bipartite_size{5000, 5000, 20000}}) {
+      const G      g        = make_graph(make_random_bipartite(nl, nr, m), nl);
+      const size_t expected = expected_matching(g, nl);
+      for (size_t num_threads : {size_t(1), size_t(2), size_t(4)}) {
+        vector<int64_t>  mate(graph::num_vertices(g));
+        const size_t     num_matched = graph::push_relabel_matching(g, mate, 0u, num_threads);
+        vector<uint32_t> mate32(mate.size());
+        std::ranges::transform(mate, mate32.begin(), [](int64_t v) {
+          return v == std::numeric_limits<int64_t>::max() ? unmatched : static_cast<uint32_t>(v);
+        });
+        check_matching(g, mate32, nl, num_matched);
+        REQUIRE(num_matched == expected);
+      }
+    }
+  }
+
+  SECTION("planted perfect matching") {
+    const uint32_t   n     = 8000;
+    edge_list        edges = make_random_bipartite(n, n, 3 * n, 9);
+    vector<uint32_t> perm(n);
+    std::iota(perm.begin(), perm.end(), 0u);
+    std::ranges::shuffle(perm, std::mt19937(5));
+    for (uint32_t i = 0; i < n; ++i)
+      edges.push_back({i, n + perm[i]});
+    const G g = make_graph(edges, n);
+    for (size_t num_threads : {size_t(1), size_t(4)}) {
+      vector<uint32_t> mate(2 * n);
+      REQUIRE(graph::push_relabel_matching(g, mate, 0u, num_threads) == n);
+      check_matching(g, mate, n, n);
+    }
+  }
+
+  SECTION("long augmenting paths") {
+    const uint32_t n = 5000;
+    edge_list      edges;
+    for (uint32_t i = 0; i < n; ++i) {
+      if (i + 1 < n)
+        edges.push_back({i, n + i + 1});
+      edges.push_back({i, n + i});
+    }
+    G g(edges, std::identity(), vector<uint32_t>{0, n});
+    for (size_t num_threads : {size_t(1), size_t(4)}) {
+      vector<uint32_t> mate(2 * n);
+      REQUIRE(graph::push_relabel_matching(g, mate, 0u, num_threads) == n);
+      check_matching(g, mate, n, n);
+    }
+  }
+}
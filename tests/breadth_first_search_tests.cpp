@@ -1,10 +1,13 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_template_test_macros.hpp>
+#include "csv_routes.hpp"
 #include "graph/algorithm/breadth_first_search.hpp"
+#include "graph/algorithm/dijkstra_shortest_paths.hpp"
 #include "graph/container/dynamic_graph.hpp"
+#include "graph/container/compressed_graph.hpp"
+#include "random_graphs.hpp"
 #include <iostream>
-
-#define GRAPH_BFS_ALGORITHM_HPP
+#include <random>
 
 #define TEST_OPTION_OUTPUT (1)
 #define TEST_OPTION_GEN (2)
@@ -13,36 +16,248 @@
 
 using std::cout;
 using std::endl;
+using std::vector;
 
 using std::ranges::forward_range;
 using std::forward_iterator;
 
 using namespace graph;
 
-void init_console(); // init cout for UTF-8
+using routes_volf_graph_traits = graph::container::vofl_graph_traits<double, std::string>;
+using routes_volf_graph_type   = graph::container::dynamic_adjacency_graph<routes_volf_graph_traits>;
+
+// Each vertex reached, other than a source, must have a predecessor one level closer with an edge to it
+template <class G>
+static void check_predecessors(const G& g, const vector<int>& distances, const vector<int>& predecessors) {
+  for (size_t vid = 0; vid < distances.size(); ++vid) {
+    if (distances[vid] == 0 || distances[vid] == shortest_path_infinite_distance<int>())
+      continue;
+    const int uid = predecessors[vid];
+    REQUIRE(distances[static_cast<size_t>(uid)] + 1 == distances[vid]);
+    REQUIRE(std::ranges::find(g[static_cast<size_t>(uid)], static_cast<int>(vid)) != g[static_cast<size_t>(uid)].end());
+  }
+}
 
 TEST_CASE("breadth_first_search algorithm test", "[bfs][single-source][algorithm]") {
   init_console();
+  using G                     = routes_volf_graph_type;
+  auto&&         g            = load_graph<G>(TEST_DATA_ROOT_DIR "germany_routes.csv");
+  vertex_id_t<G> frankfurt_id = find_city_id(g, "Frankf\xC3\xBCrt");
 
-  // Create graph instance
+  vector<int>            distances(size(vertices(g)));
+  vector<vertex_id_t<G>> predecessors(size(vertices(g)));
+  init_shortest_paths(distances, predecessors);
+  breadth_first_search(g, frankfurt_id, distances, predecessors);
 
-  SECTION("verify graph") {
-    // verify graph
-    REQUIRE(1 + 1 == 2);
-  }
+  vector<int> expected(size(vertices(g)));
+  init_shortest_paths(expected);
+  dijkstra_shortest_distances(g, frankfurt_id, expected);
 
 #if TEST_OPTION == TEST_OPTION_OUTPUT
   SECTION("bfs algo output") {
-    // output graph
-    cout << "graph" << endl;
-  }
-#elif TEST_OPTION == TEST_OPTION_GEN
-  SECTION("bfs algo test generation") {
-    // generate test code
+    for (auto&& [uid, u] : views::vertexlist(g))
+      cout << '[' << uid << "] " << vertex_value(g, u) << ", segments=" << distances[uid] << endl;
   }
 #elif TEST_OPTION == TEST_OPTION_TEST
   SECTION("bfs algo test") {
-    // production test code
+    REQUIRE(expected == distances);
+    REQUIRE(0 == distances[frankfurt_id]);
+    for (auto&& [uid, u] : views::vertexlist(g)) {
+      if (uid != frankfurt_id)
+        REQUIRE(distances[predecessors[uid]] + 1 == distances[uid]);
+    }
   }
 #endif // TEST_OPTION
 } // TEST_CASE"breadth_first_search algorithm test"
+
+TEST_CASE("direction-optimizing breadth_first_search test", "[bfs][direction-optimizing][algorithm]") {
+  init_console();
+  const int n = 2000;
+
+  SECTION("undirected graph is its own transpose") {
+    auto g = make_random_graph(n, 8 * n, true);
+
+    vector<int> expected(g.size()), expected_pred(g.size());
+    init_shortest_paths(expected, expected_pred);
+    breadth_first_search(g, 0, expected, expected_pred);
+    check_predecessors(g, expected, expected_pred);
+
+    for (size_t alpha : {size_t(1), size_t(15), size_t(1000)}) {
+      vector<int> distances(g.size()), predecessors(g.size());
+      init_shortest_paths(distances, predecessors);
+      breadth_first_search(g, g, 0, distances, predecessors, alpha);
+      REQUIRE(expected == distances);
+      check_predecessors(g, distances, predecessors);
+    }
+
+    // A switching factor of 0 is taken as 1
+    vector<int> distances(g.size()), predecessors(g.size());
+    init_shortest_paths(distances, predecessors);
+    breadth_first_search(g, g, 0, distances, predecessors, 0, 0);
+    REQUIRE(expected == distances);
+  }
+
+  SECTION("directed graph with transpose") {
+    auto g   = make_random_graph(n, 6 * n, false);
+    auto g_t = make_transpose(g);
+
+    vector<int> sources = {0, 17, 17, 1999};
+    vector<int> expected(g.size()), expected_pred(g.size());
+    init_shortest_paths(expected, expected_pred);
+    dijkstra_shortest_paths(g, sources, expected, expected_pred);
+
+    vector<int> distances(g.size()), predecessors(g.size());
+    init_shortest_paths(distances, predecessors);
+    breadth_first_search(g, g_t, sources, distances, predecessors, 2, 18);
+    REQUIRE(expected == distances);
+    check_predecessors(g, distances, predecessors);
+  }
+
+  SECTION("out of range source") {
+    auto        g = make_random_graph(10, 20, true);
+    vector<int> distances(g.size()), predecessors(g.size());
+    init_shortest_paths(distances, predecessors);
+    REQUIRE_THROWS_AS(breadth_first_search(g, g, 10, distances, predecessors), std::out_of_range);
+  }
+}
+
+TEST_CASE("parallel_breadth_first_search test", "[bfs][parallel][algorithm]") {
+  init_console();
+  const int n = 3000;
+
+  SECTION("directed graph, multiple sources") {
+    auto        g       = make_random_graph(n, 6 * n, false);
+    vector<int> sources = {0, 5, 5, 2999};
+
+    vector<int> expected(g.size()), expected_pred(g.size());
+    init_shortest_paths(expected, expected_pred);
+    breadth_first_search(g, sources, expected, expected_pred);
+
+    for (size_t num_threads : {size_t(1), size_t(2), size_t(4), size_t(7)}) {
+      vector<int> distances(g.size()), predecessors(g.size());
+      init_shortest_paths(distances, predecessors);
+      parallel_breadth_first_search(g, sources, distances, predecessors, num_threads);
+      REQUIRE(expected == distances);
+      check_predecessors(g, distances, predecessors);
+    }
+  }
+
+  SECTION("compressed_graph with high-degree vertices") {
+    // A few hub vertices so the edges of a vertex are split across chunks
+    auto g = make_random_graph(n, 4 * n, true);
+    for (int hub : {1, 2, 3})
+      for (int vid = 0; vid < n; vid += 2)
+        g[static_cast<size_t>(hub)].push_back(vid);
+
+    using edge_type = copyable_edge_t<int, void>;
+    vector<edge_type> edge_list;
+    for (size_t uid = 0; uid < g.size(); ++uid)
+      for (int vid : g[uid])
+        edge_list.push_back(edge_type{static_cast<int>(uid), vid});
+    using CG = graph::container::compressed_graph<void, void, void, int, int>;
+    CG cg;
+    cg.load_edges(edge_list, std::identity(), g.size(), edge_list.size());
+    REQUIRE(num_vertices(cg) == g.size());
+
+    vector<int> expected(g.size()), expected_pred(g.size());
+    init_shortest_paths(expected, expected_pred);
+    breadth_first_search(g, 0, expected, expected_pred);
+
+    for (size_t num_threads : {size_t(1), size_t(3), size_t(8)}) {
+      vector<int> distances(g.size()), predecessors(g.size());
+      init_shortest_paths(distances, predecessors);
+      parallel_breadth_first_search(cg, 0, distances, predecessors, num_threads);
+      REQUIRE(expected == distances);
+      check_predecessors(g, distances, predecessors);
+    }
+  }
+
+  SECTION("forward edge ranges") {
+    using G                     = routes_volf_graph_type;
+    auto&&         g            = load_graph<G>(TEST_DATA_ROOT_DIR "germany_routes.csv");
+    vertex_id_t<G> frankfurt_id = find_city_id(g, "Frankf\xC3\xBCrt");
+
+    vector<int>            expected(size(vertices(g))), distances(size(vertices(g)));
+    vector<vertex_id_t<G>> predecessors(size(vertices(g)));
+    init_shortest_paths(expected);
+    init_shortest_paths(distances, predecessors);
+    breadth_first_search(g, frankfurt_id, expected, _null_predecessors);
+    parallel_breadth_first_search(g, frankfurt_id, distances, predecessors, 3);
+    REQUIRE(expected == distances);
+    for (auto&& [uid, u] : views::vertexlist(g)) {
+      if (uid != frankfurt_id)
+        REQUIRE(distances[predecessors[uid]] + 1 == distances[uid]);
+    }
+  }
+
+  SECTION("distances only") {
+    auto        g = make_random_graph(n, 3 * n, true);
+    vector<int> expected(g.size()), distances(g.size());
+    init_shortest_paths(expected);
+    init_shortest_paths(distances);
+    breadth_first_search(g, 0, expected, _null_predecessors);
+    parallel_breadth_first_search(g, 0, distances, _null_predecessors, 4);
+    REQUIRE(expected == distances);
+  }
+
+  SECTION("out of range source") {
+    auto        g = make_random_graph(10, 20, true);
+    vector<int> distances(g.size()), predecessors(g.size());
+    init_shortest_paths(distances, predecessors);
+    REQUIRE_THROWS_AS(parallel_breadth_first_search(g, 10, distances, predecessors, 2), std::out_of_range);
+  }
+}
+
+TEST_CASE("batched breadth-first search test", "[bfs][batched][algorithm]") {
+  init_console();
+  const int n = 1500;
+  auto      g = make_random_graph(n, 3 * n, false);
+
+  // More than one batch, with a duplicate in the same batch and across batches
+  vector<int> sources;
+  for (int i = 0; i < 150; ++i)
+    sources.push_back((i * 37) % n);
+  sources[10]  = sources[3];
+  sources[140] = sources[3];
+
+  vector<vector<int>> expected(sources.size(), vector<int>(g.size()));
+  for (size_t i = 0; i < sources.size(); ++i) {
+    init_shortest_paths(expected[i]);
+    breadth_first_search(g, sources[i], expected[i], _null_predecessors);
+  }
+
+  SECTION("distances, 64 per batch") {
+    vector<vector<int>> distances(sources.size(), vector<int>(g.size()));
+    for (auto& d : distances)
+      init_shortest_paths(d);
+    batched_breadth_first_distances(g, sources, distances);
+    REQUIRE(expected == distances);
+  }
+
+  SECTION("distances, 256 per batch") {
+    vector<vector<int>> distances(sources.size(), vector<int>(g.size()));
+    for (auto& d : distances)
+      init_shortest_paths(d);
+    batched_breadth_first_distances<256>(g, sources, distances);
+    REQUIRE(expected == distances);
+  }
+
+  SECTION("k-hop reach counts") {
+    for (size_t max_hops : {size_t(0), size_t(2), size_t(5), std::numeric_limits<size_t>::max()}) {
+      vector<size_t> counts(sources.size());
+      batched_breadth_first_reach_counts<128>(g, sources, counts, max_hops);
+      for (size_t i = 0; i < sources.size(); ++i) {
+        size_t count = 0;
+        for (int d : expected[i])
+          if (d != shortest_path_infinite_distance<int>() && static_cast<size_t>(d) <= max_hops)
+            ++count;
+        REQUIRE(count == counts[i]);
+      }
+    }
+  }
+
+  SECTION("out of range source") {
+    vector<size_t> counts(2);
+    REQUIRE_THROWS_AS(batched_breadth_first_reach_counts(g, vector<int>{0, n}, counts), std::out_of_range);
+  }
+}
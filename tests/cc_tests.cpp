@@ -4,7 +4,11 @@
 #include "graph/graph.hpp"
 #include "graph/algorithm/connected_components.hpp"
 #include "graph/container/dynamic_graph.hpp"
+#include "graph/container/compressed_graph.hpp"
 #include "graph/views/incidence.hpp"
+#include "random_graphs.hpp"
+#include <random>
+#include <unordered_set>
 #ifdef _MSC_VER
 #  include "Windows.h"
 #endif
@@ -156,3 +160,241 @@ TEST_CASE("connected components test", "[cc]") {
   graph::connected_components(g, component);
   REQUIRE(*std::ranges::max_element(component) == 2);
 }
+
+// Two component assignments describe the same partition of the vertices
+template <class C1, class C2>
+static bool same_components(const C1& c1, const C2& c2) {
+  std::unordered_map<size_t, size_t> to2, to1;
+  for (size_t i = 0; i < c1.size(); ++i) {
+    auto [it2, new2] = to2.emplace(static_cast<size_t>(c1[i]), static_cast<size_t>(c2[i]));
+    auto [it1, new1] = to1.emplace(static_cast<size_t>(c2[i]), static_cast<size_t>(c1[i]));
+    if (it2->second != static_cast<size_t>(c2[i]) || it1->second != static_cast<size_t>(c1[i]))
+      return false;
+  }
+  return true;
+}
+
+TEST_CASE("parallel afforest test", "[afforest cc][parallel]") {
+  init_console();
+
+  SECTION("routes") {
+    using G  = routes_vol_graph_type;
+    auto&& g = load_ordered_graph<G>(TEST_DATA_ROOT_DIR "cc_undirected.csv", name_order_policy::alphabetical);
+
+    std::vector<vertex_id_t<G>> component(size(vertices(g)));
+    graph::parallel_afforest(g, component, 2, 3);
+    std::unordered_set<vertex_id_t<G>> componentIds(component.begin(), component.end());
+    REQUIRE(componentIds.size() == 3);
+  }
+
+  SECTION("random graphs") {
+    for (int m : {2000, 9000, 40000}) {
+      auto             g = make_random_graph(20000, m, true);
+      std::vector<int> expected(g.size());
+      graph::connected_components(g, expected);
+
+      for (size_t num_threads : {size_t(1), size_t(2), size_t(8)}) {
+        std::vector<int> component(g.size());
+        graph::parallel_afforest(g, component, 2, num_threads);
+        REQUIRE(same_components(expected, component));
+        for (size_t uid = 0; uid < g.size(); ++uid)
+          REQUIRE(component[uid] <= static_cast<int>(uid)); // the smallest vertex id is the component id
+      }
+    }
+  }
+
+  SECTION("weakly connected with transpose") {
+    std::vector<std::vector<int>> g(6), g_t(6);
+    for (auto [u, v] : {std::pair{0, 1}, std::pair{2, 1}, std::pair{3, 2}, std::pair{5, 4}}) {
+      g[static_cast<size_t>(u)].push_back(v);
+      g_t[static_cast<size_t>(v)].push_back(u);
+    }
+    std::vector<int> component(g.size());
+    graph::parallel_afforest(g, g_t, component, 1, 2);
+    REQUIRE(component == std::vector<int>{0, 0, 0, 0, 4, 4});
+  }
+}
+
+TEST_CASE("shiloach_vishkin and label propagation test", "[cc][parallel]") {
+  init_console();
+
+  SECTION("routes") {
+    using G  = routes_vol_graph_type;
+    auto&& g = load_ordered_graph<G>(TEST_DATA_ROOT_DIR "cc_undirected.csv", name_order_policy::alphabetical);
+
+    std::vector<vertex_id_t<G>> expected(size(vertices(g))), component(size(vertices(g)));
+    graph::connected_components(g, expected);
+
+    graph::shiloach_vishkin(g, component, 2);
+    REQUIRE(same_components(expected, component));
+    graph::label_propagation_components(g, component, 2);
+    REQUIRE(same_components(expected, component));
+  }
+
+  SECTION("random graphs") {
+    for (int m : {2000, 9000, 40000}) {
+      auto             g = make_random_graph(20000, m, true);
+      std::vector<int> expected(g.size());
+      graph::connected_components(g, expected);
+
+      for (size_t num_threads : {size_t(1), size_t(2), size_t(8)}) {
+        std::vector<int> component(g.size());
+        graph::shiloach_vishkin(g, component, num_threads);
+        REQUIRE(same_components(expected, component));
+        for (size_t uid = 0; uid < g.size(); ++uid)
+          REQUIRE(component[uid] <= static_cast<int>(uid));
+
+        std::ranges::fill(component, -1);
+        graph::label_propagation_components(g, component, num_threads);
+        REQUIRE(same_components(expected, component));
+        for (size_t uid = 0; uid < g.size(); ++uid)
+          REQUIRE(component[uid] <= static_cast<int>(uid));
+      }
+    }
+  }
+
+  SECTION("compressed_graph path") {
+    // A long path, the worst case for label propagation and the reason for shiloach_vishkin
+    const int                                      n = 5000;
+    std::vector<graph::copyable_edge_t<int, void>> edge_list;
+    for (int uid = 0; uid < n - 1; ++uid) {
+      edge_list.push_back({uid, uid + 1});
+      edge_list.push_back({uid + 1, uid});
+    }
+    std::ranges::sort(edge_list, [](auto& a, auto& b) { return a.source_id < b.source_id; });
+    graph::container::compressed_graph<void, void, void, int, int> g;
+    g.load_edges(edge_list);
+
+    std::vector<int> component(static_cast<size_t>(n));
+    graph::shiloach_vishkin(g, component, 4);
+    REQUIRE(std::ranges::all_of(component, [](int c) { return c == 0; }));
+    graph::label_propagation_components(g, component, 4);
+    REQUIRE(std::ranges::all_of(component, [](int c) { return c == 0; }));
+  }
+
+  SECTION("weakly connected") {
+    std::vector<std::vector<int>> g(6);
+    for (auto [u, v] : {std::pair{0, 1}, std::pair{2, 1}, std::pair{3, 2}, std::pair{5, 4}})
+      g[static_cast<size_t>(u)].push_back(v);
+    std::vector<int> component(g.size());
+    graph::shiloach_vishkin(g, component, 2);
+    REQUIRE(component == std::vector<int>{0, 0, 0, 0, 4, 4});
+  }
+}
+
+TEST_CASE("auto connected components test", "[cc][parallel]") {
+  init_console();
+  using graph::cc_algorithm;
+
+  auto path = make_random_graph(4000, 0, true);
+  for (size_t uid = 0; uid + 1 < path.size(); ++uid) {
+    path[uid].push_back(static_cast<int>(uid + 1));
+    path[uid + 1].push_back(static_cast<int>(uid));
+  }
+  auto random = make_random_graph(4000, 16000, true);
+  auto star   = make_random_graph(4000, 4000, true);
+  for (int vid = 1; vid < 4000; ++vid) {
+    star[0].push_back(vid);
+    star[static_cast<size_t>(vid)].push_back(0);
+  }
+
+  REQUIRE(graph::select_connected_components(random, 1) == cc_algorithm::depth_first);
+  REQUIRE(graph::select_connected_components(path, 4) == cc_algorithm::shiloach_vishkin);
+  REQUIRE(graph::select_connected_components(random, 4) == cc_algorithm::label_propagation);
+  REQUIRE(graph::select_connected_components(star, 4) == cc_algorithm::afforest);
+
+  for (auto* g : {&path, &random, &star}) {
+    std::vector<int> expected(g->size()), component(g->size());
+    graph::connected_components(*g, expected);
+    for (size_t num_threads : {size_t(1), size_t(4)}) {
+      graph::auto_connected_components(*g, component, num_threads);
+      REQUIRE(same_components(expected, component));
+    }
+  }
+}
+
+// Directed graphs with different mixes of trivial and non-trivial strongly connected components
+static std::vector<std::vector<std::vector<int>>> make_scc_test_graphs() {
+  std::vector<std::vector<std::vector<int>>> graphs;
+  std::mt19937                               gen(7);
+
+  // Random graphs, from mostly trivial components to a giant component
+  for (int m : {15000, 25000, 60000}) {
+    std::vector<std::vector<int>>      g(20000);
+    std::uniform_int_distribution<int> dist(0, 19999);
+    for (int i = 0; i < m; ++i)
+      g[static_cast<size_t>(dist(gen))].push_back(dist(gen));
+    graphs.push_back(std::move(g));
+  }
+
+  // Cycles of 1 to 12 vertices, with edges from lower to higher numbered cycles, and a self loop
+  std::vector<std::vector<int>>      g;
+  std::vector<int>                   cycle_start;
+  std::uniform_int_distribution<int> cycle_size(1, 12);
+  while (g.size() < 20000) {
+    const int first = static_cast<int>(g.size()), n = cycle_size(gen);
+    cycle_start.push_back(first);
+    g.resize(g.size() + static_cast<size_t>(n));
+    for (int i = 0; i < n; ++i)
+      g[static_cast<size_t>(first + i)].push_back(first + (i + 1) % n);
+  }
+  for (int i = 0; i < 20000; ++i) {
+    std::uniform_int_distribution<int> dist(0, static_cast<int>(g.size()) - 1);
+    int                                u = dist(gen), v = dist(gen);
+    auto cu = std::ranges::upper_bound(cycle_start, u), cv = std::ranges::upper_bound(cycle_start, v);
+    if (cu < cv)
+      g[static_cast<size_t>(u)].push_back(v);
+  }
+  g[5].push_back(5);
+  graphs.push_back(std::move(g));
+  return graphs;
+}
+
+TEST_CASE("tarjan and forward-backward strongly connected components test", "[strong cc][parallel]") {
+  init_console();
+
+  SECTION("routes") {
+    using G  = routes_vol_graph_type;
+    auto&& g = load_ordered_graph<G>(TEST_DATA_ROOT_DIR "cc_directed.csv", name_order_policy::alphabetical);
+
+    std::vector<size_t> component(size(vertices(g)));
+    REQUIRE(graph::tarjan_scc(g, component) == 3);
+    REQUIRE(*std::ranges::max_element(component) == 2);
+  }
+
+  SECTION("random graphs") {
+    for (auto& g : make_scc_test_graphs()) {
+      auto g_t = make_transpose(g);
+
+      std::vector<size_t> expected(g.size());
+      graph::kosaraju(g, g_t, expected);
+      const size_t num_components = std::ranges::max(expected) + 1;
+
+      std::vector<int> component(g.size());
+      REQUIRE(graph::tarjan_scc(g, component) == num_components);
+      REQUIRE(same_components(expected, component));
+      for (size_t uid = 0; uid < g.size(); ++uid) // reverse topological order
+        for (int vid : g[uid])
+          REQUIRE(component[uid] >= component[static_cast<size_t>(vid)]);
+
+      for (size_t num_threads : {size_t(1), size_t(2), size_t(8)}) {
+        std::ranges::fill(component, -1);
+        REQUIRE(graph::forward_backward_scc(g, g_t, component, num_threads) == num_components);
+        REQUIRE(same_components(expected, component));
+        REQUIRE(*std::ranges::max_element(component) + 1 == static_cast<int>(num_components));
+      }
+    }
+  }
+
+  SECTION("deep path") {
+    // Deep enough to overflow the call stack of a recursive implementation
+    const size_t                  n = 500000;
+    std::vector<std::vector<int>> g(n);
+    for (size_t uid = 0; uid + 1 < n; ++uid)
+      g[uid].push_back(static_cast<int>(uid + 1));
+    g[n - 1].push_back(0);
+
+    std::vector<int> component(n);
+    REQUIRE(graph::tarjan_scc(g, component) == 1);
+  }
+}
@@ -31,3 +31,40 @@ TEST_CASE("compressed_graph constructor", "[compressed_graph]") {
 
   REQUIRE(vertex_names == std::vector<std::string>{"A", "B", "C", "D"});
 }
+
+TEST_CASE("compressed_graph degree", "[compressed_graph]") {
+  using graph_t = graph::container::compressed_graph<double, std::string>;
+  const graph_t g(ve, vv);
+
+  std::vector<size_t> degrees;
+  for (graph::vertex_id_t<graph_t> uid = 0; uid < graph::num_vertices(g); ++uid) {
+    REQUIRE(graph::degree(g, uid) == size(graph::edges(g, uid)));
+    degrees.push_back(graph::degree(g, uid));
+  }
+
+  REQUIRE(degrees == std::vector<size_t>{2, 1, 1, 0});
+}
+
+TEST_CASE("compressed_graph partitions", "[compressed_graph]") {
+  using graph_t = graph::container::compressed_graph<double, void, void, unsigned, unsigned>;
+
+  // A and B in partition 0, C and D in partition 1
+  const graph_t g(ve, std::identity(), std::vector<unsigned>{0, 2});
+  REQUIRE(graph::num_partitions(g) == 2);
+  REQUIRE(graph::num_vertices(g, 0u) == 2);
+  REQUIRE(graph::num_vertices(g, 1u) == 2);
+  for (unsigned uid = 0; uid < 4; ++uid)
+    REQUIRE(graph::partition_id(g, uid) == (uid < 2 ? 0u : 1u));
+  std::vector<unsigned> ids;
+  auto&&                part1 = graph::vertices(g, 1u);
+  for (auto ui = std::ranges::begin(part1); ui != std::ranges::end(part1); ++ui)
+    ids.push_back(graph::vertex_id(g, ui));
+  REQUIRE(ids == std::vector<unsigned>{2, 3});
+
+  // Without partitions, all vertices are in partition 0, including when the edges are loaded after construction
+  graph_t h;
+  h.load_edges(ve, std::identity());
+  REQUIRE(graph::num_partitions(h) == 1);
+  REQUIRE(graph::num_vertices(h, 0u) == 4);
+  REQUIRE(graph::partition_id(h, 3u) == 0);
+}
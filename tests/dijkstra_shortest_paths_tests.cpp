@@ -732,3 +732,40 @@ TEST_CASE("Dijkstra's General Shortest Distances", "[csv][vofl][shortest][distan
   //dijkstra_shortest_distances(g, frankfurt_id, distance, std::less<Distance>(), std::plus<Distance>());
   dijkstra_shortest_distances(g, frankfurt_id, distance, weight, visitor, std::less<Distance>(), std::plus<Distance>());
 }
+
+TEST_CASE("Dijkstra's Unit Weight Shortest Segments", "[csv][vofl][shortest][segments][dijkstra][unit]") {
+  init_console();
+  using G                     = routes_volf_graph_type;
+  auto&&         g            = load_graph<G>(TEST_DATA_ROOT_DIR "germany_routes.csv");
+  vertex_id_t<G> frankfurt_id = find_frankfurt_id(g);
+
+  static_assert(_unit_weight_search<unit_edge_weight<Distance>, Distance, less<Distance>, plus<Distance>>);
+  static_assert(!_unit_weight_search<function<Distance(edge_reference_t<G>)>, Distance, less<Distance>, plus<Distance>>);
+
+  // The default weight function uses a breadth-first search; the type-erased function uses the heap
+  Distances    distance(size(vertices(g)));
+  Predecessors predecessors(size(vertices(g)));
+  init_shortest_paths(distance, predecessors);
+  dijkstra_shortest_paths(g, frankfurt_id, distance, predecessors);
+
+  Distances                               expected(size(vertices(g)));
+  Predecessors                            expected_predecessors(size(vertices(g)));
+  function<Distance(edge_reference_t<G>)> one = [](edge_reference_t<G>) { return 1.0; };
+  init_shortest_paths(expected, expected_predecessors);
+  dijkstra_shortest_paths(g, frankfurt_id, expected, expected_predecessors, one);
+
+  REQUIRE(expected == distance);
+  for (auto&& [uid, u] : vertexlist(g)) {
+    if (uid != frankfurt_id)
+      REQUIRE(distance[predecessors[uid]] + 1 == distance[uid]);
+  }
+
+  SECTION("multi-source distances") {
+    vector<vertex_id_t<G>> sources = {frankfurt_id, 6};
+    init_shortest_paths(distance);
+    init_shortest_paths(expected);
+    dijkstra_shortest_distances(g, sources, distance);
+    dijkstra_shortest_distances(g, sources, expected, one);
+    REQUIRE(expected == distance);
+  }
+}
@@ -0,0 +1,171 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_template_test_macros.hpp>
+#include "graph/algorithm/graph_coloring.hpp"
+#include "graph/container/compressed_graph.hpp"
+#include "graph/container/dynamic_graph.hpp"
+#include "graph/views/incidence.hpp"
+#include "random_graphs.hpp"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using std::vector;
+
+using graph::coloring_order;
+
+// Checks that neighbors have different colors, and that the colors are numbered from 0 to num_colors - 1
+template <class G>
+static void check_coloring(G&& g, const vector<int>& colors, size_t num_colors) {
+  for (size_t uid = 0; uid < graph::num_vertices(g); ++uid)
+    for (auto&& [vid, uv] : graph::views::incidence(g, static_cast<graph::vertex_id_t<G>>(uid)))
+      if (static_cast<size_t>(vid) != uid)
+        REQUIRE(colors[uid] != colors[static_cast<size_t>(vid)]);
+  if (colors.empty())
+    REQUIRE(num_colors == 0);
+  else
+    REQUIRE(static_cast<size_t>(std::ranges::max(colors)) + 1 == num_colors);
+  REQUIRE(std::ranges::none_of(colors, [](int c) { return c < 0; }));
+}
+
+TEST_CASE("greedy coloring", "[coloring][algorithm]") {
+  SECTION("cycle and complete graph") {
+    vector<vector<int>> cycle(10);
+    for (int u = 0; u < 10; ++u) {
+      cycle[static_cast<size_t>(u)].push_back((u + 1) % 10);
+      cycle[static_cast<size_t>((u + 1) % 10)].push_back(u);
+    }
+    vector<vector<int>> complete(6);
+    for (int u = 0; u < 6; ++u)
+      for (int v = 0; v < 6; ++v)
+        if (u != v)
+          complete[static_cast<size_t>(u)].push_back(v);
+
+    for (auto order : {coloring_order::natural, coloring_order::largest_first, coloring_order::smallest_last}) {
+      vector<int> colors(10);
+      REQUIRE(graph::greedy_coloring(cycle, colors, order).num_colors == 2);
+      check_coloring(cycle, colors, 2);
+      colors.resize(6);
+      REQUIRE(graph::greedy_coloring(complete, colors, order).num_colors == 6);
+      check_coloring(complete, colors, 6);
+    }
+  }
+
+  SECTION("smallest last colors a tree with 2 colors") {
+    // A random tree, with edges from each vertex to a random lower id
+    std::mt19937        gen(5);
+    vector<vector<int>> tree(2000);
+    for (int u = 1; u < 2000; ++u) {
+      const int v = std::uniform_int_distribution<int>(0, u - 1)(gen);
+      tree[static_cast<size_t>(u)].push_back(v);
+      tree[static_cast<size_t>(v)].push_back(u);
+    }
+    vector<int> colors(tree.size());
+    REQUIRE(graph::greedy_coloring(tree, colors, coloring_order::smallest_last).num_colors == 2);
+    check_coloring(tree, colors, 2);
+  }
+
+  SECTION("random graph") {
+    auto        g = make_random_graph(5000, 20000, true);
+    vector<int> colors(g.size()), coreness(g.size());
+    const auto  degeneracy = graph::k_core(g, coreness);
+    for (auto order : {coloring_order::natural, coloring_order::largest_first, coloring_order::smallest_last}) {
+      auto stats = graph::greedy_coloring(g, colors, order);
+      check_coloring(g, colors, stats.num_colors);
+      REQUIRE(stats.rounds == 1);
+      REQUIRE(stats.conflicts == 0);
+      REQUIRE(stats.seconds >= 0);
+      if (order == coloring_order::smallest_last)
+        REQUIRE(stats.num_colors <= degeneracy + 1);
+    }
+  }
+}
+
+TEST_CASE("parallel coloring", "[coloring][algorithm]") {
+  SECTION("random graph") {
+    auto        g = make_random_graph(20000, 80000, true, 9);
+    vector<int> expected(g.size());
+    auto        expected_stats = graph::jones_plassmann_coloring(g, expected, 3, 1);
+    check_coloring(g, expected, expected_stats.num_colors);
+    REQUIRE(expected_stats.rounds > 1);
+
+    for (size_t num_threads : {size_t(2), size_t(4)}) {
+      vector<int> colors(g.size());
+      auto        stats = graph::jones_plassmann_coloring(g, colors, 3, num_threads);
+      REQUIRE(colors == expected);
+      REQUIRE(stats.num_colors == expected_stats.num_colors);
+      REQUIRE(stats.rounds == expected_stats.rounds);
+    }
+
+    for (size_t num_threads : {size_t(1), size_t(2), size_t(4)}) {
+      vector<int> colors(g.size());
+      auto        stats = graph::speculative_coloring(g, colors, num_threads);
+      check_coloring(g, colors, stats.num_colors);
+      REQUIRE(stats.rounds >= 1);
+      if (num_threads == 1) {
+        // One thread colors the vertices in order, like greedy_coloring
+        vector<int> natural(g.size());
+        graph::greedy_coloring(g, natural, coloring_order::natural);
+        REQUIRE(colors == natural);
+        REQUIRE(stats.conflicts == 0);
+        REQUIRE(stats.rounds == 1);
+      }
+    }
+  }
+
+  SECTION("compressed_graph and dynamic_graph") {
+    auto adj = make_random_graph(3000, 15000, true, 4);
+    vector<graph::copyable_edge_t<int, void>>      edge_list;
+    vector<graph::copyable_edge_t<uint32_t, void>> dynamic_edge_list;
+    for (int uid = 0; uid < static_cast<int>(adj.size()); ++uid)
+      for (int vid : adj[static_cast<size_t>(uid)]) {
+        edge_list.push_back({uid, vid});
+        dynamic_edge_list.push_back({static_cast<uint32_t>(uid), static_cast<uint32_t>(vid)});
+      }
+
+    using CG = graph::container::compressed_graph<void, void, void, int, int>;
+    CG cg;
+    cg.load_edges(edge_list, std::identity(), adj.size(), edge_list.size());
+
+    // A forward_list of edges for each vertex, which isn't a sized range
+    using DG_traits = graph::container::vofl_graph_traits<void, void, void, uint32_t>;
+    using DG        = graph::container::dynamic_adjacency_graph<DG_traits>;
+    DG dg;
+    dg.load_edges(dynamic_edge_list, std::identity(), adj.size());
+
+    vector<int> colors(adj.size()), dynamic_colors(adj.size());
+    auto        stats = graph::greedy_coloring(cg, colors, coloring_order::smallest_last);
+    check_coloring(cg, colors, stats.num_colors);
+    auto dynamic_stats = graph::greedy_coloring(dg, dynamic_colors, coloring_order::smallest_last);
+    check_coloring(dg, dynamic_colors, dynamic_stats.num_colors);
+
+    stats = graph::jones_plassmann_coloring(cg, colors, 0, 2);
+    check_coloring(cg, colors, stats.num_colors);
+    dynamic_stats = graph::jones_plassmann_coloring(dg, dynamic_colors, 0, 2);
+    REQUIRE(dynamic_colors == colors);
+
+    stats = graph::speculative_coloring(cg, colors, 2);
+    check_coloring(cg, colors, stats.num_colors);
+    stats = graph::speculative_coloring(dg, dynamic_colors, 2);
+    check_coloring(dg, dynamic_colors, stats.num_colors);
+  }
+
+  SECTION("empty graph, self loops and small ranges") {
+    vector<vector<int>> empty;
+    vector<int>         colors;
+    REQUIRE(graph::greedy_coloring(empty, colors).num_colors == 0);
+    REQUIRE(graph::jones_plassmann_coloring(empty, colors).num_colors == 0);
+    REQUIRE(graph::speculative_coloring(empty, colors).num_colors == 0);
+
+    vector<vector<int>> loops = {{0, 1}, {0, 1}, {}};
+    colors.resize(3);
+    REQUIRE(graph::greedy_coloring(loops, colors).num_colors == 2);
+    REQUIRE(colors[2] == 0);
+    REQUIRE(graph::jones_plassmann_coloring(loops, colors).num_colors == 2);
+    REQUIRE(graph::speculative_coloring(loops, colors).num_colors == 2);
+
+    vector<int> small(2);
+    REQUIRE_THROWS_AS(graph::greedy_coloring(loops, small), std::out_of_range);
+    REQUIRE_THROWS_AS(graph::jones_plassmann_coloring(loops, small), std::out_of_range);
+    REQUIRE_THROWS_AS(graph::speculative_coloring(loops, small), std::out_of_range);
+  }
+}
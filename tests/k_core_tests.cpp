@@ -0,0 +1,106 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_template_test_macros.hpp>
+#include "graph/algorithm/k_core.hpp"
+#include "graph/container/compressed_graph.hpp"
+#include "random_graphs.hpp"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using std::vector;
+
+// Random undirected graph with each edge stored in both directions, with a dense group of vertices so the
+// core numbers vary
+static vector<vector<int>> make_random_undirected(int n, int m, unsigned seed = 42) {
+  vector<vector<int>> g(static_cast<size_t>(n));
+  std::mt19937        gen(seed);
+  add_random_edges(g, 0, n, m, true, gen);
+  add_random_edges(g, 0, std::min(n, 40), 300, true, gen);
+  return g;
+}
+
+// Core numbers from the definition: the k-core is what's left after repeatedly removing vertices of degree < k
+static vector<int> reference_coreness(const vector<vector<int>>& g) {
+  const size_t n = g.size();
+  vector<int>  core(n, 0);
+  for (int k = 1;; ++k) {
+    vector<char> removed(n, false);
+    bool         changed = true;
+    while (changed) {
+      changed = false;
+      for (size_t u = 0; u < n; ++u) {
+        if (removed[u])
+          continue;
+        int deg = 0;
+        for (int v : g[u])
+          deg += !removed[static_cast<size_t>(v)];
+        if (deg < k) {
+          removed[u] = true;
+          changed    = true;
+        }
+      }
+    }
+    if (std::ranges::count(removed, false) == 0)
+      return core;
+    for (size_t u = 0; u < n; ++u)
+      if (!removed[u])
+        core[u] = k;
+  }
+}
+
+TEST_CASE("k-core decomposition", "[k_core][algorithm]") {
+  SECTION("small graph") {
+    // A 4-clique {0,1,2,3}, a triangle {3,4,5} sharing vertex 3, a pendant 6 and an isolated vertex 7
+    vector<vector<int>> g = {{1, 2, 3}, {0, 2, 3}, {0, 1, 3}, {0, 1, 2, 4, 5}, {3, 5}, {3, 4, 6}, {5}, {}};
+    vector<int>         expected = {3, 3, 3, 3, 2, 2, 1, 0};
+    vector<int>         core(g.size());
+    REQUIRE(graph::k_core(g, core) == 3);
+    REQUIRE(core == expected);
+    std::ranges::fill(core, -1);
+    REQUIRE(graph::parallel_k_core(g, core, 4) == 3);
+    REQUIRE(core == expected);
+  }
+
+  SECTION("random graph") {
+    auto        g        = make_random_undirected(3000, 6000);
+    auto        expected = reference_coreness(g);
+    vector<int> core(g.size());
+    REQUIRE(graph::k_core(g, core) == static_cast<size_t>(std::ranges::max(expected)));
+    REQUIRE(core == expected);
+    for (size_t num_threads : {size_t(1), size_t(2), size_t(4)}) {
+      vector<int> parallel_core(g.size(), -1);
+      REQUIRE(graph::parallel_k_core(g, parallel_core, num_threads) == static_cast<size_t>(std::ranges::max(expected)));
+      REQUIRE(parallel_core == expected);
+    }
+  }
+
+  SECTION("compressed_graph") {
+    using G  = graph::container::compressed_graph<void, void, void, int, int>;
+    auto adj = make_random_undirected(5000, 20000, 9);
+    vector<graph::copyable_edge_t<int, void>> edge_list;
+    for (int uid = 0; uid < static_cast<int>(adj.size()); ++uid)
+      for (int vid : adj[static_cast<size_t>(uid)])
+        edge_list.push_back({uid, vid});
+    G g;
+    g.load_edges(edge_list, std::identity(), adj.size(), edge_list.size());
+
+    vector<int> expected(adj.size()), core(adj.size()), parallel_core(adj.size());
+    graph::k_core(adj, expected);
+    graph::k_core(g, core);
+    graph::parallel_k_core(g, parallel_core, 3);
+    REQUIRE(core == expected);
+    REQUIRE(parallel_core == expected);
+  }
+
+  SECTION("empty graph and small ranges") {
+    vector<vector<int>> g;
+    vector<int>         core;
+    REQUIRE(graph::k_core(g, core) == 0);
+    REQUIRE(graph::parallel_k_core(g, core) == 0);
+
+    vector<vector<int>> h = {{1}, {0}};
+    vector<int>         small(1);
+    REQUIRE_THROWS_AS(graph::k_core(h, small), std::out_of_range);
+    REQUIRE_THROWS_AS(graph::parallel_k_core(h, small), std::out_of_range);
+  }
+}
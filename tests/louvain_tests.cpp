@@ -0,0 +1,178 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+#include "graph/algorithm/louvain.hpp"
+#include "graph/container/compressed_graph.hpp"
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+
+using std::vector;
+using Catch::Approx;
+
+using weighted_graph = vector<vector<std::pair<int, double>>>;
+
+static void add_edge(weighted_graph& g, int u, int v, double w = 1.0) {
+  g[static_cast<size_t>(u)].push_back({v, w});
+  if (u != v)
+    g[static_cast<size_t>(v)].push_back({u, w});
+}
+
+// Random undirected graph of groups of group_size vertices, with an edge probability of p_in inside a group and
+// p_out between groups
+static weighted_graph make_planted_partition(int groups, int group_size, double p_in, double p_out, unsigned seed) {
+  const int                              n = groups * group_size;
+  weighted_graph                         g(static_cast<size_t>(n));
+  std::mt19937                           gen(seed);
+  std::uniform_real_distribution<double> coin(0.0, 1.0);
+  for (int u = 0; u < n; ++u)
+    for (int v = u + 1; v < n; ++v)
+      if (coin(gen) < (u / group_size == v / group_size ? p_in : p_out))
+        add_edge(g, u, v);
+  return g;
+}
+
+// Modularity from the definition, over all pairs of vertices
+static double reference_modularity(const weighted_graph& g, const vector<int>& community, double resolution = 1.0) {
+  const size_t   n = g.size();
+  vector<double> k(n, 0.0);
+  double         two_m = 0, inside = 0;
+  for (size_t u = 0; u < n; ++u)
+    for (auto&& [v, w] : g[u]) {
+      k[u] += w;
+      two_m += w;
+      if (community[u] == community[static_cast<size_t>(v)])
+        inside += w;
+    }
+  double expected = 0;
+  for (size_t u = 0; u < n; ++u)
+    for (size_t v = 0; v < n; ++v)
+      if (community[u] == community[v])
+        expected += k[u] * k[v];
+  return inside / two_m - resolution * expected / (two_m * two_m);
+}
+
+static auto weight = [](const std::pair<int, double>& uv) { return uv.second; };
+
+TEST_CASE("louvain community detection", "[louvain][algorithm]") {
+  SECTION("ring of cliques") {
+    // 8 cliques of 6 vertices, with one edge between neighboring cliques in a ring
+    constexpr int  cliques = 8, clique_size = 6;
+    weighted_graph g(cliques * clique_size);
+    for (int c = 0; c < cliques; ++c) {
+      for (int u = 0; u < clique_size; ++u)
+        for (int v = u + 1; v < clique_size; ++v)
+          add_edge(g, c * clique_size + u, c * clique_size + v);
+      add_edge(g, c * clique_size, ((c + 1) % cliques) * clique_size + 1);
+    }
+
+    for (size_t num_threads : {size_t(1), size_t(4)}) {
+      vector<int>                  community(g.size(), -1);
+      vector<graph::louvain_level> levels;
+      const double                 q = graph::louvain(g, community, levels, weight, 1.0, 1e-6, num_threads);
+      std::set<int>                labels;
+      for (size_t uid = 0; uid < g.size(); ++uid) {
+        REQUIRE(community[uid] == community[uid - uid % clique_size]);
+        labels.insert(community[uid]);
+      }
+      REQUIRE(labels == std::set<int>{0, 1, 2, 3, 4, 5, 6, 7});
+      REQUIRE(q == Approx(reference_modularity(g, community)));
+      REQUIRE(!levels.empty());
+      REQUIRE(levels.front().num_vertices == g.size());
+      REQUIRE(levels.front().num_edges == 2 * (cliques * clique_size * (clique_size - 1) / 2 + cliques));
+      REQUIRE(levels.back().modularity == q);
+      REQUIRE(levels.back().coarsen_seconds == 0);
+      for (size_t i = 1; i < levels.size(); ++i)
+        REQUIRE(levels[i].num_vertices == levels[i - 1].num_communities);
+    }
+  }
+
+  SECTION("planted partition") {
+    auto        g = make_planted_partition(40, 100, 0.1, 0.001, 42);
+    vector<int> planted(g.size());
+    for (size_t uid = 0; uid < g.size(); ++uid)
+      planted[uid] = static_cast<int>(uid / 100);
+    for (size_t num_threads : {size_t(1), size_t(2), size_t(4)}) {
+      vector<int>  community(g.size(), -1);
+      const double q = graph::louvain(g, community, weight, 1.0, 1e-6, num_threads);
+      REQUIRE(q == Approx(reference_modularity(g, community)));
+      REQUIRE(q >= reference_modularity(g, planted) - 0.01);
+      REQUIRE(std::ranges::min(community) == 0);
+    }
+  }
+
+  SECTION("unit weights and resolution") {
+    auto        g = make_planted_partition(10, 30, 0.4, 0.02, 7);
+    vector<int> community(g.size()), fine(g.size());
+    const double q = graph::louvain(g, community);
+    REQUIRE(q == Approx(reference_modularity(g, community)));
+
+    // A higher resolution doesn't give fewer communities here
+    const double q_fine = graph::louvain(g, fine, graph::unit_edge_weight<double>(), 4.0);
+    REQUIRE(q_fine == Approx(reference_modularity(g, fine, 4.0)));
+    REQUIRE(std::ranges::max(fine) >= std::ranges::max(community));
+  }
+
+  SECTION("weighted edges") {
+    // Two triangles joined by a heavy edge between 2 and 3, with light edges inside the triangles
+    weighted_graph g(6);
+    add_edge(g, 0, 1, 0.1), add_edge(g, 1, 2, 0.1), add_edge(g, 0, 2, 0.1);
+    add_edge(g, 3, 4, 0.1), add_edge(g, 4, 5, 0.1), add_edge(g, 3, 5, 0.1);
+    add_edge(g, 2, 3, 10.0);
+    vector<int> community(g.size());
+    graph::louvain(g, community, weight, 1.0, 1e-9, 1);
+    REQUIRE(community[2] == community[3]);
+
+    weighted_graph h(2);
+    add_edge(h, 0, 1, -1.0);
+    REQUIRE_THROWS_AS(graph::louvain(h, community, weight), std::out_of_range);
+  }
+
+  SECTION("compressed_graph") {
+    using G  = graph::container::compressed_graph<void, void, void, int, int>;
+    auto adj = make_planted_partition(16, 40, 0.25, 0.005, 3);
+    vector<graph::copyable_edge_t<int, void>> edge_list;
+    for (int uid = 0; uid < static_cast<int>(adj.size()); ++uid)
+      for (auto&& [vid, w] : adj[static_cast<size_t>(uid)])
+        edge_list.push_back({uid, vid});
+    G g;
+    g.load_edges(edge_list, std::identity(), adj.size(), edge_list.size());
+
+    vector<int>  community(adj.size());
+    const double q = graph::louvain(g, community, graph::unit_edge_weight<double>(), 1.0, 1e-6, 2);
+    vector<int> planted(adj.size());
+    for (size_t uid = 0; uid < adj.size(); ++uid)
+      planted[uid] = static_cast<int>(uid / 40);
+    REQUIRE(q == Approx(reference_modularity(adj, community)));
+    REQUIRE(q >= reference_modularity(adj, planted) - 0.01);
+  }
+
+  SECTION("self loops and isolated vertices") {
+    weighted_graph g(5);
+    add_edge(g, 0, 0, 2.0), add_edge(g, 0, 1), add_edge(g, 2, 3);
+    vector<int>  community(g.size());
+    const double q = graph::louvain(g, community, weight);
+    REQUIRE(q == Approx(reference_modularity(g, community)));
+    REQUIRE(community[0] == community[1]);
+    REQUIRE(community[2] == community[3]);
+    REQUIRE(community[0] != community[2]);
+  }
+
+  SECTION("empty graph, no edges and small ranges") {
+    vector<vector<int>> empty;
+    vector<int>         community;
+    REQUIRE(graph::louvain(empty, community) == 0);
+
+    vector<vector<int>>          no_edges(3);
+    vector<graph::louvain_level> levels;
+    community.resize(3);
+    REQUIRE(graph::louvain(no_edges, community, levels) == 0);
+    REQUIRE(community == vector<int>{0, 1, 2});
+    REQUIRE(levels.size() == 1);
+
+    vector<vector<int>> h = {{1}, {0}};
+    vector<int>         small(1);
+    REQUIRE_THROWS_AS(graph::louvain(h, small), std::out_of_range);
+  }
+}
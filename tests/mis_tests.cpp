@@ -5,6 +5,11 @@
 #include "graph/algorithm/mis.hpp"
 #include "graph/container/dynamic_graph.hpp"
 #include "graph/views/incidence.hpp"
+#include "graph/views/vertexlist.hpp"
+#include "random_graphs.hpp"
+#include <random>
+#include <set>
+#include <algorithm>
 #ifdef _MSC_VER
 #  include "Windows.h"
 #endif
@@ -84,3 +89,69 @@ TEST_CASE("Maximal Independent Set Algorithm", "[mis]") {
   }
 }
 #endif
+
+// No two vertices in the set are adjacent, and every other vertex has a neighbor in the set
+static bool is_maximal_independent_set(const std::vector<std::vector<int>>& g, const std::vector<int>& mis) {
+  std::vector<bool> in_set(g.size(), false);
+  for (int uid : mis)
+    in_set[static_cast<size_t>(uid)] = true;
+  for (size_t uid = 0; uid < g.size(); ++uid) {
+    bool covered = in_set[uid];
+    for (int vid : g[uid]) {
+      if (static_cast<size_t>(vid) == uid)
+        continue;
+      if (in_set[uid] && in_set[static_cast<size_t>(vid)])
+        return false;
+      covered = covered || in_set[static_cast<size_t>(vid)];
+    }
+    if (!covered)
+      return false;
+  }
+  return true;
+}
+
+TEST_CASE("Parallel Maximal Independent Set Algorithm", "[mis][parallel]") {
+  SECTION("routes") {
+    init_console();
+    using G  = routes_vol_graph_type;
+    auto&& g = load_ordered_graph<G>(TEST_DATA_ROOT_DIR "germany_routes.csv", name_order_policy::source_order_found);
+
+    // The routes are directed, so store each one in both directions
+    std::vector<std::vector<int>> ug(size(vertices(g)));
+    for (auto&& [uid, u] : graph::views::vertexlist(g))
+      for (auto&& [vid, uv] : graph::views::incidence(g, uid)) {
+        ug[uid].push_back(static_cast<int>(vid));
+        ug[vid].push_back(static_cast<int>(uid));
+      }
+
+    std::vector<int> mis;
+    graph::parallel_maximal_independent_set(ug, std::back_inserter(mis), 7, 2);
+    REQUIRE(is_maximal_independent_set(ug, mis));
+  }
+  SECTION("empty graph") {
+    std::vector<std::vector<int>> g;
+    std::vector<int>              mis;
+    graph::parallel_maximal_independent_set(g, std::back_inserter(mis));
+    REQUIRE(mis.empty());
+  }
+  SECTION("random graphs") {
+    for (unsigned seed = 1; seed <= 3; ++seed) {
+      auto             g = make_random_graph(5000, 20000, true, seed);
+      std::vector<int> expected;
+      graph::parallel_maximal_independent_set(g, std::back_inserter(expected), seed, 1);
+      REQUIRE(is_maximal_independent_set(g, expected));
+      REQUIRE(std::ranges::is_sorted(expected));
+
+      // The set depends on the seed but not on the number of threads
+      for (size_t num_threads : {size_t(2), size_t(4)}) {
+        std::vector<int> mis;
+        graph::parallel_maximal_independent_set(g, std::back_inserter(mis), seed, num_threads);
+        REQUIRE(mis == expected);
+      }
+      std::vector<int> other;
+      graph::parallel_maximal_independent_set(g, std::back_inserter(other), seed + 100, 4);
+      REQUIRE(is_maximal_independent_set(g, other));
+      REQUIRE(other != expected);
+    }
+  }
+}
@@ -5,6 +5,10 @@
 #include "graph/algorithm/mst.hpp"
 #include "graph/container/dynamic_graph.hpp"
 #include "graph/container/utility_edgelist.hpp"
+#include "graph/container/compressed_graph.hpp"
+#include <random>
+#include <numeric>
+#include <atomic>
 #ifdef _MSC_VER
 #  include "Windows.h"
 #endif
@@ -168,3 +172,203 @@ TEST_CASE("Prim Max ST Algorithm", "[prim max st]") {
   }
   REQUIRE(treeweight == 1779);
 }
+
+// Random undirected weighted graph as a compressed_graph, with each edge stored in both directions. The
+// weights are small integers so there are many ties.
+static graph::container::compressed_graph<double, void, void, int, int>
+make_random_weighted_graph(int n, int m, unsigned seed = 42) {
+  using edge_type = graph::copyable_edge_t<int, double>;
+  std::vector<edge_type>             edge_list;
+  std::mt19937                       gen(seed);
+  std::uniform_int_distribution<int> vdist(0, n - 1);
+  std::uniform_int_distribution<int> wdist(1, 20);
+  for (int i = 0; i < m; ++i) {
+    const int    u = vdist(gen), v = vdist(gen);
+    const double w = wdist(gen);
+    edge_list.push_back({u, v, w});
+    edge_list.push_back({v, u, w});
+  }
+  std::ranges::sort(edge_list, [](auto&& a, auto&& b) { return a.source_id < b.source_id; });
+  graph::container::compressed_graph<double, void, void, int, int> g;
+  g.load_edges(edge_list, std::identity(), static_cast<size_t>(n), edge_list.size());
+  return g;
+}
+
+// Weight of the minimum (or maximum) spanning forest and its number of edges, using a sequential Kruskal
+template <class G, class CompareOp = std::less<>>
+static std::pair<double, size_t> kruskal_forest_weight(G&& g, CompareOp compare = CompareOp()) {
+  std::vector<std::tuple<double, int, int>> e;
+  for (auto&& [uid, vid, uv] : graph::views::edgelist(g))
+    e.emplace_back(edge_value(g, uv), uid, vid);
+  std::ranges::sort(e, compare, [](auto&& ed) { return get<0>(ed); });
+  std::vector<int> parent(size(vertices(g)));
+  std::iota(parent.begin(), parent.end(), 0);
+  auto find = [&parent](int x) {
+    while (parent[static_cast<size_t>(x)] != x)
+      x = parent[static_cast<size_t>(x)] = parent[static_cast<size_t>(parent[static_cast<size_t>(x)])];
+    return x;
+  };
+  double total = 0;
+  size_t count = 0;
+  for (auto&& [w, u, v] : e) {
+    const int ru = find(u), rv = find(v);
+    if (ru != rv) {
+      parent[static_cast<size_t>(std::max(ru, rv))] = std::min(ru, rv);
+      total += w;
+      ++count;
+    }
+  }
+  return {total, count};
+}
+
+TEST_CASE("Concurrent union-find", "[union find][parallel]") {
+  const int                          n = 20000;
+  std::vector<std::pair<int, int>>   pairs;
+  std::mt19937                       gen(7);
+  std::uniform_int_distribution<int> dist(0, n - 1);
+  for (int i = 0; i < n / 2; ++i)
+    pairs.emplace_back(dist(gen), dist(gen));
+
+  std::vector<int> expected(n);
+  std::iota(expected.begin(), expected.end(), 0);
+  size_t expected_unions = 0;
+  for (auto&& [u, v] : pairs)
+    expected_unions += graph::concurrent_union_find(expected, u, v);
+
+  std::vector<int> parent(n);
+  std::iota(parent.begin(), parent.end(), 0);
+  std::atomic<size_t> unions = 0;
+  graph::parallel_for(pairs.size(), 4, 64, [&](size_t first, size_t last, size_t) {
+    for (size_t i = first; i < last; ++i)
+      unions += graph::concurrent_union_find(parent, pairs[i].first, pairs[i].second);
+  });
+  REQUIRE(unions == expected_unions);
+  for (int x = 0; x < n; ++x) {
+    // The root of each set is its lowest element either way
+    REQUIRE(graph::concurrent_find(parent, x) == graph::concurrent_find(expected, x));
+    REQUIRE(graph::concurrent_find(parent, x) <= x);
+  }
+  REQUIRE(graph::concurrent_same_set(parent, pairs[0].first, pairs[0].second));
+}
+
+TEST_CASE("Parallel Boruvka Min ST Algorithm", "[boruvka][parallel]") {
+  using edge_type = graph::edge_info<int, true, void, double>;
+
+  SECTION("empty graph") {
+    graph::container::compressed_graph<double, void, void, int, int> g;
+    std::vector<edge_type>                                           t;
+    graph::parallel_boruvka(g, t);
+    REQUIRE(t.empty());
+  }
+  SECTION("random graphs") {
+    for (unsigned seed = 1; seed <= 3; ++seed) {
+      auto g                        = make_random_weighted_graph(3000, 4000, seed); // several components
+      auto [expected, expected_num] = kruskal_forest_weight(g);
+      for (size_t num_threads : {size_t(1), size_t(4)}) {
+        std::vector<edge_type> t;
+        graph::parallel_boruvka(g, t, num_threads);
+        REQUIRE(t.size() == expected_num);
+        double total = 0;
+        for (auto&& [u, v, val] : t)
+          total += val;
+        REQUIRE(total == expected);
+        REQUIRE(kruskal_forest_weight(g).second == t.size());
+      }
+    }
+  }
+  SECTION("maximum spanning tree of the routes") {
+    init_console();
+    using G  = routes_vol_graph_type;
+    auto&& g = load_graph<G>(TEST_DATA_ROOT_DIR "germany_routes.csv");
+
+    // The routes are directed, so store each one in both directions
+    std::vector<edge_type> edge_list;
+    for (auto&& [uid, vid, uv] : graph::views::edgelist(g)) {
+      edge_list.push_back({static_cast<int>(uid), static_cast<int>(vid), edge_value(g, uv)});
+      edge_list.push_back({static_cast<int>(vid), static_cast<int>(uid), edge_value(g, uv)});
+    }
+    std::ranges::sort(edge_list, [](auto&& a, auto&& b) { return a.source_id < b.source_id; });
+    graph::container::compressed_graph<double, void, void, int, int> cg;
+    cg.load_edges(edge_list, std::identity(), size(vertices(g)), edge_list.size());
+
+    std::vector<edge_type> t;
+    graph::parallel_boruvka(
+          cg, t, [&cg](edge_reference_t<decltype(cg)> uv) { return edge_value(cg, uv); }, std::greater<>(), 2);
+    double total = 0;
+    for (auto&& [u, v, val] : t)
+      total += val;
+    REQUIRE(t.size() == size(vertices(g)) - 1);
+    REQUIRE(total == kruskal_forest_weight(cg, std::greater<>()).first);
+  }
+}
+
+TEST_CASE("Filter-Kruskal Min ST Algorithm", "[filter kruskal][parallel]") {
+  using edge_type = graph::edge_info<int, true, void, double>;
+
+  SECTION("parallel sort and partition") {
+    std::vector<int>                   v(100000);
+    std::mt19937                       gen(3);
+    std::uniform_int_distribution<int> dist(0, 1000);
+    std::ranges::generate(v, [&]() { return dist(gen); });
+    auto expected = v;
+    std::ranges::sort(expected);
+    auto sorted = v;
+    graph::parallel_sort(sorted.begin(), sorted.end(), std::less<>(), 3);
+    REQUIRE(sorted == expected);
+
+    auto partitioned = v;
+    auto is_even     = [](int x) { return x % 2 == 0; };
+    auto mid         = graph::parallel_partition(partitioned.begin(), partitioned.end(), is_even, 3);
+    std::ranges::stable_partition(v, is_even);
+    REQUIRE(partitioned == v);
+    REQUIRE(mid - partitioned.begin() == std::ranges::count_if(v, is_even));
+  }
+  SECTION("empty edgelist") {
+    std::vector<edge_type> e, t;
+    graph::filter_kruskal(e, t);
+    REQUIRE(t.empty());
+  }
+  SECTION("random graphs") {
+    for (unsigned seed = 1; seed <= 3; ++seed) {
+      // Many more edges than vertices, so the edges are partitioned and filtered before any are sorted
+      auto g                        = make_random_weighted_graph(2000, 30000, seed);
+      auto [expected, expected_num] = kruskal_forest_weight(g);
+      std::vector<edge_type> e;
+      for (auto&& [uid, vid, uv] : graph::views::edgelist(g))
+        e.push_back({uid, vid, edge_value(g, uv)});
+
+      for (size_t num_threads : {size_t(1), size_t(4)}) {
+        std::vector<edge_type> t;
+        graph::filter_kruskal(e, t, [](auto&& i, auto&& j) { return i < j; }, num_threads);
+        REQUIRE(t.size() == expected_num);
+        double total = 0, last = 0;
+        for (auto&& [u, v, val] : t) {
+          REQUIRE(val >= last);
+          last = val;
+          total += val;
+        }
+        REQUIRE(total == expected);
+      }
+
+      std::vector<edge_type> t;
+      graph::filter_kruskal(e, t, [](auto&& i, auto&& j) { return i > j; }, 2);
+      double total = 0;
+      for (auto&& [u, v, val] : t)
+        total += val;
+      REQUIRE(total == kruskal_forest_weight(g, std::greater<>()).first);
+    }
+  }
+  SECTION("equal weights") {
+    std::vector<edge_type> e, t;
+    for (int uid = 0; uid < 3000; ++uid)
+      for (int k = 1; k <= 5; ++k)
+        e.push_back({uid, (uid * 7 + k * 13) % 3000, 1.0});
+    graph::filter_kruskal(e, t, [](auto&& i, auto&& j) { return i < j; }, 2);
+    std::vector<int> component(3000);
+    std::iota(component.begin(), component.end(), 0);
+    size_t unions = 0;
+    for (auto&& ed : e)
+      unions += graph::concurrent_union_find(component, ed.source_id, ed.target_id);
+    REQUIRE(t.size() == unions);
+  }
+}
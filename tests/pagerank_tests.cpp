@@ -0,0 +1,297 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+#include "csv_routes.hpp"
+#include "graph/graph.hpp"
+#include "graph/container/dynamic_graph.hpp"
+#include "graph/algorithm/pagerank.hpp"
+#include "graph/views/incidence.hpp"
+#include "graph/views/edgelist.hpp"
+#include "random_graphs.hpp"
+#include <random>
+#include <numeric>
+#include <unordered_map>
+#ifdef _MSC_VER
+#  include "Windows.h"
+#endif
+
+using std::cout;
+using std::endl;
+
+using graph::vertex_t;
+using graph::vertex_id_t;
+using graph::vertex_reference_t;
+using graph::vertex_iterator_t;
+using graph::vertex_edge_range_t;
+using graph::edge_t;
+
+using graph::vertices;
+using graph::edges;
+using graph::vertex_value;
+using graph::target_id;
+using graph::target;
+using graph::edge_value;
+using graph::find_vertex;
+using graph::vertex_id;
+
+using routes_volf_graph_traits = graph::container::vofl_graph_traits<double, std::string, std::string>;
+using routes_volf_graph_type   = graph::container::dynamic_adjacency_graph<routes_volf_graph_traits>;
+
+// Random directed graph with n vertices and m edges, where multiples of 5 are dangling vertices with no out-edges
+static std::vector<std::vector<int>> make_random_digraph(int n, int m, unsigned seed = 42) {
+  auto g = make_random_graph(n, m, false, seed);
+  for (size_t uid = 0; uid < g.size(); uid += 5)
+    g[uid].clear();
+  return g;
+}
+
+// Power iteration with a dense transition matrix, with the rank of dangling vertices spread evenly
+static std::vector<double> reference_pagerank(const std::vector<std::vector<double>>& weights, double damping) {
+  const size_t        n = weights.size();
+  std::vector<double> rank(n, 1.0 / static_cast<double>(n)), next(n);
+  for (int iter = 0; iter < 1000; ++iter) {
+    double dangling = 0;
+    for (size_t u = 0; u < n; ++u)
+      if (std::accumulate(weights[u].begin(), weights[u].end(), 0.0) == 0)
+        dangling += rank[u];
+    std::ranges::fill(next, (1 - damping + damping * dangling) / static_cast<double>(n));
+    for (size_t u = 0; u < n; ++u) {
+      const double out = std::accumulate(weights[u].begin(), weights[u].end(), 0.0);
+      for (size_t v = 0; v < n; ++v)
+        if (weights[u][v] != 0)
+          next[v] += damping * rank[u] * weights[u][v] / out;
+    }
+    rank.swap(next);
+  }
+  return rank;
+}
+
+TEST_CASE("PageRank", "[pagerank]") {
+  SECTION("routes") {
+    init_console();
+    using G  = routes_volf_graph_type;
+    auto&& g = load_ordered_graph<G>(TEST_DATA_ROOT_DIR "germany_routes.csv", name_order_policy::source_order_found);
+    auto   g_t = make_transpose(g);
+
+    std::vector<std::vector<double>> weights(size(vertices(g)), std::vector<double>(size(vertices(g)), 0));
+    for (auto&& [uid, vid, uv] : graph::views::edgelist(g))
+      weights[uid][vid] += 1;
+    auto expected = reference_pagerank(weights, 0.85);
+
+    std::vector<double> page_rank(size(vertices(g)));
+    size_t              iterations = graph::pagerank(g, g_t, page_rank, 0.85, 1e-10, 1000);
+    REQUIRE(iterations < 1000);
+    for (auto&& [uid, u] : graph::views::vertexlist(g)) {
+      REQUIRE(page_rank[uid] == Catch::Approx(expected[uid]).epsilon(1e-6));
+    }
+    REQUIRE(std::accumulate(page_rank.begin(), page_rank.end(), 0.0) == Catch::Approx(1.0));
+  }
+
+  SECTION("random graph with dangling vertices") {
+    const int n   = 300;
+    auto      g   = make_random_digraph(n, 1500);
+    auto      g_t = make_transpose(g);
+
+    std::vector<std::vector<double>> weights(n, std::vector<double>(n, 0));
+    for (size_t uid = 0; uid < g.size(); ++uid)
+      for (int vid : g[uid])
+        weights[uid][static_cast<size_t>(vid)] += 1;
+    auto expected = reference_pagerank(weights, 0.85);
+
+    for (size_t num_threads : {size_t(1), size_t(4)}) {
+      std::vector<double> page_rank(n);
+      graph::pagerank(g, g_t, page_rank, 0.85, 1e-12, 1000, graph::pagerank_unit_weight(), num_threads);
+      for (size_t uid = 0; uid < g.size(); ++uid)
+        REQUIRE(page_rank[uid] == Catch::Approx(expected[uid]).epsilon(1e-8));
+    }
+
+    // The error threshold is on the L1 norm of the change, so a loose threshold stops early
+    std::vector<double> page_rank(n);
+    const size_t        loose  = graph::pagerank(g, g_t, page_rank, 0.85, 1e-2);
+    const size_t        strict = graph::pagerank(g, g_t, page_rank, 0.85, 1e-10);
+    REQUIRE(loose < strict);
+    REQUIRE(graph::pagerank(g, g_t, page_rank, 0.85, 1e-10, 3) == 3);
+  }
+
+  SECTION("weighted") {
+    const int n   = 200;
+    auto      g   = make_random_digraph(n, 1000, 7);
+    auto      g_t = make_transpose(g);
+    // The weight of an edge is a function of its vertices, so it's the same in the transpose
+    auto weight_fn = [](int u, int v) { return 1.0 + static_cast<double>((u * 31 + v * 17) % 5); };
+
+    std::vector<std::vector<double>> weights(n, std::vector<double>(n, 0));
+    for (size_t uid = 0; uid < g.size(); ++uid)
+      for (int vid : g[uid])
+        weights[uid][static_cast<size_t>(vid)] += weight_fn(static_cast<int>(uid), vid);
+    auto expected = reference_pagerank(weights, 0.85);
+
+    // Vertex ids aren't part of an edge of vector<vector<int>>, so they're found from the edge addresses
+    auto source_of = [](const std::vector<std::vector<int>>& gr, const int& e) {
+      for (size_t uid = 0; uid < gr.size(); ++uid)
+        if (!gr[uid].empty() && &e >= gr[uid].data() && &e < gr[uid].data() + gr[uid].size())
+          return static_cast<int>(uid);
+      return -1;
+    };
+    auto weighted = [&](const int& e) {
+      const int u = source_of(g, e);
+      return u >= 0 ? weight_fn(u, e) : weight_fn(e, source_of(g_t, e));
+    };
+
+    std::vector<double> page_rank(n);
+    graph::pagerank(g, g_t, page_rank, 0.85, 1e-12, 1000, weighted, 2);
+    for (size_t uid = 0; uid < g.size(); ++uid)
+      REQUIRE(page_rank[uid] == Catch::Approx(expected[uid]).epsilon(1e-8));
+  }
+
+  SECTION("empty graph") {
+    std::vector<std::vector<int>> g, g_t;
+    std::vector<double>           page_rank;
+    REQUIRE(graph::pagerank(g, g_t, page_rank) == 0);
+  }
+}
+
+TEST_CASE("Incremental PageRank", "[pagerank][incremental]") {
+  using update = graph::edge_info<int, true, void, void>;
+  const int n  = 300;
+  auto      g  = make_random_digraph(n, 1500, 11);
+
+  std::vector<double> prior(n);
+  graph::pagerank(g, make_transpose(g), prior, 0.85, 1e-14, 1000);
+
+  SECTION("inserted and deleted edges") {
+    // Delete the first edge of some vertices and all edges of vertex 1, which becomes dangling
+    std::vector<update> inserted, deleted;
+    for (int uid = 2; uid < n; uid += 7) {
+      if (!g[static_cast<size_t>(uid)].empty()) {
+        deleted.push_back({uid, g[static_cast<size_t>(uid)].front()});
+        g[static_cast<size_t>(uid)].erase(g[static_cast<size_t>(uid)].begin());
+      }
+    }
+    for (int vid : g[1])
+      deleted.push_back({1, vid});
+    g[1].clear();
+    // Insert edges from dangling vertices (multiples of 5) and others, including a self loop
+    std::mt19937                       gen(3);
+    std::uniform_int_distribution<int> dist(0, n - 1);
+    for (int i = 0; i < 40; ++i) {
+      const int uid = (i % 2 == 0) ? 5 * (i % 60) : dist(gen);
+      const int vid = (i == 7) ? uid : dist(gen);
+      inserted.push_back({uid, vid});
+      g[static_cast<size_t>(uid)].push_back(vid);
+    }
+
+    std::vector<double> expected(n);
+    graph::pagerank(g, make_transpose(g), expected, 0.85, 1e-14, 1000);
+
+    std::vector<double> scores = prior;
+    const size_t        pushes = graph::incremental_pagerank(g, scores, inserted, deleted, 0.85, 1e-10);
+    REQUIRE(pushes > 0);
+    for (size_t uid = 0; uid < g.size(); ++uid)
+      REQUIRE(scores[uid] == Catch::Approx(expected[uid]).margin(1e-10));
+    REQUIRE(std::accumulate(scores.begin(), scores.end(), 0.0) == Catch::Approx(1.0));
+
+    // A loose threshold does less work
+    std::vector<double> loose = prior;
+    REQUIRE(graph::incremental_pagerank(g, loose, inserted, deleted, 0.85, 1e-4) < pushes);
+  }
+
+  SECTION("no updates") {
+    std::vector<double> scores = prior;
+    std::vector<update> none;
+    REQUIRE(graph::incremental_pagerank(g, scores, none, none) == 0);
+    REQUIRE(scores == prior);
+  }
+
+  SECTION("invalid updates") {
+    std::vector<double> scores = prior;
+    std::vector<update> none, bad = {{0, n}};
+    REQUIRE_THROWS_AS(graph::incremental_pagerank(g, scores, bad, none), std::out_of_range);
+    // Vertex 0 is dangling, so the graph doesn't have an edge inserted from it
+    std::vector<update> missing = {{0, 1}};
+    REQUIRE_THROWS_AS(graph::incremental_pagerank(g, scores, missing, none), std::out_of_range);
+  }
+}
+
+// Power iteration for personalized PageRank, with walks from dangling vertices returning to the seeds
+static std::vector<double>
+reference_personalized_pagerank(const std::vector<std::vector<int>>& g, const std::vector<int>& seeds, double damping) {
+  const size_t        n = g.size();
+  std::vector<double> start(n, 0), rank(n, 0), next(n);
+  for (int sid : seeds)
+    start[static_cast<size_t>(sid)] += 1.0 / static_cast<double>(seeds.size());
+  rank = start;
+  for (int iter = 0; iter < 2000; ++iter) {
+    double dangling = 0;
+    for (size_t u = 0; u < n; ++u)
+      if (g[u].empty())
+        dangling += rank[u];
+    for (size_t v = 0; v < n; ++v)
+      next[v] = (1 - damping + damping * dangling) * start[v];
+    for (size_t u = 0; u < n; ++u)
+      for (int v : g[u])
+        next[static_cast<size_t>(v)] += damping * rank[u] / static_cast<double>(g[u].size());
+    rank.swap(next);
+  }
+  return rank;
+}
+
+TEST_CASE("Personalized PageRank", "[pagerank][ppr]") {
+  using PPR   = std::unordered_map<int, double>;
+  const int n = 200;
+  auto      g = make_random_digraph(n, 1000, 5);
+
+  SECTION("forward push") {
+    for (std::vector<int> seeds : {std::vector<int>{1}, std::vector<int>{0, 7, 7, 42}}) {
+      auto   expected = reference_personalized_pagerank(g, seeds, 0.85);
+      PPR    ppr;
+      size_t pushes = graph::personalized_pagerank(g, seeds, ppr, 0.85, 1e-10);
+      REQUIRE(pushes > 0);
+      for (size_t uid = 0; uid < g.size(); ++uid) {
+        const double rank = ppr.contains(static_cast<int>(uid)) ? ppr[static_cast<int>(uid)] : 0.0;
+        REQUIRE(rank == Catch::Approx(expected[uid]).margin(1e-6));
+        REQUIRE(rank <= expected[uid] + 1e-12); // the ranks are lower bounds
+      }
+    }
+  }
+
+  SECTION("sparse output") {
+    // Two disjoint cycles; only the cycle with the seed is touched
+    std::vector<std::vector<int>> cycles(20);
+    for (int uid = 0; uid < 20; ++uid)
+      cycles[static_cast<size_t>(uid)].push_back(uid < 10 ? (uid + 1) % 10 : 10 + (uid + 1) % 10);
+    PPR ppr;
+    graph::personalized_pagerank(cycles, std::vector<int>{3}, ppr, 0.85, 1e-8);
+    REQUIRE(ppr.size() == 10);
+    for (auto&& [uid, rank] : ppr)
+      REQUIRE(uid < 10);
+    // A loose threshold touches fewer vertices
+    graph::personalized_pagerank(cycles, std::vector<int>{3}, ppr, 0.85, 0.5);
+    REQUIRE(ppr.size() < 10);
+    REQUIRE(ppr[3] == Catch::Approx(0.15));
+  }
+
+  SECTION("batch") {
+    std::vector<std::vector<int>> seed_sets;
+    for (int i = 0; i < 12; ++i)
+      seed_sets.push_back({(i * 37) % n, (i * 11 + 3) % n});
+    for (size_t num_threads : {size_t(1), size_t(4)}) {
+      std::vector<PPR> pprs(seed_sets.size());
+      size_t           total = graph::personalized_pagerank(g, seed_sets, pprs, 0.85, 1e-8, num_threads);
+      size_t           expected_total = 0;
+      for (size_t q = 0; q < seed_sets.size(); ++q) {
+        PPR ppr;
+        expected_total += graph::personalized_pagerank(g, seed_sets[q], ppr, 0.85, 1e-8);
+        REQUIRE(pprs[q] == ppr);
+      }
+      REQUIRE(total == expected_total);
+    }
+  }
+
+  SECTION("invalid seeds") {
+    PPR ppr;
+    REQUIRE(graph::personalized_pagerank(g, std::vector<int>{}, ppr) == 0);
+    REQUIRE(ppr.empty());
+    REQUIRE_THROWS_AS(graph::personalized_pagerank(g, std::vector<int>{n}, ppr), std::out_of_range);
+  }
+}
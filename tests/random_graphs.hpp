@@ -0,0 +1,75 @@
+#pragma once
+
+// Random graphs for the algorithm tests, as a vector of out-edge lists with int vertex ids. The endpoints of each
+// edge are drawn uniformly with a std::mt19937 seeded with seed, so a test always gets the same graph for a seed.
+
+#include "graph/graph.hpp"
+#include "graph/graph_utility.hpp"
+#include "graph/views/edgelist.hpp"
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+// Adds m random edges with both endpoints in [first, last) to g, which may include parallel edges and self loops.
+// An undirected edge is stored in both directions, and an undirected self loop once.
+inline void add_random_edges(std::vector<std::vector<int>>& g, int first, int last, int m, bool undirected,
+                             std::mt19937& gen) {
+  std::uniform_int_distribution<int> dist(first, last - 1);
+  for (int i = 0; i < m; ++i) {
+    const int u = dist(gen), v = dist(gen);
+    g[static_cast<size_t>(u)].push_back(v);
+    if (undirected && u != v)
+      g[static_cast<size_t>(v)].push_back(u);
+  }
+}
+
+// Random graph with n vertices and m edges. When undirected, each edge is stored in both directions.
+inline std::vector<std::vector<int>> make_random_graph(int n, int m, bool undirected, unsigned seed = 42) {
+  std::vector<std::vector<int>> g(static_cast<size_t>(n));
+  std::mt19937                  gen(seed);
+  add_random_edges(g, 0, n, m, undirected, gen);
+  return g;
+}
+
+// Random directed graph with n vertices, m edges and no self loops, with edge weights of 1 to max_weight stored
+// with each target id
+inline std::vector<std::vector<std::pair<int, double>>>
+make_random_weighted_digraph(int n, int m, int max_weight, unsigned seed = 42) {
+  std::vector<std::vector<std::pair<int, double>>> g(static_cast<size_t>(n));
+  std::mt19937                                     gen(seed);
+  std::uniform_int_distribution<int>               dist(0, n - 1), weight_dist(1, max_weight);
+  for (int i = 0; i < m; ++i) {
+    const int u = dist(gen), v = dist(gen);
+    if (u != v)
+      g[static_cast<size_t>(u)].push_back({v, static_cast<double>(weight_dist(gen))});
+  }
+  return g;
+}
+
+// Random DAG: edges go from a lower to a higher rank, with the ranks a random permutation of the vertex ids
+inline std::vector<std::vector<int>> make_random_dag(int n, int m, unsigned seed = 42) {
+  std::mt19937     gen(seed);
+  std::vector<int> rank(static_cast<size_t>(n));
+  std::iota(rank.begin(), rank.end(), 0);
+  std::ranges::shuffle(rank, gen);
+  std::vector<std::vector<int>>      g(static_cast<size_t>(n));
+  std::uniform_int_distribution<int> dist(0, n - 1);
+  for (int i = 0; i < m; ++i) {
+    const int u = dist(gen), v = dist(gen);
+    if (u != v)
+      g[static_cast<size_t>(rank[static_cast<size_t>(std::min(u, v))])].push_back(
+            rank[static_cast<size_t>(std::max(u, v))]);
+  }
+  return g;
+}
+
+// The graph with the direction of every edge of g reversed
+template <class G>
+std::vector<std::vector<int>> make_transpose(const G& g) {
+  std::vector<std::vector<int>> g_t(std::ranges::size(graph::vertices(g)));
+  for (auto&& [uid, vid, uv] : graph::views::edgelist(g))
+    g_t[static_cast<size_t>(vid)].push_back(static_cast<int>(uid));
+  return g_t;
+}
@@ -0,0 +1,184 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_template_test_macros.hpp>
+#include "graph/algorithm/random_walk.hpp"
+#include "graph/container/compressed_graph.hpp"
+#include "graph/views/incidence.hpp"
+#include "random_graphs.hpp"
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+using std::vector;
+
+using weighted_graph = vector<vector<std::pair<int, double>>>;
+
+static auto edge_weight = [](const std::pair<int, double>& uv) { return uv.second; };
+
+// The fraction of the walks from t to v that go on to each vertex, for the 3rd vertex of each walk
+template <class G>
+static vector<double> third_step_fractions(G&& g, const graph::alias_table& table, double p, double q) {
+  constexpr size_t num_walks = 100000;
+  vector<int>      starts(num_walks, 0), walks(num_walks * 3);
+  graph::node2vec_walks(g, table, starts, 3, walks, p, q, 5);
+  vector<double> count(4, 0.0);
+  double         total = 0;
+  for (size_t i = 0; i < num_walks; ++i) {
+    if (walks[3 * i + 1] == 1) {
+      count[static_cast<size_t>(walks[3 * i + 2])] += 1;
+      total += 1;
+    }
+  }
+  for (auto& c : count)
+    c /= total;
+  return count;
+}
+
+TEST_CASE("alias table", "[random_walk][algorithm]") {
+  // Vertex 0 has edges with weights 1, 2, 3 and 4, vertex 1 has an edge of weight 0 and one of weight 5
+  weighted_graph     g = {{{1, 1.0}, {2, 2.0}, {3, 3.0}, {4, 4.0}}, {{0, 0.0}, {2, 5.0}}, {{3, 0.0}}, {}, {}};
+  graph::alias_table table(g, edge_weight);
+  REQUIRE(table.num_vertices() == 5);
+  REQUIRE(table.num_edges() == 7);
+  REQUIRE(table.first(1) == 4);
+  REQUIRE(table.total_weight(0) == 10.0);
+  REQUIRE(table.can_sample(1));
+  REQUIRE_FALSE(table.can_sample(2));
+  REQUIRE_FALSE(table.can_sample(3));
+
+  std::mt19937_64  gen(1);
+  constexpr size_t samples = 200000;
+  vector<double>   count(4, 0.0);
+  for (size_t i = 0; i < samples; ++i)
+    count[table.sample(0, gen)] += 1;
+  for (size_t k = 0; k < 4; ++k)
+    REQUIRE(std::abs(count[k] / samples - static_cast<double>(k + 1) / 10.0) < 0.005);
+  for (size_t i = 0; i < 1000; ++i)
+    REQUIRE(table.sample(1, gen) == 1);
+
+  weighted_graph h = {{{1, -1.0}}, {}};
+  REQUIRE_THROWS_AS(graph::alias_table(h, edge_weight), std::out_of_range);
+}
+
+TEST_CASE("random walks", "[random_walk][algorithm]") {
+  constexpr int max_id = std::numeric_limits<int>::max();
+
+  SECTION("walks follow edges") {
+    auto               g = make_random_graph(5000, 20000, true);
+    graph::alias_table table(g);
+    vector<int>        starts(3000);
+    for (size_t i = 0; i < starts.size(); ++i)
+      starts[i] = static_cast<int>((i * 7) % g.size());
+    constexpr size_t length = 20;
+    for (auto [p, q] : {std::pair{1.0, 1.0}, std::pair{0.5, 2.0}, std::pair{4.0, 0.25}}) {
+      vector<int>  walks(starts.size() * length, -1);
+      const size_t steps = graph::node2vec_walks(g, table, starts, length, walks, p, q, 11, 4);
+      size_t       count = 0;
+      for (size_t i = 0; i < starts.size(); ++i) {
+        REQUIRE(walks[i * length] == starts[i]);
+        for (size_t j = 0; j < length; ++j) {
+          if (walks[i * length + j] == max_id) {
+            REQUIRE(g[static_cast<size_t>(walks[i * length + j - 1])].empty());
+            REQUIRE(walks[i * length + length - 1] == max_id);
+            break;
+          }
+          ++count;
+          if (j > 0) {
+            auto& prev = g[static_cast<size_t>(walks[i * length + j - 1])];
+            REQUIRE(std::ranges::find(prev, walks[i * length + j]) != prev.end());
+          }
+        }
+      }
+      REQUIRE(steps == count);
+    }
+  }
+
+  SECTION("same walks for any number of threads") {
+    auto               g = make_random_graph(4000, 16000, true, 3);
+    graph::alias_table table(g, graph::unit_edge_weight<double>(), 2);
+    vector<int>        starts(2000);
+    for (size_t i = 0; i < starts.size(); ++i)
+      starts[i] = static_cast<int>(i);
+    vector<int> walks1(starts.size() * 10), walks4(starts.size() * 10), other(starts.size() * 10);
+    graph::random_walks(g, table, starts, 10, walks1, 99, 1);
+    graph::random_walks(g, table, starts, 10, walks4, 99, 4);
+    graph::random_walks(g, table, starts, 10, other, 100, 4);
+    REQUIRE(walks1 == walks4);
+    REQUIRE(walks1 != other);
+  }
+
+  SECTION("node2vec bias") {
+    // From 0 to 1, the next vertex is 0 (return), 2 (a neighbor of 0) or 3 (not a neighbor of 0). The edges of
+    // each vertex are in descending order, so the edge from 0 is looked for with a linear search.
+    vector<vector<int>> g = {{2, 1}, {3, 2, 0}, {1, 0}, {1}};
+    graph::alias_table  table(g);
+    REQUIRE_FALSE(table.sorted());
+
+    // p = 0.5 and q = 2 give biases of 2, 1 and 0.5
+    auto fractions = third_step_fractions(g, table, 0.5, 2.0);
+    REQUIRE(std::abs(fractions[0] - 2.0 / 3.5) < 0.01);
+    REQUIRE(std::abs(fractions[2] - 1.0 / 3.5) < 0.01);
+    REQUIRE(std::abs(fractions[3] - 0.5 / 3.5) < 0.01);
+
+    // The same graph as a compressed_graph has sorted edges, for a binary search
+    using G = graph::container::compressed_graph<void, void, void, int, int>;
+    vector<graph::copyable_edge_t<int, void>> edge_list;
+    for (int uid = 0; uid < static_cast<int>(g.size()); ++uid)
+      for (int vid : g[static_cast<size_t>(uid)] | std::views::reverse)
+        edge_list.push_back({uid, vid});
+    G                  cg;
+    cg.load_edges(edge_list, std::identity(), g.size(), edge_list.size());
+    graph::alias_table ctable(cg);
+    REQUIRE(ctable.sorted());
+    REQUIRE(ctable.first(1) == 2);
+
+    // p = 4 and q = 0.25 give biases of 0.25, 1 and 4
+    fractions = third_step_fractions(cg, ctable, 4.0, 0.25);
+    REQUIRE(std::abs(fractions[0] - 0.25 / 5.25) < 0.01);
+    REQUIRE(std::abs(fractions[2] - 1.0 / 5.25) < 0.01);
+    REQUIRE(std::abs(fractions[3] - 4.0 / 5.25) < 0.01);
+  }
+
+  SECTION("weighted walks") {
+    // The walks from 0 go to 1 nine times in ten
+    weighted_graph     g = {{{1, 9.0}, {2, 1.0}}, {{0, 1.0}}, {{0, 1.0}}};
+    graph::alias_table table(g, edge_weight);
+    vector<int>        starts(50000, 0), walks(starts.size() * 2);
+    REQUIRE(graph::random_walks(g, table, starts, 2, walks, 7) == walks.size());
+    double ones = 0;
+    for (size_t i = 0; i < starts.size(); ++i)
+      ones += (walks[2 * i + 1] == 1);
+    REQUIRE(std::abs(ones / static_cast<double>(starts.size()) - 0.9) < 0.01);
+  }
+
+  SECTION("errors") {
+    vector<vector<int>> g = {{1}, {0}};
+    graph::alias_table  table(g);
+    vector<int>         starts = {0, 1}, walks(4);
+    REQUIRE(graph::random_walks(g, table, starts, 0, walks) == 0);
+    REQUIRE_THROWS_AS(graph::random_walks(g, table, starts, 3, walks), std::out_of_range);
+    REQUIRE_THROWS_AS(graph::node2vec_walks(g, table, starts, 2, walks, 0.0, 1.0), std::out_of_range);
+    vector<int> bad_starts = {2};
+    REQUIRE_THROWS_AS(graph::random_walks(g, table, bad_starts, 2, walks), std::out_of_range);
+    vector<vector<int>> h = {{1}, {0}, {}};
+    REQUIRE_THROWS_AS(graph::random_walks(h, table, starts, 2, walks), std::out_of_range);
+  }
+}
+
+TEST_CASE("neighbor sampling", "[random_walk][algorithm]") {
+  weighted_graph     g = {{{1, 1.0}, {2, 3.0}}, {{0, 1.0}}, {{0, 3.0}}, {}};
+  graph::alias_table table(g, edge_weight);
+  vector<int>        seeds = {0, 3, 1};
+  constexpr size_t   fanout = 20000;
+  vector<int>        samples(seeds.size() * fanout);
+  REQUIRE(graph::sample_neighbors(g, table, seeds, fanout, samples, 3) == 2 * fanout);
+
+  const auto twos = std::count(samples.begin(), samples.begin() + fanout, 2);
+  REQUIRE(std::abs(static_cast<double>(twos) / fanout - 0.75) < 0.01);
+  REQUIRE(std::all_of(samples.begin() + fanout, samples.begin() + 2 * fanout,
+                      [](int vid) { return vid == std::numeric_limits<int>::max(); }));
+  REQUIRE(std::all_of(samples.begin() + 2 * fanout, samples.end(), [](int vid) { return vid == 0; }));
+
+  vector<int> small(fanout);
+  REQUIRE_THROWS_AS(graph::sample_neighbors(g, table, seeds, fanout, small), std::out_of_range);
+}
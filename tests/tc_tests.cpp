@@ -5,6 +5,12 @@
 #include "graph/algorithm/tc.hpp"
 #include "graph/container/dynamic_graph.hpp"
 #include "graph/views/incidence.hpp"
+#include "graph/views/edgelist.hpp"
+#include "graph/container/compressed_graph.hpp"
+#include "random_graphs.hpp"
+#include <random>
+#include <set>
+#include <map>
 #ifdef _MSC_VER
 #  include "Windows.h"
 #endif
@@ -24,3 +30,216 @@ TEST_CASE("triangle counting test", "[tc]") {
   size_t triangles = graph::triangle_count(g);
   REQUIRE(triangles == 11);
 }
+
+// Random undirected graph with n vertices and m edges, each stored in both directions, plus a few hubs
+// so some edge lists are much longer than others
+static std::vector<std::vector<int>> make_random_graph_with_hubs(int n, int m, int hubs, unsigned seed = 42) {
+  auto g = make_random_graph(n, m, true, seed);
+  for (int hub = 0; hub < hubs; ++hub)
+    for (int vid = hub + 1; vid < n; vid += 3) {
+      g[static_cast<size_t>(hub)].push_back(vid);
+      g[static_cast<size_t>(vid)].push_back(hub);
+    }
+  return g;
+}
+
+// Triangles in an undirected graph, by checking every pair of neighbors
+static size_t brute_force_triangle_count(const std::vector<std::vector<int>>& g) {
+  std::vector<std::set<int>> adj(g.size());
+  for (size_t uid = 0; uid < g.size(); ++uid)
+    for (int vid : g[uid])
+      if (vid != static_cast<int>(uid)) {
+        adj[uid].insert(vid);
+        adj[static_cast<size_t>(vid)].insert(static_cast<int>(uid));
+      }
+  size_t triangles = 0;
+  for (size_t uid = 0; uid < g.size(); ++uid)
+    for (int vid : adj[uid])
+      for (int wid : adj[static_cast<size_t>(vid)])
+        if (static_cast<int>(uid) < vid && vid < wid && adj[uid].contains(wid))
+          ++triangles;
+  return triangles;
+}
+
+TEST_CASE("parallel triangle counting test", "[tc][parallel]") {
+  init_console();
+
+  SECTION("routes") {
+    using G  = routes_vol_graph_type;
+    auto&& g = load_ordered_graph<G>(TEST_DATA_ROOT_DIR "tc_test.csv", name_order_policy::alphabetical);
+    REQUIRE(graph::parallel_triangle_count(g, 2) == 11);
+  }
+
+  SECTION("random graphs") {
+    for (int hubs : {0, 5}) {
+      auto         g        = make_random_graph_with_hubs(3000, 30000, hubs);
+      const size_t expected = brute_force_triangle_count(g);
+      REQUIRE(expected > 0);
+      for (size_t num_threads : {size_t(1), size_t(2), size_t(8)})
+        REQUIRE(graph::parallel_triangle_count(g, num_threads) == expected);
+
+      // Each edge in one direction only, unordered, with duplicates and self loops
+      std::vector<std::vector<int>> g1(g.size());
+      for (size_t uid = 0; uid < g.size(); ++uid)
+        for (int vid : g[uid])
+          if (static_cast<int>(uid) < vid)
+            g1[(uid + static_cast<size_t>(vid)) % 2 ? uid : static_cast<size_t>(vid)].push_back(
+                  (uid + static_cast<size_t>(vid)) % 2 ? vid : static_cast<int>(uid));
+      g1[7].push_back(7);
+      g1[7].push_back(g1[7].front());
+      std::ranges::shuffle(g1[7], std::mt19937(1));
+      REQUIRE(graph::parallel_triangle_count(g1, 4) == expected);
+    }
+  }
+
+  SECTION("compressed_graph") {
+    auto g = make_random_graph_with_hubs(2000, 40000, 3);
+
+    using edge_type = graph::copyable_edge_t<uint32_t, void>;
+    std::vector<edge_type> edge_list;
+    for (size_t uid = 0; uid < g.size(); ++uid)
+      for (int vid : g[uid])
+        edge_list.push_back(edge_type{static_cast<uint32_t>(uid), static_cast<uint32_t>(vid)});
+    graph::container::compressed_graph<void, void, void, uint32_t, uint32_t> cg;
+    cg.load_edges(edge_list);
+
+    REQUIRE(graph::parallel_triangle_count(cg, 3) == brute_force_triangle_count(g));
+  }
+}
+
+// Brute force truss number of each undirected edge {u,v}, u < v: edges with too little support are removed
+// from the k-truss until none are left to remove, for k = 3, 4, ...
+static std::map<std::pair<int, int>, size_t> brute_force_truss(const std::vector<std::vector<int>>& g) {
+  std::set<std::pair<int, int>> edge_set;
+  for (size_t uid = 0; uid < g.size(); ++uid)
+    for (int vid : g[uid])
+      if (vid != static_cast<int>(uid))
+        edge_set.insert(std::minmax(static_cast<int>(uid), vid));
+
+  std::map<std::pair<int, int>, size_t> truss;
+  for (auto& e : edge_set)
+    truss[e] = 2;
+  for (size_t k = 3; !edge_set.empty(); ++k) {
+    for (bool removed = true; removed;) {
+      removed = false;
+      std::vector<std::set<int>> adj(g.size());
+      for (auto [u, v] : edge_set) {
+        adj[static_cast<size_t>(u)].insert(v);
+        adj[static_cast<size_t>(v)].insert(u);
+      }
+      for (auto it = edge_set.begin(); it != edge_set.end();) {
+        size_t support = 0;
+        for (int w : adj[static_cast<size_t>(it->first)])
+          support += adj[static_cast<size_t>(it->second)].contains(w);
+        if (support < k - 2) {
+          it      = edge_set.erase(it);
+          removed = true;
+        } else {
+          ++it;
+        }
+      }
+    }
+    for (auto& e : edge_set)
+      truss[e] = k;
+  }
+  return truss;
+}
+
+TEST_CASE("triangle support, clustering coefficient and k-truss test", "[tc][truss][parallel]") {
+  init_console();
+
+  SECTION("routes") {
+    using G  = routes_vol_graph_type;
+    auto&& g = load_ordered_graph<G>(TEST_DATA_ROOT_DIR "tc_test.csv", name_order_policy::alphabetical);
+
+    std::vector<int> truss(graph::num_edges(g));
+    REQUIRE(graph::k_truss(g, truss, 2) == 5);
+    std::vector<int> expected;
+    for (auto&& [uid, vid, uv] : graph::views::edgelist(g)) {
+      const std::string& u = graph::vertex_value(g, *graph::find_vertex(g, uid));
+      const std::string& v = graph::vertex_value(g, *graph::find_vertex(g, vid));
+      if (u <= "E" && v <= "E")
+        expected.push_back(5); // K5 of A-E
+      else if ((u == "B" || u == "E") && v == "F")
+        expected.push_back(3);
+      else
+        expected.push_back(2);
+    }
+    REQUIRE(truss == expected);
+  }
+
+  SECTION("random graphs") {
+    for (int hubs : {0, 4}) {
+      auto g = make_random_graph_with_hubs(300, 2500, hubs, 11);
+      g[3].push_back(3); // self loop
+
+      std::vector<std::set<int>> adj(g.size());
+      for (size_t uid = 0; uid < g.size(); ++uid)
+        for (int vid : g[uid])
+          if (vid != static_cast<int>(uid)) {
+            adj[uid].insert(vid);
+            adj[static_cast<size_t>(vid)].insert(static_cast<int>(uid));
+          }
+      auto expected_truss = brute_force_truss(g);
+
+      for (size_t num_threads : {size_t(1), size_t(4)}) {
+        const size_t        E = static_cast<size_t>(graph::num_edges(g));
+        std::vector<size_t> support(E), truss(E);
+        graph::edge_triangle_support(g, support, num_threads);
+        graph::k_truss(g, truss, num_threads);
+        size_t e = 0;
+        for (size_t uid = 0; uid < g.size(); ++uid) {
+          for (int vid : g[uid]) {
+            if (vid == static_cast<int>(uid)) {
+              REQUIRE(support[e] == 0);
+              REQUIRE(truss[e] == 0);
+            } else {
+              size_t expected = 0;
+              for (int wid : adj[uid])
+                expected += adj[static_cast<size_t>(vid)].contains(wid);
+              REQUIRE(support[e] == expected);
+              REQUIRE(truss[e] == expected_truss[std::minmax(static_cast<int>(uid), vid)]);
+            }
+            ++e;
+          }
+        }
+
+        std::vector<size_t> triangles(g.size());
+        std::vector<double> coefficients(g.size());
+        graph::vertex_triangle_count(g, triangles, num_threads);
+        graph::local_clustering_coefficient(g, coefficients, num_threads);
+        for (size_t uid = 0; uid < g.size(); ++uid) {
+          size_t expected = 0;
+          for (int vid : adj[uid])
+            for (int wid : adj[uid])
+              expected += (vid < wid && adj[static_cast<size_t>(vid)].contains(wid));
+          REQUIRE(triangles[uid] == expected);
+          const double d = static_cast<double>(adj[uid].size());
+          REQUIRE(coefficients[uid] == (d < 2 ? 0.0 : 2.0 * static_cast<double>(expected) / (d * (d - 1))));
+        }
+      }
+    }
+  }
+
+  SECTION("compressed_graph edge index") {
+    auto g = make_random_graph_with_hubs(500, 4000, 2, 5);
+
+    using edge_type = graph::copyable_edge_t<uint32_t, void>;
+    std::vector<edge_type> edge_list;
+    for (size_t uid = 0; uid < g.size(); ++uid) {
+      std::ranges::sort(g[uid]);
+      for (int vid : g[uid])
+        edge_list.push_back(edge_type{static_cast<uint32_t>(uid), static_cast<uint32_t>(vid)});
+    }
+    graph::container::compressed_graph<void, void, void, uint32_t, uint32_t> cg;
+    cg.load_edges(edge_list);
+
+    std::vector<uint32_t> expected(edge_list.size()), support(edge_list.size());
+    graph::edge_triangle_support(g, expected, 2);
+    graph::edge_triangle_support(cg, support, 2);
+    REQUIRE(expected == support);
+
+    std::vector<uint32_t> too_small(edge_list.size() - 1);
+    REQUIRE_THROWS_AS(graph::k_truss(cg, too_small, 2), std::out_of_range);
+  }
+}
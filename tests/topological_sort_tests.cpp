@@ -1,48 +1,98 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_template_test_macros.hpp>
 #include "graph/algorithm/topological_sort.hpp"
-#include "graph/container/dynamic_graph.hpp"
-#include <iostream>
+#include "graph/container/compressed_graph.hpp"
+#include "graph/views/incidence.hpp"
+#include "random_graphs.hpp"
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
 
-#define TEST_OPTION_OUTPUT (1)
-#define TEST_OPTION_GEN (2)
-#define TEST_OPTION_TEST (3)
-#define TEST_OPTION TEST_OPTION_TEST
+using std::vector;
 
-using std::cout;
-using std::endl;
+using graph::vertices;
+using graph::edges;
+using graph::target_id;
 
-using std::ranges::forward_range;
-using std::forward_iterator;
-
-void init_console(); // init cout for UTF-8
-
-using namespace graph;
+// Checks that order is a topological order of g, grouped by level, and that levels are the longest path lengths
+template <class G>
+static void check_topological_order(const G& g, const vector<int>& order, const vector<int>& levels) {
+  const size_t n = size(vertices(g));
+  vector<int>  position(n, -1);
+  for (size_t i = 0; i < n; ++i) {
+    REQUIRE(position[static_cast<size_t>(order[i])] == -1);
+    position[static_cast<size_t>(order[i])] = static_cast<int>(i);
+  }
+  vector<int> longest(n, 0);
+  for (int uid : order) {
+    const size_t u = static_cast<size_t>(uid);
+    for (auto&& [vid, uv] : graph::views::incidence(g, uid)) {
+      const size_t v = static_cast<size_t>(vid);
+      REQUIRE(position[u] < position[v]);
+      longest[v] = std::max(longest[v], longest[u] + 1);
+    }
+  }
+  for (size_t i = 1; i < n; ++i)
+    REQUIRE(levels[static_cast<size_t>(order[i - 1])] <= levels[static_cast<size_t>(order[i])]);
+  REQUIRE(levels == longest);
+}
 
-void init_console(); // init cout for UTF-8
+TEST_CASE("topological_sort algorithm test", "[topo_sort][algorithm]") {
+  SECTION("small DAG") {
+    //  0 -> 1 -> 3
+    //  0 -> 2 -> 3 -> 4,  5
+    vector<vector<int>> g = {{1, 2}, {3}, {3}, {4}, {}, {}};
+    vector<int>         order(g.size()), levels(g.size());
+    REQUIRE(graph::topological_sort(g, order, levels));
+    REQUIRE(levels == vector<int>{0, 1, 1, 2, 3, 0});
+    check_topological_order(g, order, levels);
+  }
 
-TEST_CASE("topological_sort algorithm test", "[topo_sort][single-source][algorithm]") {
-  init_console();
+  SECTION("random DAG") {
+    auto g = make_random_dag(20000, 80000);
+    for (size_t num_threads : {size_t(1), size_t(2), size_t(4)}) {
+      vector<int> order(g.size()), levels(g.size());
+      REQUIRE(graph::topological_sort(g, order, levels, num_threads));
+      check_topological_order(g, order, levels);
+    }
+    vector<int> order(g.size());
+    REQUIRE(graph::topological_sort(g, order));
+  }
 
-  // Create graph instance
+  SECTION("compressed_graph") {
+    using G  = graph::container::compressed_graph<void, void, void, int, int>;
+    auto dag = make_random_dag(3000, 12000, 7);
+    vector<graph::copyable_edge_t<int, void>> edge_list;
+    for (int uid = 0; uid < static_cast<int>(dag.size()); ++uid)
+      for (int vid : dag[static_cast<size_t>(uid)])
+        edge_list.push_back({uid, vid});
+    G g;
+    g.load_edges(edge_list, std::identity(), dag.size(), edge_list.size());
 
-  SECTION("verify graph") {
-    // verify graph
-    REQUIRE(1 + 1 == 2);
+    vector<int> order(dag.size()), levels(dag.size());
+    REQUIRE(graph::topological_sort(g, order, levels, 3));
+    check_topological_order(g, order, levels);
   }
 
-#if TEST_OPTION == TEST_OPTION_OUTPUT
-  SECTION("topo sort algo output") {
-    // output graph
-    cout << "graph" << endl;
-  }
-#elif TEST_OPTION == TEST_OPTION_GEN
-  SECTION("topo sort algo test generation") {
-    // generate test code
+  SECTION("cycle") {
+    // 0 -> 1 -> 2 -> 3 -> 1 is a cycle; 4 is reached from it, and 5 -> 0 is before it
+    vector<vector<int>> g = {{1}, {2}, {3, 4}, {1}, {}, {0}};
+    for (size_t num_threads : {size_t(1), size_t(4)}) {
+      vector<int> order(g.size(), -1), levels(g.size(), -1);
+      REQUIRE_FALSE(graph::topological_sort(g, order, levels, num_threads));
+      REQUIRE(order == vector<int>{5, 0, -1, -1, -1, -1});
+      REQUIRE(levels == vector<int>{1, -1, -1, -1, -1, 0});
+    }
   }
-#elif TEST_OPTION == TEST_OPTION_TEST
-  SECTION("topo sort algo test") {
-    // production test code
+
+  SECTION("empty graph and small ranges") {
+    vector<vector<int>> g;
+    vector<int>         order;
+    REQUIRE(graph::topological_sort(g, order));
+
+    vector<vector<int>> h = {{1}, {}};
+    vector<int>         short_order(1), levels(2);
+    REQUIRE_THROWS_AS(graph::topological_sort(h, short_order, levels), std::out_of_range);
   }
-#endif // TEST_OPTION
-} // TEST_CASE"topological_sort algorithm test"
+}
@@ -3,12 +3,17 @@
 #include "csv_routes.hpp"
 #include "graph/graph.hpp"
 #include "graph/algorithm/transitive_closure.hpp"
+#include "graph/algorithm/reachability_index.hpp"
 #include "graph/views/vertexlist.hpp"
 #include "graph/views/incidence.hpp"
 #include "graph/views/neighbors.hpp"
 //#include "graph/view/edgelist_view.hpp"
 #include "graph/container/dynamic_graph.hpp"
+#include "random_graphs.hpp"
 #include <cassert>
+#include <random>
+#include <algorithm>
+#include <sstream>
 #ifdef _MSC_VER
 #  include "Windows.h"
 #endif
@@ -60,3 +65,152 @@ TEST_CASE("Warshall's Algorithm", "[csv][vofl][transitive_closure][warshall]") {
   std::vector<graph::reaches<G>> reaches;
   graph::warshall_transitive_closure(g, std::back_inserter(reaches));
 }
+
+// Random directed graph with n vertices and m edges, plus a few cycles so there are non-trivial
+// strongly connected components
+static std::vector<std::vector<int>> make_random_digraph(int n, int m, unsigned seed = 42) {
+  auto g = make_random_graph(n, m, false, seed);
+  for (int uid = 0; uid + 4 < n; uid += 7) {
+    g[static_cast<size_t>(uid)].push_back(uid + 2);
+    g[static_cast<size_t>(uid + 2)].push_back(uid + 4);
+    g[static_cast<size_t>(uid + 4)].push_back(uid);
+  }
+  return g;
+}
+
+// Vertices reachable from each vertex with a path of at least one edge, by a search from each vertex
+static std::vector<std::vector<bool>> brute_force_closure(const std::vector<std::vector<int>>& g) {
+  const size_t                   n = g.size();
+  std::vector<std::vector<bool>> reach(n, std::vector<bool>(n, false));
+  for (size_t uid = 0; uid < n; ++uid) {
+    std::vector<int> stack(g[uid].begin(), g[uid].end());
+    while (!stack.empty()) {
+      const size_t vid = static_cast<size_t>(stack.back());
+      stack.pop_back();
+      if (reach[uid][vid])
+        continue;
+      reach[uid][vid] = true;
+      for (int wid : g[vid])
+        stack.push_back(wid);
+    }
+  }
+  return reach;
+}
+
+TEST_CASE("Warshall's Algorithm matches a search from each vertex", "[transitive_closure][warshall]") {
+  using G = std::vector<std::vector<int>>;
+  G    g        = make_random_digraph(40, 50);
+  auto expected = brute_force_closure(g);
+
+  std::vector<graph::reaches<G>> reaches;
+  graph::warshall_transitive_closure(g, std::back_inserter(reaches));
+
+  size_t count = 0;
+  for (auto&& row : expected)
+    count += static_cast<size_t>(std::ranges::count(row, true));
+  REQUIRE(reaches.size() == count);
+  for (auto&& [from, to] : reaches)
+    REQUIRE(expected[static_cast<size_t>(from)][static_cast<size_t>(to)]);
+}
+
+TEST_CASE("transitive_closure", "[transitive_closure]") {
+  using G = std::vector<std::vector<int>>;
+
+  auto check = [](const G& g, size_t num_threads) {
+    auto              expected = brute_force_closure(g);
+    graph::bit_matrix closure  = graph::transitive_closure(g, num_threads);
+    REQUIRE(closure.rows() == g.size());
+    REQUIRE(closure.cols() == g.size());
+    size_t count = 0;
+    for (size_t uid = 0; uid < g.size(); ++uid)
+      for (size_t vid = 0; vid < g.size(); ++vid) {
+        REQUIRE(closure.test(uid, vid) == expected[uid][vid]);
+        count += expected[uid][vid];
+      }
+    REQUIRE(closure.count() == count);
+  };
+
+  SECTION("empty graph") {
+    G g;
+    REQUIRE(graph::transitive_closure(g).rows() == 0);
+  }
+  SECTION("path, cycle and self loop") {
+    G g{{1}, {2}, {3}, {1}, {4}, {}};
+    check(g, 2);
+    graph::bit_matrix closure = graph::transitive_closure(g, 1);
+    REQUIRE(!closure.test(0, 0)); // no cycle through 0
+    REQUIRE(closure.test(1, 1));  // cycle 1 -> 2 -> 3 -> 1
+    REQUIRE(closure.test(4, 4));  // self loop
+    REQUIRE(!closure.test(5, 5));
+  }
+  SECTION("random graphs") {
+    for (unsigned seed = 1; seed <= 4; ++seed) {
+      for (size_t num_threads : {size_t(1), size_t(3)}) {
+        check(make_random_digraph(150, 180, seed), num_threads); // sparse: many components
+        check(make_random_digraph(150, 400, seed), num_threads); // dense: a giant component
+      }
+    }
+  }
+  SECTION("condensed closure") {
+    G                 g        = make_random_digraph(200, 260, 7);
+    auto              expected = brute_force_closure(g);
+    std::vector<int>  component(g.size());
+    graph::bit_matrix condensed = graph::condensed_transitive_closure(g, component, 2);
+    REQUIRE(condensed.rows() == static_cast<size_t>(*std::ranges::max_element(component)) + 1);
+    for (size_t uid = 0; uid < g.size(); ++uid)
+      for (size_t vid = 0; vid < g.size(); ++vid)
+        REQUIRE(condensed.test(static_cast<size_t>(component[uid]), static_cast<size_t>(component[vid])) ==
+                expected[uid][vid]);
+  }
+}
+
+TEST_CASE("reachability_index", "[transitive_closure][reachability_index]") {
+  using G = std::vector<std::vector<int>>;
+
+  auto check = [](const G& g, const graph::reachability_index<int>& index) {
+    auto expected = brute_force_closure(g);
+    REQUIRE(index.num_vertices() == g.size());
+    for (size_t uid = 0; uid < g.size(); ++uid)
+      for (size_t vid = 0; vid < g.size(); ++vid)
+        REQUIRE(index.reaches(static_cast<int>(uid), static_cast<int>(vid)) == (uid == vid || expected[uid][vid]));
+  };
+
+  SECTION("empty graph") {
+    G                         g;
+    graph::reachability_index index(g);
+    REQUIRE(index.num_vertices() == 0);
+    REQUIRE(index.num_components() == 0);
+  }
+  SECTION("path, cycle and isolated vertex") {
+    G                         g{{1}, {2}, {3}, {1}, {4}, {}};
+    graph::reachability_index index(g, 2, 1);
+    REQUIRE(index.num_components() == 4); // {0}, {1, 2, 3}, {4} and {5}
+    REQUIRE(index.component(1) == index.component(3));
+    check(g, index);
+  }
+  SECTION("random graphs") {
+    for (unsigned seed = 1; seed <= 4; ++seed) {
+      for (size_t num_labels : {size_t(1), size_t(3)}) {
+        G g1 = make_random_digraph(200, 220, seed); // sparse: many components
+        check(g1, graph::reachability_index<int>(g1, num_labels, 2, seed));
+        G g2 = make_random_digraph(200, 500, seed); // dense: a giant component
+        check(g2, graph::reachability_index<int>(g2, num_labels, 3, seed));
+      }
+    }
+  }
+  SECTION("save and load") {
+    G                         g = make_random_digraph(150, 200, 5);
+    graph::reachability_index index(g);
+    std::stringstream         ss;
+    index.save(ss);
+    auto loaded = graph::reachability_index<int>::load(ss);
+    REQUIRE(loaded == index);
+    check(g, loaded);
+
+    std::string       data = ss.str();
+    std::stringstream truncated(data.substr(0, data.size() / 2));
+    REQUIRE_THROWS_AS(graph::reachability_index<int>::load(truncated), std::runtime_error);
+    std::stringstream wrong_id_size(data);
+    REQUIRE_THROWS_AS(graph::reachability_index<int64_t>::load(wrong_id_size), std::runtime_error);
+  }
+}